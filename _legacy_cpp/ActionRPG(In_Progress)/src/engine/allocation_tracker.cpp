@@ -0,0 +1,265 @@
+#include "allocation_tracker.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include "logger.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define ALLOCATION_CALL_SITE() _ReturnAddress()
+#else
+#define ALLOCATION_CALL_SITE() __builtin_return_address(0)
+#endif
+
+AllocationTracker& AllocationTracker::get() {
+    // Constant-initialized, so it is usable from allocations made during static initialization
+    static AllocationTracker tracker;
+    return tracker;
+}
+
+const char* AllocationTracker::getTagName(AllocationTag tag) {
+    switch (tag) {
+        case AllocationTag::OTHER:
+            return "other";
+        case AllocationTag::LEVEL:
+            return "level";
+        case AllocationTag::AI:
+            return "ai";
+        case AllocationTag::RENDER:
+            return "render";
+        case AllocationTag::UI:
+            return "ui";
+        case AllocationTag::LOOT:
+            return "loot";
+        default:
+            return "?";
+    }
+}
+
+bool AllocationTracker::endFrame() {
+    for (int i = 0; i < TAG_COUNT; i++) {
+        lastFrame[i].allocations = frameAllocations[i].exchange(0, std::memory_order_relaxed);
+        lastFrame[i].bytes = frameBytes[i].exchange(0, std::memory_order_relaxed);
+    }
+    frameNumber++;
+    if (frameNumber <= BUDGET_WARMUP_FRAMES) {
+        return true;
+    }
+
+    bool withinBudget = true;
+    for (int i = 0; i < TAG_COUNT; i++) {
+        if (lastFrame[i].allocations > budgets[i].allocations || lastFrame[i].bytes > budgets[i].bytes) {
+            std::cerr << "Allocation budget exceeded for " << getTagName(static_cast<AllocationTag>(i))
+                      << " in frame " << frameNumber << ": " << lastFrame[i].allocations << " allocations, "
+                      << lastFrame[i].bytes << " bytes" << std::endl;
+            withinBudget = false;
+        }
+    }
+
+    if (!withinBudget && strict) {
+        printReport(std::cerr);
+        std::abort();
+    }
+    return withinBudget;
+}
+
+size_t AllocationTracker::getTopCallSites(CallSite* out, size_t maxSites) const {
+    size_t count = 0;
+    for (const CallSiteSlot& slot : callSites) {
+        const void* address = slot.address.load(std::memory_order_acquire);
+        if (!address) {
+            continue;
+        }
+
+        CallSite site;
+        site.address = address;
+        site.tag = static_cast<AllocationTag>(slot.tag.load(std::memory_order_relaxed));
+        site.allocations = slot.allocations.load(std::memory_order_relaxed);
+        site.bytes = slot.bytes.load(std::memory_order_relaxed);
+
+        // Insertion into the short sorted list, busiest first
+        size_t position = std::min(count, maxSites);
+        while (position > 0 && out[position - 1].allocations < site.allocations) {
+            if (position < maxSites) {
+                out[position] = out[position - 1];
+            }
+            position--;
+        }
+        if (position < maxSites) {
+            out[position] = site;
+            count = std::min(count + 1, maxSites);
+        }
+    }
+    return count;
+}
+
+void AllocationTracker::setBudget(AllocationTag tag, size_t allocationsPerFrame, size_t bytesPerFrame) {
+    budgets[static_cast<int>(tag)].allocations = allocationsPerFrame;
+    budgets[static_cast<int>(tag)].bytes = bytesPerFrame;
+}
+
+void AllocationTracker::logReport() const {
+    if (!ENABLED) {
+        LOG_INFO(ENGINE, "Allocation tracking is off; configure with -DTRACK_ALLOCATIONS=ON");
+        return;
+    }
+
+    LOG_INFO(ENGINE, "Allocations in frame {}:", frameNumber);
+    for (int i = 0; i < TAG_COUNT; i++) {
+        LOG_INFO(ENGINE, "  {}: {} allocations, {} bytes", getTagName(static_cast<AllocationTag>(i)),
+                 lastFrame[i].allocations, lastFrame[i].bytes);
+    }
+    LOG_INFO(ENGINE, "Live: {} bytes, peak {} bytes", getLiveBytes(), getPeakLiveBytes());
+
+    CallSite top[REPORTED_CALL_SITES];
+    size_t count = getTopCallSites(top, REPORTED_CALL_SITES);
+    LOG_INFO(ENGINE, "Top call sites:");
+    for (size_t i = 0; i < count; i++) {
+        LOG_INFO(ENGINE, "  {} [{}] {} allocations, {} bytes", top[i].address, getTagName(top[i].tag),
+                 top[i].allocations, top[i].bytes);
+    }
+    size_t untracked = untrackedCallSites.load(std::memory_order_relaxed);
+    if (untracked > 0) {
+        LOG_INFO(ENGINE, "  ({} allocations from sites that did not fit the table)", untracked);
+    }
+}
+
+void AllocationTracker::printReport(std::ostream& out) const {
+    if (!ENABLED) {
+        out << "Allocation tracking is off; configure with -DTRACK_ALLOCATIONS=ON" << std::endl;
+        return;
+    }
+
+    out << "Allocations in frame " << frameNumber << ":" << std::endl;
+    for (int i = 0; i < TAG_COUNT; i++) {
+        out << "  " << getTagName(static_cast<AllocationTag>(i)) << ": " << lastFrame[i].allocations
+            << " allocations, " << lastFrame[i].bytes << " bytes" << std::endl;
+    }
+    out << "Live: " << getLiveBytes() << " bytes, peak " << getPeakLiveBytes() << " bytes" << std::endl;
+
+    // Addresses are return addresses in the caller of operator new; resolve them with addr2line or the debugger
+    CallSite top[REPORTED_CALL_SITES];
+    size_t count = getTopCallSites(top, REPORTED_CALL_SITES);
+    out << "Top call sites:" << std::endl;
+    for (size_t i = 0; i < count; i++) {
+        out << "  " << top[i].address << " [" << getTagName(top[i].tag) << "] " << top[i].allocations
+            << " allocations, " << top[i].bytes << " bytes" << std::endl;
+    }
+    size_t untracked = untrackedCallSites.load(std::memory_order_relaxed);
+    if (untracked > 0) {
+        out << "  (" << untracked << " allocations from sites that did not fit the table)" << std::endl;
+    }
+}
+
+void AllocationTracker::recordAllocation(size_t bytes, const void* callSite) {
+    int tag = static_cast<int>(currentTag);
+    frameAllocations[tag].fetch_add(1, std::memory_order_relaxed);
+    frameBytes[tag].fetch_add(bytes, std::memory_order_relaxed);
+
+    size_t live = liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    size_t peak = peakLiveBytes.load(std::memory_order_relaxed);
+    while (live > peak && !peakLiveBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+
+    // Linear probing from the address hash; the first thread to see a site claims the slot
+    size_t index = ((reinterpret_cast<uintptr_t>(callSite) >> 2) * 2654435761u) & (CALL_SITE_CAPACITY - 1);
+    for (size_t probe = 0; probe < CALL_SITE_CAPACITY; probe++) {
+        CallSiteSlot& slot = callSites[(index + probe) & (CALL_SITE_CAPACITY - 1)];
+        const void* address = slot.address.load(std::memory_order_acquire);
+        if (!address && slot.address.compare_exchange_strong(address, callSite, std::memory_order_acq_rel)) {
+            slot.tag.store(static_cast<uint8_t>(tag), std::memory_order_relaxed);
+            address = callSite;
+        }
+        if (address == callSite) {
+            slot.allocations.fetch_add(1, std::memory_order_relaxed);
+            slot.bytes.fetch_add(bytes, std::memory_order_relaxed);
+            return;
+        }
+    }
+    untrackedCallSites.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AllocationTracker::recordDeallocation(size_t bytes) {
+    liveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+#ifdef TRACK_ALLOCATIONS
+namespace {
+    // Each block is prefixed with its size so delete knows how much went live
+    constexpr size_t HEADER_SIZE = alignof(std::max_align_t);
+
+    void* trackedAllocate(size_t bytes, const void* callSite) {
+        void* block = std::malloc(bytes + HEADER_SIZE);
+        if (!block) {
+            return nullptr;
+        }
+        *static_cast<size_t*>(block) = bytes;
+        AllocationTracker::get().recordAllocation(bytes, callSite);
+        return static_cast<char*>(block) + HEADER_SIZE;
+    }
+
+    void trackedFree(void* memory) {
+        if (!memory) {
+            return;
+        }
+        void* block = static_cast<char*>(memory) - HEADER_SIZE;
+        AllocationTracker::get().recordDeallocation(*static_cast<size_t*>(block));
+        std::free(block);
+    }
+
+    void* trackedNew(size_t bytes, const void* callSite) {
+        for (;;) {
+            if (void* memory = trackedAllocate(bytes, callSite)) {
+                return memory;
+            }
+            std::new_handler handler = std::get_new_handler();
+            if (!handler) {
+                throw std::bad_alloc();
+            }
+            handler();
+        }
+    }
+}
+
+// Over-aligned new/delete keep the standard library's versions, which do not come through here
+void* operator new(size_t bytes) {
+    return trackedNew(bytes, ALLOCATION_CALL_SITE());
+}
+
+void* operator new[](size_t bytes) {
+    return trackedNew(bytes, ALLOCATION_CALL_SITE());
+}
+
+void* operator new(size_t bytes, const std::nothrow_t&) noexcept {
+    return trackedAllocate(bytes, ALLOCATION_CALL_SITE());
+}
+
+void* operator new[](size_t bytes, const std::nothrow_t&) noexcept {
+    return trackedAllocate(bytes, ALLOCATION_CALL_SITE());
+}
+
+void operator delete(void* memory) noexcept {
+    trackedFree(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    trackedFree(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    trackedFree(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept {
+    trackedFree(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept {
+    trackedFree(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept {
+    trackedFree(memory);
+}
+#endif
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+// Subsystems allocations are charged to
+enum class AllocationTag : uint8_t {
+    OTHER,
+    LEVEL,
+    AI,
+    RENDER,
+    UI,
+    LOOT,
+    COUNT
+};
+
+// Opt-in allocation accounting. Configuring with -DTRACK_ALLOCATIONS=ON
+// replaces the global operator new/delete. The replacements charge every
+// allocation to the innermost AllocationScope on the allocating thread, and
+// also keep live and peak bytes and tally call sites. Without the option the
+// hooks are not compiled, scopes do nothing and every count stays zero.
+//
+// Budgets cap a tag's allocations per frame. In strict mode (the allocation
+// test) the first frame over budget after warm-up prints the report and aborts.
+class AllocationTracker {
+public:
+#ifdef TRACK_ALLOCATIONS
+    static constexpr bool ENABLED = true;
+#else
+    static constexpr bool ENABLED = false;
+#endif
+
+    struct TagStats {
+        size_t allocations = 0;
+        size_t bytes = 0;
+    };
+
+    struct CallSite {
+        const void* address = nullptr; // Return address in the code that called operator new
+        AllocationTag tag = AllocationTag::OTHER;
+        size_t allocations = 0;
+        size_t bytes = 0;
+    };
+
+    constexpr AllocationTracker() {}
+
+    static AllocationTracker& get();
+    static const char* getTagName(AllocationTag tag);
+
+    // Call once per frame; closes the frame's counts and checks them against
+    // the budgets. Returns false if a budget was exceeded.
+    bool endFrame();
+
+    // Counts of the last completed frame
+    const TagStats& getFrameStats(AllocationTag tag) const { return lastFrame[static_cast<int>(tag)]; }
+    size_t getLiveBytes() const { return liveBytes.load(std::memory_order_relaxed); }
+    size_t getPeakLiveBytes() const { return peakLiveBytes.load(std::memory_order_relaxed); }
+    // Writes the call sites with the most allocations so far, busiest first; returns how many
+    size_t getTopCallSites(CallSite* out, size_t maxSites) const;
+
+    void setBudget(AllocationTag tag, size_t allocationsPerFrame, size_t bytesPerFrame);
+    void setStrict(bool enabled) { strict = enabled; }
+
+    // The same report through the logger, for the periodic report during play. printReport
+    // writes synchronously, for the budget failure that aborts right after.
+    void logReport() const;
+    void printReport(std::ostream& out) const;
+
+    // Used by the operator new/delete replacements
+    void recordAllocation(size_t bytes, const void* callSite);
+    void recordDeallocation(size_t bytes);
+
+    // Innermost scope on this thread
+    static AllocationTag getCurrentTag() { return currentTag; }
+    static void setCurrentTag(AllocationTag tag) { currentTag = tag; }
+
+    // Constants
+    static constexpr int TAG_COUNT = static_cast<int>(AllocationTag::COUNT);
+    static constexpr size_t CALL_SITE_CAPACITY = 4096; // Power of two
+    static constexpr size_t REPORTED_CALL_SITES = 10;
+    static constexpr int BUDGET_WARMUP_FRAMES = 120;   // Caches and the frame arena settle first
+
+private:
+    struct Budget {
+        size_t allocations = SIZE_MAX;
+        size_t bytes = SIZE_MAX;
+    };
+
+    // Open-addressed, filled in lock-free from any thread; never allocates
+    struct CallSiteSlot {
+        std::atomic<const void*> address{nullptr};
+        std::atomic<uint8_t> tag{0};
+        std::atomic<size_t> allocations{0};
+        std::atomic<size_t> bytes{0};
+    };
+
+    static inline thread_local AllocationTag currentTag = AllocationTag::OTHER;
+
+    std::atomic<size_t> frameAllocations[TAG_COUNT] = {};
+    std::atomic<size_t> frameBytes[TAG_COUNT] = {};
+    TagStats lastFrame[TAG_COUNT] = {};
+    std::atomic<size_t> liveBytes{0};
+    std::atomic<size_t> peakLiveBytes{0};
+    CallSiteSlot callSites[CALL_SITE_CAPACITY];
+    std::atomic<size_t> untrackedCallSites{0}; // Allocations from sites that found the table full
+
+    Budget budgets[TAG_COUNT] = {};
+    bool strict = false;
+    int frameNumber = 0;
+};
+
+// Charges allocations on this thread to a tag until it goes out of scope
+class AllocationScope {
+public:
+    explicit AllocationScope(AllocationTag tag) {
+        if (AllocationTracker::ENABLED) {
+            previous = AllocationTracker::getCurrentTag();
+            AllocationTracker::setCurrentTag(tag);
+        }
+    }
+
+    ~AllocationScope() {
+        if (AllocationTracker::ENABLED) {
+            AllocationTracker::setCurrentTag(previous);
+        }
+    }
+
+    AllocationScope(const AllocationScope&) = delete;
+    AllocationScope& operator=(const AllocationScope&) = delete;
+
+private:
+    AllocationTag previous = AllocationTag::OTHER;
+};
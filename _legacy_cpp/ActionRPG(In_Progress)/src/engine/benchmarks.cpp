@@ -0,0 +1,398 @@
+#include "benchmarks.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+#include "logger.h"
+#include "../game/flow_field.h"
+#include "../game/level.h"
+#include "../game/path_service.h"
+#include "../game/random.h"
+#include "../game/timer_wheel.h"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double millisecondsSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // Generation and gameplay logging would drown out the results
+    void quietLogging() {
+        Logger::get().setLevel(LogLevel::WARN);
+    }
+
+    struct PathPair {
+        int startX, startY;
+        int goalX, goalY;
+    };
+
+    // Start anywhere walkable, goal in the same region; goals are never reused, so the
+    // path cache (keyed by start region and goal) can't answer any request
+    std::vector<PathPair> makePathPairs(const Level& level, int count, unsigned int seed) {
+        Random rng(seed);
+        std::vector<bool> usedGoal(static_cast<size_t>(level.getWidth()) * level.getHeight(), false);
+        std::vector<PathPair> pairs;
+        for (int attempt = 0; attempt < count * 10 && static_cast<int>(pairs.size()) < count; attempt++) {
+            PathPair pair;
+            if (!level.sampleWalkable(rng, -1, pair.startX, pair.startY) ||
+                !level.sampleWalkable(rng, level.getRegionId(pair.startX, pair.startY), pair.goalX, pair.goalY)) {
+                break;
+            }
+            size_t goal = static_cast<size_t>(pair.goalY) * level.getWidth() + pair.goalX;
+            if (usedGoal[goal]) {
+                continue;
+            }
+            usedGoal[goal] = true;
+            pairs.push_back(pair);
+        }
+        return pairs;
+    }
+
+    // Octile length of a path, as both searches measure it
+    float getPathCost(const std::vector<PathPoint>& path) {
+        float cost = 0.0f;
+        for (size_t i = 1; i < path.size(); i++) {
+            bool diagonal = path[i].x != path[i - 1].x && path[i].y != path[i - 1].y;
+            cost += diagonal ? 1.41421356f : 1.0f;
+        }
+        return cost;
+    }
+
+    constexpr float FRAME_SECONDS = 1.0f / 60.0f;
+
+    // What an enemy re-arms its two timers with each time they run out
+    struct TimerDelays {
+        float wake;
+        float alert;
+    };
+
+    std::vector<TimerDelays> makeTimerDelays(int count, float minSeconds, float maxSeconds, unsigned int seed) {
+        Random rng(seed);
+        std::vector<TimerDelays> delays(count);
+        for (TimerDelays& delay : delays) {
+            delay.wake = minSeconds + rng.nextFloat() * (maxSeconds - minSeconds);
+            delay.alert = minSeconds + rng.nextFloat() * (maxSeconds - minSeconds);
+        }
+        return delays;
+    }
+
+    struct TimerRun {
+        double milliseconds = 0.0;
+        uint64_t fired = 0;
+        int misses = 0; // Timers the wheel fired more than a frame away from their deadline
+    };
+
+    // Every enemy counts both timers down every frame, whether or not anything is due
+    TimerRun pollTimers(const std::vector<TimerDelays>& delays) {
+        std::vector<TimerDelays> remaining = delays;
+        TimerRun run;
+        auto start = Clock::now();
+        for (int frame = 0; frame < Benchmarks::TIMER_FRAMES; frame++) {
+            for (size_t i = 0; i < remaining.size(); i++) {
+                remaining[i].wake -= FRAME_SECONDS;
+                if (remaining[i].wake <= 0.0f) {
+                    remaining[i].wake = delays[i].wake;
+                    run.fired++;
+                }
+                remaining[i].alert -= FRAME_SECONDS;
+                if (remaining[i].alert <= 0.0f) {
+                    remaining[i].alert = delays[i].alert;
+                    run.fired++;
+                }
+            }
+        }
+        run.milliseconds = millisecondsSince(start);
+        return run;
+    }
+
+    // The wheel only touches timers that come due, and re-arms them from the callback like Level does
+    TimerRun advanceWheel(const std::vector<TimerDelays>& delays) {
+        TimerWheel<uint32_t> wheel(Level::TIMER_TICK_SECONDS);
+        std::vector<double> deadlines(delays.size() * 2);
+        for (uint32_t i = 0; i < delays.size(); i++) {
+            wheel.schedule(delays[i].wake, i, 0);
+            wheel.schedule(delays[i].alert, i, 1);
+            deadlines[i * 2] = delays[i].wake;
+            deadlines[i * 2 + 1] = delays[i].alert;
+        }
+
+        // Ticks run inside advance after the clock has moved, so allow a frame either way
+        const double tolerance = FRAME_SECONDS + Level::TIMER_TICK_SECONDS;
+        TimerRun run;
+        auto onFire = [&](uint32_t enemy, uint8_t kind) {
+            run.fired++;
+            double now = wheel.getTime();
+            double& deadline = deadlines[enemy * 2 + kind];
+            if (std::abs(now - deadline) > tolerance) {
+                run.misses++;
+            }
+            float delay = kind == 0 ? delays[enemy].wake : delays[enemy].alert;
+            wheel.schedule(delay, enemy, kind);
+            deadline = now + delay;
+        };
+
+        auto start = Clock::now();
+        for (int frame = 0; frame < Benchmarks::TIMER_FRAMES; frame++) {
+            wheel.advance(FRAME_SECONDS, onFire);
+        }
+        run.milliseconds = millisecondsSince(start);
+        return run;
+    }
+
+    struct TilePoint {
+        int x, y;
+    };
+
+    // A random walk of one step every FLOW_MOVE_FRAMES frames, so both chase runs follow the same player
+    std::vector<TilePoint> makePlayerTrail(const Level& level, TilePoint start, unsigned int seed) {
+        Random rng(seed);
+        std::vector<TilePoint> trail;
+        TilePoint player = start;
+        for (int frame = 0; frame < Benchmarks::FLOW_FRAMES; frame++) {
+            if (frame % Benchmarks::FLOW_MOVE_FRAMES == 0) {
+                for (int attempt = 0; attempt < 8; attempt++) {
+                    int x = player.x + rng.nextInt(-1, 1);
+                    int y = player.y + rng.nextInt(-1, 1);
+                    if (level.isWalkable(x, y)) {
+                        player = {x, y};
+                        break;
+                    }
+                }
+            }
+            trail.push_back(player);
+        }
+        return trail;
+    }
+
+    // Chasers start anywhere in the player's region within chase range
+    std::vector<TilePoint> makeChasers(const Level& level, TilePoint player, unsigned int seed) {
+        Random rng(seed);
+        int region = level.getRegionId(player.x, player.y);
+        std::vector<TilePoint> chasers;
+        for (int attempt = 0; attempt < Benchmarks::FLOW_CHASERS * 100 &&
+                              static_cast<int>(chasers.size()) < Benchmarks::FLOW_CHASERS; attempt++) {
+            TilePoint chaser;
+            if (!level.sampleWalkable(rng, region, chaser.x, chaser.y)) {
+                break;
+            }
+            if (std::abs(chaser.x - player.x) <= Level::FLOW_FIELD_RADIUS &&
+                std::abs(chaser.y - player.y) <= Level::FLOW_FIELD_RADIUS) {
+                chasers.push_back(chaser);
+            }
+        }
+        return chasers;
+    }
+
+    // The chase step enemies took before the flow field: straight at the target, then
+    // each axis on its own, then the first walkable neighbour
+    void takeGreedyStep(const Level& level, TilePoint& chaser, TilePoint target) {
+        if (!level.areConnected(chaser.x, chaser.y, target.x, target.y)) {
+            return;
+        }
+        float dx = static_cast<float>(target.x - chaser.x);
+        float dy = static_cast<float>(target.y - chaser.y);
+        float length = std::sqrt(dx * dx + dy * dy);
+        if (length == 0.0f) {
+            return;
+        }
+        int moveX = dx / length > 0.3f ? 1 : (dx / length < -0.3f ? -1 : 0);
+        int moveY = dy / length > 0.3f ? 1 : (dy / length < -0.3f ? -1 : 0);
+
+        const TilePoint candidates[3] = {
+            {chaser.x + moveX, chaser.y + moveY}, {chaser.x + moveX, chaser.y}, {chaser.x, chaser.y + moveY}};
+        for (const TilePoint& candidate : candidates) {
+            if ((candidate.x != chaser.x || candidate.y != chaser.y) && level.isWalkable(candidate.x, candidate.y)) {
+                chaser = candidate;
+                return;
+            }
+        }
+        for (int y = -1; y <= 1; y++) {
+            for (int x = -1; x <= 1; x++) {
+                if ((x != 0 || y != 0) && level.isWalkable(chaser.x + x, chaser.y + y)) {
+                    chaser = {chaser.x + x, chaser.y + y};
+                    return;
+                }
+            }
+        }
+    }
+
+    // Chasers within a step of the player at the end of a run
+    int countArrived(const std::vector<TilePoint>& chasers, TilePoint player) {
+        int arrived = 0;
+        for (const TilePoint& chaser : chasers) {
+            if (std::abs(chaser.x - player.x) <= 1 && std::abs(chaser.y - player.y) <= 1) {
+                arrived++;
+            }
+        }
+        return arrived;
+    }
+}
+
+int Benchmarks::runPaths() {
+    quietLogging();
+    int failures = 0;
+
+    for (int size : {100, 200}) {
+        // A few floors, since one floor has too few distinct goals
+        std::vector<std::unique_ptr<Level>> floors;
+        std::vector<std::vector<PathPair>> pairs;
+        size_t pairCount = 0;
+        for (int floor = 0; floor < PATH_FLOORS; floor++) {
+            floors.push_back(std::make_unique<Level>(size, size));
+            floors.back()->generateDungeon(SEED + floor);
+            pairs.push_back(makePathPairs(*floors.back(), PATH_PAIRS / PATH_FLOORS, SEED + floor));
+            pairCount += pairs.back().size();
+        }
+
+        // Same pairs through both searches; the costs must agree pair by pair
+        std::vector<float> costs[2];
+        const PathAlgorithm algorithms[2] = {PathAlgorithm::ASTAR, PathAlgorithm::JUMP_POINT};
+        for (int a = 0; a < 2; a++) {
+            std::vector<PathPoint> path;
+            costs[a].reserve(pairCount);
+            double milliseconds = 0.0;
+            uint64_t expanded = 0;
+            uint64_t cacheHits = 0;
+
+            for (int floor = 0; floor < PATH_FLOORS; floor++) {
+                PathService paths;
+                paths.reset(size, size);
+
+                auto start = Clock::now();
+                for (const PathPair& pair : pairs[floor]) {
+                    bool found = paths.findPath(*floors[floor], pair.startX, pair.startY, pair.goalX, pair.goalY,
+                                                algorithms[a], path);
+                    costs[a].push_back(found ? getPathCost(path) : -1.0f);
+                }
+                milliseconds += millisecondsSince(start);
+                expanded += paths.getExpandedNodeCount();
+                cacheHits += paths.getCacheHitCount();
+            }
+
+            std::printf("paths %dx%d %-4s %5zu paths %8.2f ms %8.1f paths/ms %7.1f expanded/path %llu cache hits\n",
+                        size, size, a == 0 ? "A*" : "JPS", pairCount, milliseconds,
+                        milliseconds > 0.0 ? pairCount / milliseconds : 0.0,
+                        pairCount > 0 ? static_cast<double>(expanded) / pairCount : 0.0,
+                        static_cast<unsigned long long>(cacheHits));
+        }
+
+        int mismatches = 0;
+        for (size_t i = 0; i < pairCount; i++) {
+            if (std::abs(costs[0][i] - costs[1][i]) > 0.01f) {
+                mismatches++;
+            }
+        }
+        if (mismatches > 0) {
+            std::printf("paths %dx%d: %d JPS paths differ in cost from A*\n", size, size, mismatches);
+            failures++;
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
+
+int Benchmarks::runTimers() {
+    quietLogging();
+    int failures = 0;
+
+    // Sleeping enemies don't come due during the run, idle ones far from the player wake every
+    // few seconds and busy ones several times a second
+    struct Scenario {
+        const char* name;
+        float minSeconds;
+        float maxSeconds;
+    };
+    const Scenario scenarios[] = {{"asleep", 60.0f, 600.0f}, {"idle", 2.0f, 30.0f}, {"busy", 0.1f, 1.0f}};
+
+    for (const Scenario& scenario : scenarios) {
+        std::vector<TimerDelays> delays = makeTimerDelays(TIMER_ENEMIES, scenario.minSeconds, scenario.maxSeconds, SEED);
+        TimerRun polled = pollTimers(delays);
+        TimerRun wheel = advanceWheel(delays);
+
+        std::printf("timers %s %d enemies (%.1f-%.1f s) polling %9.5f ms/frame %9llu fired, "
+                    "wheel %9.5f ms/frame %9llu fired\n",
+                    scenario.name, TIMER_ENEMIES, scenario.minSeconds, scenario.maxSeconds,
+                    polled.milliseconds / TIMER_FRAMES, static_cast<unsigned long long>(polled.fired),
+                    wheel.milliseconds / TIMER_FRAMES, static_cast<unsigned long long>(wheel.fired));
+        if (wheel.misses > 0) {
+            std::printf("timers %s: %d timers fired more than a frame away from their deadline\n",
+                        scenario.name, wheel.misses);
+            failures++;
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
+
+int Benchmarks::runFlowField() {
+    quietLogging();
+    int failures = 0;
+
+    for (int floor = 0; floor < FLOW_FLOORS; floor++) {
+        Level level(200, 200);
+        level.generateDungeon(SEED + floor);
+        TilePoint start = {level.getPlayerStartX(), level.getPlayerStartY()};
+        std::vector<TilePoint> trail = makePlayerTrail(level, start, SEED + floor);
+        const std::vector<TilePoint> chasers = makeChasers(level, start, SEED + floor);
+
+        // Shared field: refreshed when the player changes tile, then one lookup per chaser
+        FlowField field;
+        field.reset(level.getWidth(), level.getHeight());
+        std::vector<TilePoint> flowChasers = chasers;
+        int rebuilds = 0;
+        int badSteps = 0;
+        auto flowStart = Clock::now();
+        for (const TilePoint& player : trail) {
+            if (field.update(level, player.x, player.y, Level::FLOW_FIELD_RADIUS)) {
+                rebuilds++;
+            }
+            for (TilePoint& chaser : flowChasers) {
+                int stepX, stepY;
+                if (!field.getStep(chaser.x, chaser.y, stepX, stepY)) {
+                    continue;
+                }
+                int distance = field.getDistance(chaser.x, chaser.y);
+                chaser.x += stepX;
+                chaser.y += stepY;
+                if (field.getDistance(chaser.x, chaser.y) != distance - 1) {
+                    badSteps++;
+                }
+            }
+        }
+        double flowMilliseconds = millisecondsSince(flowStart);
+
+        // Every chaser working out its own step
+        std::vector<TilePoint> greedyChasers = chasers;
+        auto greedyStart = Clock::now();
+        for (const TilePoint& player : trail) {
+            for (TilePoint& chaser : greedyChasers) {
+                takeGreedyStep(level, chaser, player);
+            }
+        }
+        double greedyMilliseconds = millisecondsSince(greedyStart);
+
+        // A rebuild on its own, as when a tile changes walkability
+        auto rebuildStart = Clock::now();
+        for (int i = 0; i < FLOW_REBUILDS; i++) {
+            field.invalidate();
+            field.update(level, trail.back().x, trail.back().y, Level::FLOW_FIELD_RADIUS);
+        }
+        double rebuildMilliseconds = millisecondsSince(rebuildStart);
+
+        std::printf("flow field floor %d %5zu chasers %3d rebuilds: field %7.4f ms/frame %5d arrived, "
+                    "greedy %7.4f ms/frame %5d arrived, forced rebuild %6.2f us %4zu cells\n",
+                    floor, chasers.size(), rebuilds, flowMilliseconds / FLOW_FRAMES,
+                    countArrived(flowChasers, trail.back()), greedyMilliseconds / FLOW_FRAMES,
+                    countArrived(greedyChasers, trail.back()), rebuildMilliseconds * 1000.0 / FLOW_REBUILDS,
+                    field.getReachedCellCount());
+        if (badSteps > 0) {
+            std::printf("flow field floor %d: %d steps didn't bring their chaser one step closer\n", floor, badSteps);
+            failures++;
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
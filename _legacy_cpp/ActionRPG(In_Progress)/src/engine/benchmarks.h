@@ -0,0 +1,36 @@
+#pragma once
+
+// Headless throughput measurements on generated dungeons, run from main with a
+// --bench-* flag instead of starting the game. Each prints its results to
+// stdout and returns the process exit code: non-zero if a consistency check
+// made along the way failed.
+class Benchmarks {
+public:
+    // A* and jump point search paths per millisecond between random pairs of tiles
+    // on a few floors. No goal repeats on a floor, so every request misses the path cache.
+    static int runPaths();
+
+    // Per-frame cost of enemy wake-ups with TIMER_ENEMIES idle enemies, each with a
+    // wake-up and an alert expiry: decrementing every timer every frame, as enemies
+    // did before the timer wheel, against advancing the wheel. Checks that the wheel
+    // fires every timer within a tick of when polling would.
+    static int runTimers();
+
+    // Per-frame cost of FLOW_CHASERS enemies chasing a player wandering from the start room: one shared flow
+    // field refreshed as the player moves and read by every chaser, against each chaser
+    // taking the greedy step it used before the field. Checks that every flow step
+    // brings its chaser one step closer.
+    static int runFlowField();
+
+    // Constants
+    static constexpr unsigned int SEED = 12345;
+    static constexpr int PATH_PAIRS = 2000; // Per floor size, split over PATH_FLOORS floors
+    static constexpr int PATH_FLOORS = 4;
+    static constexpr int TIMER_ENEMIES = 100000;
+    static constexpr int TIMER_FRAMES = 600; // 10 seconds at 60 fps
+    static constexpr int FLOW_CHASERS = 10000;
+    static constexpr int FLOW_FRAMES = 600;
+    static constexpr int FLOW_FLOORS = 4; // Each chase starts in a different floor's start room
+    static constexpr int FLOW_MOVE_FRAMES = 8;  // Frames between player steps
+    static constexpr int FLOW_REBUILDS = 1000; // Forced rebuilds timed on their own
+};
@@ -0,0 +1,78 @@
+#include "frame_arena.h"
+#include <algorithm>
+#include <cstdint>
+
+FrameArena::FrameArena(size_t initialCapacity) {
+    for (Buffer& buffer : buffers) {
+        buffer.memory.reset(new std::byte[initialCapacity]);
+        buffer.capacity = initialCapacity;
+    }
+}
+
+FrameArena::~FrameArena() {
+    for (Buffer& buffer : buffers) {
+        rewind(buffer);
+    }
+}
+
+FrameArena& FrameArena::get() {
+    static FrameArena arena;
+    return arena;
+}
+
+void FrameArena::beginFrame() {
+    highWaterMark = std::max(highWaterMark, getUsed());
+
+    // The other buffer held the frame before last, which nothing refers to any more
+    current = 1 - current;
+    Buffer& buffer = buffers[current];
+    rewind(buffer);
+
+    // Grow once here rather than overflowing every frame
+    if (highWaterMark > buffer.capacity) {
+        size_t newCapacity = highWaterMark + highWaterMark / GROWTH_HEADROOM;
+        buffer.memory.reset(new std::byte[newCapacity]);
+        buffer.capacity = newCapacity;
+    }
+}
+
+size_t FrameArena::getUsed() const {
+    return buffers[current].used + buffers[current].overflowBytes;
+}
+
+void FrameArena::rewind(Buffer& buffer) {
+    for (const Overflow& block : buffer.overflow) {
+        std::pmr::new_delete_resource()->deallocate(block.memory, block.bytes, block.alignment);
+    }
+    buffer.overflow.clear();
+    buffer.overflowBytes = 0;
+    buffer.used = 0;
+}
+
+void* FrameArena::do_allocate(size_t bytes, size_t alignment) {
+    Buffer& buffer = buffers[current];
+
+    // Align the address, not the offset; the buffer itself is only aligned for new
+    uintptr_t base = reinterpret_cast<uintptr_t>(buffer.memory.get());
+    uintptr_t start = (base + buffer.used + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+    size_t end = static_cast<size_t>(start - base) + bytes;
+    if (end <= buffer.capacity) {
+        buffer.used = end;
+        return reinterpret_cast<void*>(start);
+    }
+
+    // Full: borrow from the heap until this buffer is rewound
+    void* memory = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    buffer.overflow.push_back(Overflow{memory, bytes, alignment});
+    buffer.overflowBytes += bytes;
+    overflowCount++;
+    return memory;
+}
+
+void FrameArena::do_deallocate(void*, size_t, size_t) {
+    // Everything is released together when the buffer is rewound
+}
+
+bool FrameArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
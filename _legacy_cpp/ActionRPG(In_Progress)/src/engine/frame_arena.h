@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+// Bump allocator for data that only lives for the frame it was built in:
+// vertex lists, display strings and other scratch containers. There are two
+// buffers; beginFrame() switches to the other one and rewinds it, so what the
+// previous frame built stays valid for one more frame. Freeing does nothing.
+//
+// Anything that does not fit goes to the global heap until that buffer is
+// next rewound, at which point the buffer grows past the high-water mark.
+// After that, steady frames never call the global allocator.
+//
+// Not thread-safe; the game's arena belongs to the main thread.
+class FrameArena : public std::pmr::memory_resource {
+public:
+    explicit FrameArena(size_t initialCapacity = DEFAULT_CAPACITY);
+    ~FrameArena() override;
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // The game's arena, rewound once per frame by the game loop
+    static FrameArena& get();
+
+    // Call at the top of every frame
+    void beginFrame();
+
+    // Bytes handed out so far this frame, including heap overflow
+    size_t getUsed() const;
+    size_t getCapacity() const { return buffers[current].capacity; }
+    // Most bytes a single frame has used
+    size_t getHighWaterMark() const { return highWaterMark; }
+    // Allocations that did not fit and went to the global heap
+    size_t getOverflowCount() const { return overflowCount; }
+
+    // Constants
+    static constexpr size_t DEFAULT_CAPACITY = 4 * 1024 * 1024; // Per buffer
+    static constexpr size_t GROWTH_HEADROOM = 4;                // Grow to the high-water mark plus a quarter
+
+private:
+    // Heap block taken when the buffer was full
+    struct Overflow {
+        void* memory;
+        size_t bytes;
+        size_t alignment;
+    };
+
+    struct Buffer {
+        std::unique_ptr<std::byte[]> memory;
+        size_t capacity = 0;
+        size_t used = 0;
+        size_t overflowBytes = 0;
+        std::vector<Overflow> overflow;
+    };
+
+    Buffer buffers[2];
+    int current = 0;
+    size_t highWaterMark = 0;
+    size_t overflowCount = 0;
+
+    void rewind(Buffer& buffer);
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* memory, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+};
+
+// Containers for per-frame data; construct them with &FrameArena::get()
+template <typename T>
+using FrameVector = std::pmr::vector<T>;
+using FrameString = std::pmr::string;
@@ -3,12 +3,18 @@
 #include <chrono>
 #include <thread>
 #include <cmath>
+#include <cstdio>
+#include <ctime>
 #include "../game/enemy.h"
 #include "../game/item.h"
 #include "../engine/renderer.h"
 #include "../ui/ui_system.h"
+#include "allocation_tracker.h"
+#include "logger.h"
 
-GameLoop::GameLoop(VulkanRenderer* vulkanRenderer) : vulkanRenderer(vulkanRenderer), window(nullptr), currentState(GameState::CHARACTER_SELECT) {
+GameLoop::GameLoop(VulkanRenderer* vulkanRenderer)
+    : vulkanRenderer(vulkanRenderer), window(nullptr), currentState(GameState::CHARACTER_SELECT),
+      worldSeed(static_cast<unsigned int>(std::time(nullptr))) {
     // Initialize UI system
     uiSystem = std::make_unique<UISystem>();
 
@@ -25,7 +31,7 @@ GameLoop::~GameLoop() {
 
 bool GameLoop::initialize() {
     try {
-        std::cout << "Starting GameLoop initialization..." << std::endl;
+        LOG_INFO(ENGINE, "Starting GameLoop initialization...");
         
         // Note: GLFW is already initialized in the VulkanRenderer class
         
@@ -34,7 +40,7 @@ bool GameLoop::initialize() {
         glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
         
         // Add this line to debug window creation
-        std::cout << "Creating GLFW window..." << std::endl;
+        LOG_INFO(ENGINE, "Creating GLFW window...");
         
         window = glfwCreateWindow(WIDTH, HEIGHT, WINDOW_TITLE, nullptr, nullptr);
         if (!window) {
@@ -43,44 +49,47 @@ bool GameLoop::initialize() {
             return false;
         }
         
-        std::cout << "GLFW window created successfully" << std::endl;
+        LOG_INFO(ENGINE, "GLFW window created successfully");
+        
+        // Key events are queued by callbacks and consumed once per frame
+        input.attach(window);
         
         // Create Vulkan surface
-        std::cout << "Creating Vulkan surface..." << std::endl;
+        LOG_INFO(ENGINE, "Creating Vulkan surface...");
         if (!vulkanRenderer->createSurface(window)) {
             std::cerr << "Failed to create Vulkan surface" << std::endl;
             return false;
         }
         
-        std::cout << "Vulkan surface created successfully" << std::endl;
+        LOG_INFO(ENGINE, "Vulkan surface created successfully");
         
         // Initialize the Vulkan swapchain and rendering components
-        std::cout << "Initializing Vulkan swapchain..." << std::endl;
+        LOG_INFO(ENGINE, "Initializing Vulkan swapchain...");
         if (!vulkanRenderer->initializeSwapchain()) {
             std::cerr << "Failed to initialize Vulkan swapchain" << std::endl;
             return false;
         }
-        std::cout << "Vulkan swapchain initialized successfully" << std::endl;
+        LOG_INFO(ENGINE, "Vulkan swapchain initialized successfully");
         
         // Note: We no longer create the player and level here
         // They will be created after character selection
-        std::cout << "Game will start with character selection screen" << std::endl;
+        LOG_INFO(ENGINE, "Game will start with character selection screen");
         
         // Create renderer
-        std::cout << "Creating renderer..." << std::endl;
+        LOG_INFO(ENGINE, "Creating renderer...");
         renderer = std::make_unique<Renderer>(vulkanRenderer);
         if (!renderer) {
             std::cerr << "Failed to create renderer" << std::endl;
             return false;
         }
         
-        std::cout << "Initializing renderer..." << std::endl;
+        LOG_INFO(ENGINE, "Initializing renderer...");
         renderer->initialize();
-        std::cout << "Renderer initialized successfully" << std::endl;
+        LOG_INFO(ENGINE, "Renderer initialized successfully");
 
         vulkanRenderer->setRenderer(renderer.get());
 
-        std::cout << "GameLoop initialization complete" << std::endl;
+        LOG_INFO(ENGINE, "GameLoop initialization complete");
         return true;
     } catch (const std::exception& e) {
         std::cerr << "Exception in GameLoop::initialize: " << e.what() << std::endl;
@@ -102,6 +111,7 @@ void GameLoop::cleanup() {
     
     // Then clean up the window
     if (window) {
+        input.detach();
         glfwDestroyWindow(window);
         window = nullptr;
     }
@@ -111,58 +121,56 @@ void GameLoop::cleanup() {
 }
 
 void GameLoop::processInput() {
-    // Check if escape key is pressed to exit
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
-        glfwSetWindowShouldClose(window, true);
-    }
-    
     // Handle input based on current game state
     switch (currentState) {
         case GameState::CHARACTER_SELECT:
             handleCharacterSelectInput();
             break;
             
+        case GameState::LOADING:
+            // No input while waiting for the level
+            break;
+            
         case GameState::PLAYING:
             // Check for inventory toggle
-            if (isKeyJustPressed(GLFW_KEY_I)) {
+            if (input.wasPressed(InputAction::TOGGLE_INVENTORY)) {
                 inventoryUI->toggleVisibility();
-                std::cout << "Inventory toggled: " << (inventoryUI->isInventoryVisible() ? "visible" : "hidden") << std::endl;
+                LOG_DEBUG(UI, "Inventory toggled: {}", inventoryUI->isInventoryVisible() ? "visible" : "hidden");
             }
             
             // Handle inventory input if visible
             if (inventoryUI->isInventoryVisible() && player) {
-                // Handle inventory navigation keys
-                if (isKeyJustPressed(GLFW_KEY_UP) || isKeyJustPressed(GLFW_KEY_DOWN) || 
-                    isKeyJustPressed(GLFW_KEY_LEFT) || isKeyJustPressed(GLFW_KEY_RIGHT) || 
-                    isKeyJustPressed(GLFW_KEY_E) || isKeyJustPressed(GLFW_KEY_Q)) {
-                    
-                    int key = -1;
-                    if (isKeyJustPressed(GLFW_KEY_UP)) key = GLFW_KEY_UP;
-                    else if (isKeyJustPressed(GLFW_KEY_DOWN)) key = GLFW_KEY_DOWN;
-                    else if (isKeyJustPressed(GLFW_KEY_LEFT)) key = GLFW_KEY_LEFT;
-                    else if (isKeyJustPressed(GLFW_KEY_RIGHT)) key = GLFW_KEY_RIGHT;
-                    else if (isKeyJustPressed(GLFW_KEY_E)) key = GLFW_KEY_E;
-                    else if (isKeyJustPressed(GLFW_KEY_Q)) key = GLFW_KEY_Q;
-                    
-                    if (key != -1) {
-                        inventoryUI->handleInput(key, player);
-                    }
+                // Handle inventory navigation; the inventory UI still takes GLFW key codes
+                int key = -1;
+                if (input.wasPressed(InputAction::MENU_UP)) key = GLFW_KEY_UP;
+                else if (input.wasPressed(InputAction::MENU_DOWN)) key = GLFW_KEY_DOWN;
+                else if (input.wasPressed(InputAction::MENU_LEFT)) key = GLFW_KEY_LEFT;
+                else if (input.wasPressed(InputAction::MENU_RIGHT)) key = GLFW_KEY_RIGHT;
+                else if (input.wasPressed(InputAction::USE_ITEM)) key = GLFW_KEY_E;
+                else if (input.wasPressed(InputAction::DROP_ITEM)) key = GLFW_KEY_Q;
+                
+                if (key != -1) {
+                    inventoryUI->handleInput(key, player);
                 }
             }
             break;
             
         case GameState::GAME_OVER:
             // Check for restart key
-            if (glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS) {
+            if (input.wasPressed(InputAction::RESTART)) {
                 // Reset to character selection
                 currentState = GameState::CHARACTER_SELECT;
                 characterSelectScreen = std::make_unique<CharacterSelectScreen>(uiSystem.get());
+                
+                // Start over from the first floor of a new dungeon; the old seed would repeat the last game
+                worldSeed = static_cast<unsigned int>(std::time(nullptr));
+                beginLevelGeneration(1);
             }
             break;
             
         case GameState::PAUSE_MENU:
             // Check for unpause key
-            if (glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS) {
+            if (input.wasPressed(InputAction::UNPAUSE)) {
                 currentState = GameState::PLAYING;
             }
             break;
@@ -179,20 +187,20 @@ void GameLoop::handlePlayerMovement(float deltaTime) {
         float dy = 0.0f;
         bool moved = false;
         
-        // Get movement input - support both WASD and arrow keys
-        if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS) {
+        // Get movement input - WASD and arrow keys by default
+        if (input.isDown(InputAction::MOVE_UP)) {
             dy -= 1.0f;
             moved = true;
         }
-        if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS) {
+        if (input.isDown(InputAction::MOVE_DOWN)) {
             dy += 1.0f;
             moved = true;
         }
-        if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS) {
+        if (input.isDown(InputAction::MOVE_LEFT)) {
             dx -= 1.0f;
             moved = true;
         }
-        if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS) {
+        if (input.isDown(InputAction::MOVE_RIGHT)) {
             dx += 1.0f;
             moved = true;
         }
@@ -214,7 +222,9 @@ void GameLoop::handlePlayerMovement(float deltaTime) {
             int tileX = static_cast<int>(std::round(newX));
             int tileY = static_cast<int>(std::round(newY));
             
-            if (currentLevel->isWalkable(tileX, tileY)) {
+            // Walls and enemies both block; the reservation is committed by the move
+            if (currentLevel->canEnter(tileX, tileY, player.get()) &&
+                currentLevel->getOccupancy().tryReserve(player->getOccupantId(), tileX, tileY)) {
                 // Move player to the new position
                 player->move(newX, newY);
                 
@@ -222,128 +232,156 @@ void GameLoop::handlePlayerMovement(float deltaTime) {
                 movementTimer = MOVEMENT_COOLDOWN;
                 
                 // Debug output
-                std::cout << "Player moved to: (" << player->getX() << ", " << player->getY() << ")" << std::endl;
+                LOG_TRACE(INPUT, "Player moved to: ({}, {})", player->getX(), player->getY());
             }
         }
     }
 }
 
 void GameLoop::handlePlayerActions() {
-    static bool attackKeyPressed = false;
-    
     // Attack nearest enemy
-    if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS) {
-        if (!attackKeyPressed) {
-            attackKeyPressed = true;
-            
-            // Find the nearest enemy
-            auto enemies = currentLevel->getEnemies();
-            std::shared_ptr<Enemy> nearestEnemy = nullptr;
-            float minDistance = std::numeric_limits<float>::max();
-            
-            for (const auto& enemy : enemies) {
-                if (enemy->isDead()) continue;
+    if (input.wasPressed(InputAction::ATTACK)) {
+        // Find the nearest living enemy through the level's spatial index
+        EnemyHandle target = currentLevel->findNearestEnemy(player->getX(), player->getY(),
+                                                            std::numeric_limits<float>::max());
+        Enemy* nearestEnemy = currentLevel->resolve(target);
+        
+        if (nearestEnemy) {
+            // Check if enemy is in range based on player's attack type
+            float dx = nearestEnemy->getX() - player->getX();
+            float dy = nearestEnemy->getY() - player->getY();
+            float distance = std::sqrt(dx * dx + dy * dy);
+            float attackRange = player->getAttackRange();
+            
+            if (distance <= attackRange) {
+                // Perform the attack; the noise wakes dormant enemies nearby
+                player->attack(*nearestEnemy);
+                currentLevel->alertEnemies(player->getX(), player->getY(), Level::ALERT_RADIUS);
                 
-                float dx = enemy->getX() - player->getX();
-                float dy = enemy->getY() - player->getY();
-                float distanceSquared = dx * dx + dy * dy;
+                // Create appropriate visual effect based on character class
+                Character::VisualEffectType effectType = player->getAttackVisualEffect();
                 
-                if (distanceSquared < minDistance) {
-                    minDistance = distanceSquared;
-                    nearestEnemy = enemy;
+                // For melee attacks, effect appears at enemy position
+                if (player->getDefaultAttackType() == Character::AttackType::MELEE) {
+                    effectManager.addEffect(effectType, 
+                                          player->getX(), player->getY(),
+                                          nearestEnemy->getX(), nearestEnemy->getY());
                 }
-            }
-            
-            if (nearestEnemy) {
-                // Check if enemy is in range based on player's attack type
-                float distance = std::sqrt(minDistance);
-                float attackRange = player->getAttackRange();
-                
-                if (distance <= attackRange) {
-                    // Perform the attack
-                    player->attack(nearestEnemy.get());
-                    
-                    // Create appropriate visual effect based on character class
-                    Character::VisualEffectType effectType = player->getAttackVisualEffect();
-                    
-                    // For melee attacks, effect appears at enemy position
-                    if (player->getDefaultAttackType() == Character::AttackType::MELEE) {
-                        effectManager.addEffect(effectType, 
-                                              player->getX(), player->getY(),
-                                              nearestEnemy->getX(), nearestEnemy->getY());
-                    }
-                    // For ranged attacks, effect travels from player to enemy
-                    else {
-                        effectManager.addEffect(effectType, 
-                                              player->getX(), player->getY(),
-                                              nearestEnemy->getX(), nearestEnemy->getY());
-                    }
-                } else {
-                    std::cout << "Enemy is out of range!" << std::endl;
+                // For ranged attacks, effect travels from player to enemy
+                else {
+                    effectManager.addEffect(effectType, 
+                                          player->getX(), player->getY(),
+                                          nearestEnemy->getX(), nearestEnemy->getY());
                 }
+            } else {
+                LOG_DEBUG(COMBAT, "Enemy is out of range!");
             }
         }
-    } else {
-        // Reset attack key state when key is released
-        attackKeyPressed = false;
     }
     
     // Pick up item
-    static bool pickupKeyPressed = false;
-    if (glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS) {
-        if (!pickupKeyPressed) {
-            pickupKeyPressed = true;
-            
-            // Check for items in pickup range
-            int itemIndex = currentLevel->getPickupItemIndex(player->getX(), player->getY());
-            if (itemIndex >= 0) {
-                // Pickup the item
-                auto item = currentLevel->pickupItem(itemIndex);
-                if (item) {
-                    // Add to player inventory
-                    player->addItem(item);
-                    
-                    // Display item information based on rarity
-                    std::string rarityText;
-                    switch (item->getRarity()) {
-                        case ItemRarity::COMMON:
-                            rarityText = "Common";
-                            break;
-                        case ItemRarity::UNCOMMON:
-                            rarityText = "Uncommon";
-                            break;
-                        case ItemRarity::RARE:
-                            rarityText = "Rare";
-                            break;
-                        case ItemRarity::EPIC:
-                            rarityText = "Epic";
-                            break;
-                        case ItemRarity::LEGENDARY:
-                            rarityText = "Legendary";
-                            break;
-                    }
-                    
-                    std::cout << "Picked up: [" << rarityText << "] " << item->getName() << " - " << item->getDescription() << std::endl;
+    if (input.wasPressed(InputAction::PICK_UP)) {
+        // Check for items in pickup range
+        ItemDropHandle itemHandle = currentLevel->getPickupItemHandle(player->getX(), player->getY());
+        if (itemHandle.isValid()) {
+            AllocationScope lootScope(AllocationTag::LOOT);
+            
+            // Pickup the item
+            ItemInstance item;
+            if (currentLevel->pickupItem(itemHandle, item)) {
+                // Add to player inventory
+                player->addItem(item);
+                
+                // Display item information based on rarity
+                std::string rarityText;
+                switch (item.getRarity()) {
+                    case ItemRarity::COMMON:
+                        rarityText = "Common";
+                        break;
+                    case ItemRarity::UNCOMMON:
+                        rarityText = "Uncommon";
+                        break;
+                    case ItemRarity::RARE:
+                        rarityText = "Rare";
+                        break;
+                    case ItemRarity::EPIC:
+                        rarityText = "Epic";
+                        break;
+                    case ItemRarity::LEGENDARY:
+                        rarityText = "Legendary";
+                        break;
+                }
+                
+                // Straight from the instance; building an Item just to describe it would allocate
+                const char* statText = "Power";
+                switch (item.getType()) {
+                    case ItemType::WEAPON:
+                        statText = "Damage";
+                        break;
+                    case ItemType::ARMOR:
+                        statText = "Defense";
+                        break;
+                    case ItemType::POTION:
+                        statText = "Heals";
+                        break;
+                    default:
+                        break;
                 }
+                
+                LOG_INFO(ITEMS, "Picked up: [{}] {} - {}: {}, Value: {} gold", rarityText, item.getName(), statText,
+                         item.stat, item.getValue());
             }
         }
-    } else {
-        pickupKeyPressed = false;
     }
     
     // Use health potion
-    if (glfwGetKey(window, GLFW_KEY_H) == GLFW_PRESS) {
+    if (input.wasPressed(InputAction::USE_POTION)) {
         // Find a health potion in inventory
-        for (const auto& item : player->getInventory()) {
-            auto potion = std::dynamic_pointer_cast<Potion>(item);
-            if (potion) {
-                potion->use();
-                player->heal(potion->getHealAmount());
-                player->removeItem(item);
-                std::cout << "Used health potion. Health: " << player->getHealth() << "/" << player->getMaxHealth() << std::endl;
-                break;
-            }
+        const auto& inventory = player->getInventory();
+        Inventory::Slot slot = inventory.findFirst(ItemType::POTION);
+        if (slot != Inventory::INVALID_SLOT) {
+            const ItemInstance& potion = inventory[slot];
+            LOG_INFO(ITEMS, "You drink the {} and restore {} health.", potion.getName(), potion.stat);
+            player->heal(potion.stat);
+            player->consumeItem(static_cast<int>(slot));
+            LOG_INFO(ITEMS, "Used health potion. Health: {}/{}", player->getHealth(), player->getMaxHealth());
+        }
+    }
+}
+
+void GameLoop::tick() {
+    // This tick's actions come from the recording or from what the keyboard did since the last tick
+    TickInput tickInput;
+    if (replaying) {
+        if (currentState != GameState::PLAYING || !replayPlayer.nextTick(tickInput)) {
+            finishReplay();
+            return;
         }
+    } else {
+        tickInput.actionsDown = input.getActionsDown();
+        tickInput.actionsPressed = pendingPressed;
+        pendingPressed = 0;
+    }
+    input.setActions(tickInput.actionsDown, tickInput.actionsPressed);
+    
+    // Only gameplay ticks are recorded; the menus before it are replaced by the recording's config
+    bool playing = currentState == GameState::PLAYING;
+    processInput();
+    update(TICK_SECONDS);
+    if (!playing || !currentLevel) {
+        return;
+    }
+    
+    if (recorder.isRecording()) {
+        recorder.recordTick(tickInput);
+        if (recorder.getTickCount() % recorder.getConfig().checksumInterval == 0) {
+            recorder.recordChecksum(currentLevel->computeChecksum());
+        }
+        if (currentState == GameState::GAME_OVER) {
+            stopRecording();
+        }
+    } else if (replaying) {
+        replayPlayer.verifyChecksum(currentLevel->computeChecksum());
     }
 }
 
@@ -354,6 +392,13 @@ void GameLoop::update(float deltaTime) {
             updateCharacterSelect(deltaTime);
             break;
             
+        case GameState::LOADING:
+            // Enter the game as soon as the background job has finished the level
+            if (levelJob.isReady()) {
+                startGame();
+            }
+            break;
+            
         case GameState::PLAYING:
             // In PLAYING state, we should always have player and level initialized
             // But check just to be safe
@@ -371,7 +416,7 @@ void GameLoop::update(float deltaTime) {
             handlePlayerActions();
             
             // Update level (includes enemy AI, etc.)
-            currentLevel->update(deltaTime, player.get());
+            currentLevel->update(deltaTime, playerHandle);
             
             // Update visual effects
             effectManager.update(deltaTime);
@@ -385,14 +430,22 @@ void GameLoop::update(float deltaTime) {
             }
             
             // Debug output
-            std::cout << "Player position: " << player->getX() << ", " << player->getY() 
-                      << " | Health: " << player->getHealth() << "/" << player->getMaxHealth()
-                      << " | Enemies: " << currentLevel->getEnemies().size() << std::endl;
+            LOG_TRACE(GENERAL, "Player position: {}, {} | Health: {}/{} | Enemies: {} (near {}, mid {}, dormant {})",
+                      player->getX(), player->getY(), player->getHealth(), player->getMaxHealth(),
+                      currentLevel->getEnemies().size(), currentLevel->getLodStats().nearCount,
+                      currentLevel->getLodStats().midCount, currentLevel->getLodStats().dormantCount);
             
             // Check for game over condition
             if (player->getHealth() <= 0) {
                 currentState = GameState::GAME_OVER;
-                std::cout << "Game Over!" << std::endl;
+                LOG_INFO(GENERAL, "Game Over!");
+                break;
+            }
+            
+            // Descend once the floor is cleared and the next one is ready; a deterministic run
+            // waits for it instead, so the descent happens on the same tick every time
+            if (currentLevel->getEnemies().empty() && (currentLevel->isDeterministic() || levelJob.isReady())) {
+                advanceFloor();
             }
             break;
             
@@ -404,27 +457,34 @@ void GameLoop::update(float deltaTime) {
 }
 
 void GameLoop::render() {
+    AllocationScope renderScope(AllocationTag::RENDER);
+    
     // Render based on current game state
     switch (currentState) {
         case GameState::CHARACTER_SELECT:
             renderCharacterSelect();
             break;
             
+        case GameState::LOADING:
+            renderLoading();
+            break;
+            
         case GameState::PLAYING:
             // Make sure level and player are initialized before rendering
             if (currentLevel && player && renderer) {
                 // Combine all vertices for a single render call
-                std::vector<Vertex> allVertices;
+                FrameVector<Vertex> allVertices(&FrameArena::get());
                 
                 // Get game world vertices
-                std::vector<Vertex> gameWorldVertices = renderer->generateGameWorldVertices(currentLevel, player, effectManager);
+                FrameVector<Vertex> gameWorldVertices = renderer->generateGameWorldVertices(currentLevel, player, effectManager);
                 allVertices.insert(allVertices.end(), gameWorldVertices.begin(), gameWorldVertices.end());
                 
                 // Add inventory UI vertices if visible
                 if (inventoryUI->isInventoryVisible()) {
-                    std::vector<Vertex> inventoryVertices = inventoryUI->generateInventoryVertices(player);
+                    AllocationScope uiScope(AllocationTag::UI);
+                    FrameVector<Vertex> inventoryVertices = inventoryUI->generateInventoryVertices(player);
                     if (!inventoryVertices.empty()) {
-                        std::cout << "Adding inventory UI with " << inventoryVertices.size() << " vertices" << std::endl;
+                        LOG_TRACE(UI, "Adding inventory UI with {} vertices", inventoryVertices.size());
                         allVertices.insert(allVertices.end(), inventoryVertices.begin(), inventoryVertices.end());
                     }
                 }
@@ -453,17 +513,22 @@ void GameLoop::updateCharacterSelect(float deltaTime) {
         // Create the player character based on the selected class
         createPlayerCharacter(characterSelectScreen->getSelectedClass());
         
-        // Start the game
-        startGame();
+        // Start the game once the first floor has finished generating
+        if (!levelJob.isValid()) {
+            beginLevelGeneration(1);
+        }
+        currentState = GameState::LOADING;
     }
 }
 
 void GameLoop::renderCharacterSelect() {
+    AllocationScope uiScope(AllocationTag::UI);
+    
     // Generate vertices for the character selection screen
-    std::vector<Vertex> vertices = characterSelectScreen->generateVertices(uiSystem.get());
+    FrameVector<Vertex> vertices = characterSelectScreen->generateVertices(uiSystem.get());
     
     // Debug output
-    std::cout << "Rendering character selection screen with " << vertices.size() << " vertices" << std::endl;
+    LOG_TRACE(UI, "Rendering character selection screen with {} vertices", vertices.size());
     
     if (renderer) {
         renderer->updateVertexBuffer(vertices); // This will call createVertexBuffer, which in turn calls vulkanRenderer->setCurrentVertexBuffer
@@ -471,23 +536,13 @@ void GameLoop::renderCharacterSelect() {
     vulkanRenderer->render();
 }
 
-bool GameLoop::isKeyJustPressed(int key) {
-    bool currentlyPressed = (glfwGetKey(window, key) == GLFW_PRESS);
-    bool wasPressedPreviously = previousKeyStates.count(key) ? previousKeyStates[key] : false;
-
-    // Update the state for this key for the next frame's check
-    previousKeyStates[key] = currentlyPressed;
-
-    return currentlyPressed && !wasPressedPreviously;
-}
-
 void GameLoop::handleCharacterSelectInput() {
     // Check for key press events
-    if (isKeyJustPressed(GLFW_KEY_LEFT) || isKeyJustPressed(GLFW_KEY_A)) {
+    if (input.wasPressed(InputAction::MENU_LEFT)) {
         characterSelectScreen->handleInput(GLFW_KEY_LEFT);
-    } else if (isKeyJustPressed(GLFW_KEY_RIGHT) || isKeyJustPressed(GLFW_KEY_D)) {
+    } else if (input.wasPressed(InputAction::MENU_RIGHT)) {
         characterSelectScreen->handleInput(GLFW_KEY_RIGHT);
-    } else if (isKeyJustPressed(GLFW_KEY_ENTER) || isKeyJustPressed(GLFW_KEY_SPACE)) {
+    } else if (input.wasPressed(InputAction::CONFIRM)) {
         characterSelectScreen->handleInput(GLFW_KEY_ENTER);
     }
 }
@@ -508,46 +563,50 @@ void GameLoop::createPlayerCharacter(CharacterClass characterClass) {
     }
     
     player = std::make_shared<Character>("Player", characterClass);
-    std::cout << "Created " << className << " character!" << std::endl;
+    LOG_INFO(GENERAL, "Created {} character!", className);
 }
 
 void GameLoop::startGame() {
-    // Initialize the game world
-    currentLevel = std::make_shared<Level>(100, 100);
-    currentLevel->generateDungeon();
+    AllocationScope levelScope(AllocationTag::LEVEL);
     
-    // Place the player in a valid starting position
-    for (int y = 0; y < currentLevel->getHeight(); y++) {
-        for (int x = 0; x < currentLevel->getWidth(); x++) {
-            if (currentLevel->isWalkable(x, y)) {
-                player->move(static_cast<float>(x), static_cast<float>(y));
-                std::cout << "Placed player at starting position: (" << x << ", " << y << ")" << std::endl;
-                break;
-            }
-        }
+    // A recording starts with the game, after the class and seed that it stores are known
+    if (!recordPath.empty() && !replaying) {
+        startRecording();
     }
     
+    // Swap in the pre-generated first floor (enemies are already placed by the job)
+    floorNumber = levelJob.getFloorNumber();
+    currentLevel = levelJob.take();
+    currentLevel->setWorkerThreads(std::thread::hardware_concurrency());
+    currentLevel->setDeterministic(isDeterministic());
+    effectManager.clear();
+    movementTimer = 0.0f;
+    
+    // Place the player in a valid starting position
+    placePlayerAtStart();
+    
     // Give player some starting items based on their class
-    std::cout << "Adding starting items to player..." << std::endl;
+    LOG_INFO(ITEMS, "Adding starting items to player...");
     try {
         // Common items for all classes
-        player->addItem(std::make_shared<Potion>("Small Health Potion", ItemRarity::COMMON, 10));
+        const ItemDatabase& database = ItemDatabase::get();
+        player->addItem(database.createInstance(ItemDatabase::SMALL_HEALTH_POTION, ItemRarity::COMMON, 10));
         
         // Class-specific starting items
         switch (player->getClass()) {
             case CharacterClass::WARRIOR:
-                player->addItem(std::make_shared<Weapon>("Iron Sword", ItemRarity::COMMON, 6));
-                player->addItem(std::make_shared<Armor>("Leather Armor", ItemRarity::COMMON, 4));
+                player->addItem(database.createInstance(ItemDatabase::IRON_SWORD, ItemRarity::COMMON, 6));
+                player->addItem(database.createInstance(ItemDatabase::LEATHER_ARMOR, ItemRarity::COMMON, 4));
                 break;
                 
             case CharacterClass::RANGER:
-                player->addItem(std::make_shared<Weapon>("Wooden Bow", ItemRarity::COMMON, 5));
-                player->addItem(std::make_shared<Armor>("Light Leather Armor", ItemRarity::COMMON, 3));
+                player->addItem(database.createInstance(ItemDatabase::WOODEN_BOW, ItemRarity::COMMON, 5));
+                player->addItem(database.createInstance(ItemDatabase::LIGHT_LEATHER_ARMOR, ItemRarity::COMMON, 3));
                 break;
                 
             case CharacterClass::MAGE:
-                player->addItem(std::make_shared<Weapon>("Apprentice Staff", ItemRarity::COMMON, 7));
-                player->addItem(std::make_shared<Armor>("Cloth Robe", ItemRarity::COMMON, 2));
+                player->addItem(database.createInstance(ItemDatabase::APPRENTICE_STAFF, ItemRarity::COMMON, 7));
+                player->addItem(database.createInstance(ItemDatabase::CLOTH_ROBE, ItemRarity::COMMON, 2));
                 break;
         }
     } catch (const std::exception& e) {
@@ -555,50 +614,177 @@ void GameLoop::startGame() {
         // Continue even if items fail to add
     }
     
-    // Add some enemies to the level
-    for (int i = 0; i < 10; i++) {
-        // Find a valid position for the enemy
-        int x, y;
-        do {
-            x = rand() % currentLevel->getWidth();
-            y = rand() % currentLevel->getHeight();
-        } while (!currentLevel->isWalkable(x, y) || 
-                (std::abs(x - player->getX()) < 5 && std::abs(y - player->getY()) < 5));
-        
-        // Create and add the enemy
-        auto enemy = std::make_shared<Enemy>("Enemy", EnemyType::GOBLIN, 1);
-        enemy->setLevel(currentLevel.get());
-        currentLevel->addEnemy(enemy);
-    }
+    // Start pre-generating the next floor while this one is played
+    beginLevelGeneration(floorNumber + 1);
     
     // Change the game state to playing
     currentState = GameState::PLAYING;
-    std::cout << "Game started!" << std::endl;
+    LOG_INFO(GENERAL, "Game started!");
+}
+
+void GameLoop::beginLevelGeneration(int floor) {
+    // Note: replacing a job that is still running waits for it to finish
+    levelJob = LevelGenerationJob::start(LEVEL_WIDTH, LEVEL_HEIGHT, floor, getFloorSeed(floor), levelCacheDirectory);
+}
+
+unsigned int GameLoop::getFloorSeed(int floor) const {
+    // Every floor of a run derives its layout from the world seed
+    return worldSeed + static_cast<unsigned int>(floor) * 2654435761u;
+}
+
+void GameLoop::renderLoading() {
+    AllocationScope uiScope(AllocationTag::UI);
+    
+    // Simple loading bar driven by the generation progress
+    FrameVector<Vertex> vertices = uiSystem->createHealthBar(-0.4f, -0.02f, 0.8f, 0.04f, levelJob.getProgress());
+    
+    if (renderer) {
+        renderer->updateVertexBuffer(vertices);
+    }
+    vulkanRenderer->render();
+}
+
+void GameLoop::advanceFloor() {
+    AllocationScope levelScope(AllocationTag::LEVEL);
+    
+    // Swap the prefetched floor in between frames
+    currentLevel->removeCharacter(playerHandle);
+    floorNumber = levelJob.getFloorNumber();
+    currentLevel = levelJob.take();
+    currentLevel->setWorkerThreads(std::thread::hardware_concurrency());
+    currentLevel->setDeterministic(isDeterministic());
+    effectManager.clear();
+    placePlayerAtStart();
+    LOG_INFO(LEVEL, "Descended to floor {}", floorNumber);
+    
+    beginLevelGeneration(floorNumber + 1);
+}
+
+void GameLoop::placePlayerAtStart() {
+    int x = currentLevel->getPlayerStartX();
+    int y = currentLevel->getPlayerStartY();
+    player->move(static_cast<float>(x), static_cast<float>(y));
+    playerHandle = currentLevel->addCharacter(player.get());
+    LOG_DEBUG(LEVEL, "Placed player at starting position: ({}, {})", x, y);
+}
+
+void GameLoop::startRecording() {
+    ReplayConfig config;
+    config.worldSeed = worldSeed;
+    config.playerClass = player->getClass();
+    config.tickRate = static_cast<uint32_t>(TICK_RATE);
+    config.checksumInterval = CHECKSUM_INTERVAL;
+    config.levelWidth = LEVEL_WIDTH;
+    config.levelHeight = LEVEL_HEIGHT;
+    recorder.begin(config);
+    LOG_INFO(ENGINE, "Recording to {}", recordPath);
+}
+
+void GameLoop::stopRecording() {
+    if (recorder.isRecording()) {
+        recorder.save(recordPath);
+        // Only the first game of a session is recorded
+        recordPath.clear();
+    }
+}
+
+bool GameLoop::loadReplay(const std::string& path) {
+    if (!replayPlayer.load(path)) {
+        return false;
+    }
+    
+    // The recording is only valid for the simulation it was made with
+    const ReplayConfig& config = replayPlayer.getConfig();
+    if (config.tickRate != static_cast<uint32_t>(TICK_RATE) || config.levelWidth != LEVEL_WIDTH ||
+        config.levelHeight != LEVEL_HEIGHT) {
+        std::cerr << "Replay was recorded with different game settings: " << path << std::endl;
+        replayPlayer = ReplayPlayer();
+        return false;
+    }
+    LOG_INFO(ENGINE, "Loaded replay {}: {} ticks, seed {}", path, replayPlayer.getTickCount(), config.worldSeed);
+    return true;
+}
+
+void GameLoop::startReplayedGame() {
+    const ReplayConfig& config = replayPlayer.getConfig();
+    replaying = true;
+    worldSeed = config.worldSeed;
+    createPlayerCharacter(config.playerClass);
+    
+    // take() in startGame waits for the floor to finish generating
+    beginLevelGeneration(1);
+    startGame();
+}
+
+void GameLoop::finishReplay() {
+    if (!replaying) {
+        return;
+    }
+    replaying = false;
+    
+    LOG_INFO(ENGINE, "Replay finished after {} of {} ticks, {} checksum mismatches", replayPlayer.getTick(),
+             replayPlayer.getTickCount(), replayPlayer.getDivergenceCount());
+    if (!replayPlayer.isFinished()) {
+        LOG_ERROR(ENGINE, "Replay ended early: the game was over at tick {}", replayPlayer.getTick());
+    }
+    if (window) {
+        glfwSetWindowShouldClose(window, true);
+    }
+}
+
+bool GameLoop::runHeadlessReplay() {
+    if (!replayPlayer.isLoaded()) {
+        std::cerr << "No replay loaded" << std::endl;
+        return false;
+    }
+    
+    startReplayedGame();
+    
+    // No window, renderer or frame pacing: ticks run back to back
+    auto startTime = std::chrono::high_resolution_clock::now();
+    while (replaying) {
+        FrameArena::get().beginFrame();
+        tick();
+    }
+    float seconds = std::chrono::duration<float, std::chrono::seconds::period>(
+        std::chrono::high_resolution_clock::now() - startTime).count();
+    
+    LOG_INFO(ENGINE, "Replayed {} ticks in {} s ({} ticks per second)", replayPlayer.getTick(), seconds,
+             seconds > 0.0f ? replayPlayer.getTick() / seconds : 0.0f);
+    return replayPlayer.isFinished() && replayPlayer.getDivergenceCount() == 0;
 }
 
 void GameLoop::run() {
     try {
-        std::cout << "Starting GameLoop::run..." << std::endl;
+        LOG_INFO(ENGINE, "Starting GameLoop::run...");
         
         if (!initialize()) {
             std::cerr << "Failed to initialize game loop" << std::endl;
             return;
         }
         
-        // Set the initial game state to character selection
-        currentState = GameState::CHARACTER_SELECT;
-        characterSelectScreen = std::make_unique<CharacterSelectScreen>(uiSystem.get());
-        std::cout << "Character selection screen initialized" << std::endl;
+        if (replayPlayer.isLoaded()) {
+            // A replay skips the menus; the recording says which class and seed to start with
+            startReplayedGame();
+        } else {
+            // Set the initial game state to character selection
+            currentState = GameState::CHARACTER_SELECT;
+            characterSelectScreen = std::make_unique<CharacterSelectScreen>(uiSystem.get());
+            LOG_INFO(UI, "Character selection screen initialized");
+            
+            // Generate the first floor while the player picks a class
+            beginLevelGeneration(1);
+        }
         
-        std::cout << "Starting game loop" << std::endl;
+        LOG_INFO(ENGINE, "Starting game loop");
         
         auto lastTime = std::chrono::high_resolution_clock::now();
         
         // Skip initial animation frames and go straight to the main game loop
-        std::cout << "Starting main game loop..." << std::endl;
+        LOG_INFO(ENGINE, "Starting main game loop...");
         
         // Display a message in the console
-        std::cout << "\nWindow is now open. Close the window or press ESC to exit." << std::endl;
+        LOG_INFO(ENGINE, "Window is now open. Close the window or press ESC to exit.");
         
         // FPS counter variables
         int frameCount = 0;
@@ -614,6 +800,16 @@ void GameLoop::run() {
             // Start frame timing
             auto frameStart = std::chrono::high_resolution_clock::now();
             
+            // Per-frame containers from two frames ago are no longer referenced
+            FrameArena& frameArena = FrameArena::get();
+            frameArena.beginFrame();
+            
+            // Close the previous frame's allocation counts; the allocation test aborts here if over budget
+            AllocationTracker& allocationTracker = AllocationTracker::get();
+            if (AllocationTracker::ENABLED) {
+                allocationTracker.endFrame();
+            }
+            
             // Calculate delta time
             auto currentTime = std::chrono::high_resolution_clock::now();
             float deltaTime = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - lastTime).count();
@@ -633,19 +829,34 @@ void GameLoop::run() {
                 frameCount = 0;
                 fpsTimer = 0.0f;
                 
-                // Update window title with FPS
-                std::string title = std::string(WINDOW_TITLE) + " - FPS: " + std::to_string(static_cast<int>(fps));
-                glfwSetWindowTitle(window, title.c_str());
+                // Update window title with FPS and the most frame memory used so far
+                char title[128];
+                std::snprintf(title, sizeof(title), "%s - FPS: %d - Frame memory: %zu KB (%zu overflows)", WINDOW_TITLE,
+                              static_cast<int>(fps), frameArena.getHighWaterMark() / 1024, frameArena.getOverflowCount());
+                glfwSetWindowTitle(window, title);
+                
+                if (AllocationTracker::ENABLED) {
+                    allocationTracker.logReport();
+                }
             }
             
-            // Poll for events
+            // Poll for events; the callbacks queue them and beginFrame folds them into this frame's state
             glfwPollEvents();
+            input.beginFrame();
             
-            // Process input
-            processInput();
+            // Quit is read from the keyboard even during a replay
+            if (input.isDown(InputAction::QUIT)) {
+                glfwSetWindowShouldClose(window, true);
+            }
             
-            // Update game state - ensure this runs regardless of input
-            update(deltaTime);
+            // Advance the game in fixed ticks; a press waits for the next tick rather than being lost
+            // on a frame that runs none
+            pendingPressed |= input.getActionsPressed();
+            tickAccumulator += deltaTime;
+            while (tickAccumulator >= TICK_SECONDS) {
+                tickAccumulator -= TICK_SECONDS;
+                tick();
+            }
             
             // Render the game
             render();
@@ -660,10 +871,13 @@ void GameLoop::run() {
             }
         }
         
-        std::cout << "Window closed, waiting for device to finish operations..." << std::endl;
+        // Keep what was played so far if the window closed mid-game
+        stopRecording();
+        
+        LOG_INFO(ENGINE, "Window closed, waiting for device to finish operations...");
         // Wait for the device to finish operations before cleanup
         vkDeviceWaitIdle(vulkanRenderer->getDevice());
-        std::cout << "Device operations finished" << std::endl;
+        LOG_INFO(ENGINE, "Device operations finished");
     } catch (const std::exception& e) {
         std::cerr << "Exception in GameLoop::run: " << e.what() << std::endl;
     } catch (...) {
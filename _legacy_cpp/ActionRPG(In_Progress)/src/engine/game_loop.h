@@ -3,21 +3,25 @@
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
 #include "vulkan_renderer.h"
+#include "input.h"
+#include "replay.h"
 #include "renderer.h"
 #include "../game/character.h"
 #include "../game/level.h"
+#include "../game/level_generator.h"
 #include "../game/visual_effect.h"
 #include "../ui/character_select.h"
 #include "../ui/inventory_ui.h"
 #include "../game/item.h"
 #include "../engine/renderer.h"
 #include "../ui/ui_system.h"
-#include <map>
 #include <memory>
+#include <string>
 
 // Game states
 enum class GameState {
     CHARACTER_SELECT,
+    LOADING,
     PLAYING,
     GAME_OVER,
     PAUSE_MENU
@@ -30,10 +34,20 @@ public:
     
     void run();
     
+    // Record the first game of the session to a replay file, written on game over or exit
+    void setRecordPath(const std::string& path) { recordPath = path; }
+    // Play a recording instead of taking keyboard input; run() then renders it in real time
+    bool loadReplay(const std::string& path);
+    // Play the loaded recording without a window, as fast as possible; false if it diverged
+    bool runHeadlessReplay();
+    // Save generated floors in this directory and reuse them for the same seed; off when empty
+    void setLevelCacheDirectory(const std::string& directory) { levelCacheDirectory = directory; }
+    
 private:
     VulkanRenderer* vulkanRenderer;
     std::unique_ptr<Renderer> renderer;
     GLFWwindow* window;
+    Input input;
     
     // Game state management
     GameState currentState;
@@ -44,13 +58,30 @@ private:
     // Game objects
     std::shared_ptr<Character> player;
     std::shared_ptr<Level> currentLevel;
+    CharacterHandle playerHandle; // The player's handle in currentLevel
     VisualEffectManager effectManager;
     
+    // Background level generation: the first floor is generated while the
+    // player is still choosing a class, and the next floor during play
+    LevelGenerationJob levelJob;
+    unsigned int worldSeed;
+    int floorNumber = 0;
+    std::string levelCacheDirectory;
+    
+    // The simulation advances in fixed ticks, so a recorded session replays exactly
+    float tickAccumulator = 0.0f;
+    ActionMask pendingPressed = 0; // Presses since the last tick, held until one runs
+    std::string recordPath;
+    ReplayRecorder recorder;
+    ReplayPlayer replayPlayer;
+    bool replaying = false;
+    
     bool initialize();
     void cleanup();
     void processInput();
     void update(float deltaTime);
     void render();
+    void tick();
     
     // Game state methods
     void updateCharacterSelect(float deltaTime);
@@ -59,20 +90,36 @@ private:
     void createPlayerCharacter(CharacterClass characterClass);
     void startGame();
     
+    // Level streaming
+    void beginLevelGeneration(int floor);
+    void renderLoading();
+    void advanceFloor();
+    void placePlayerAtStart();
+    unsigned int getFloorSeed(int floor) const;
+    
+    // Recording and replay
+    bool isDeterministic() const { return replaying || recorder.isRecording(); }
+    void startRecording();
+    void stopRecording();
+    void startReplayedGame();
+    void finishReplay();
+    
     // Input handling
     void handlePlayerMovement(float deltaTime);
     void handlePlayerActions();
-    // Helper for input state
-    std::map<int, bool> previousKeyStates;
-    bool isKeyJustPressed(int key);
     
     const int WIDTH = 800;
     const int HEIGHT = 600;
     const char* WINDOW_TITLE = "Action RPG";
+    const int LEVEL_WIDTH = 100;
+    const int LEVEL_HEIGHT = 100;
     
     // Constants
     const float PLAYER_SPEED = 1.0f; // Reduced for grid-based movement
     const float MOVEMENT_COOLDOWN = 0.1f; // Reduced for more responsive controls
+    const int TICK_RATE = 60; // Simulation ticks per second
+    const float TICK_SECONDS = 1.0f / TICK_RATE;
+    const uint32_t CHECKSUM_INTERVAL = 60; // Ticks between world checksums in recordings
     
     // Movement state
     float movementTimer = 0.0f;
@@ -0,0 +1,236 @@
+#include "input.h"
+
+Input::Input() {
+    setDefaultBindings();
+}
+
+Input::~Input() {
+    detach();
+}
+
+void Input::attach(GLFWwindow* newWindow) {
+    detach();
+    window = newWindow;
+    glfwSetWindowUserPointer(window, this);
+    glfwSetKeyCallback(window, keyCallback);
+    glfwSetWindowFocusCallback(window, focusCallback);
+}
+
+void Input::detach() {
+    if (!window) {
+        return;
+    }
+    glfwSetKeyCallback(window, nullptr);
+    glfwSetWindowFocusCallback(window, nullptr);
+    glfwSetWindowUserPointer(window, nullptr);
+    window = nullptr;
+}
+
+void Input::keyCallback(GLFWwindow* window, int key, int, int action, int) {
+    Input* input = static_cast<Input*>(glfwGetWindowUserPointer(window));
+    if (!input || action == GLFW_REPEAT) {
+        return;
+    }
+    input->pushKeyEvent(key, action == GLFW_PRESS);
+}
+
+void Input::focusCallback(GLFWwindow* window, int focused) {
+    Input* input = static_cast<Input*>(glfwGetWindowUserPointer(window));
+    if (input && !focused) {
+        input->pushReleaseAll();
+    }
+}
+
+void Input::pushKeyEvent(int key, bool pressed) {
+    if (isValidKey(key)) {
+        pushEvent(pressed ? EventType::PRESS : EventType::RELEASE, key);
+    }
+}
+
+void Input::pushReleaseAll() {
+    pushEvent(EventType::RELEASE_ALL, 0);
+}
+
+void Input::pushEvent(EventType type, int key) {
+    uint32_t tail = eventTail.load(std::memory_order_relaxed);
+    if (tail - eventHead.load(std::memory_order_acquire) >= EVENT_CAPACITY) {
+        // A lost release would leave a key stuck down, so the consumer re-polls
+        droppedEvents.fetch_add(1, std::memory_order_relaxed);
+        overflowed.store(true, std::memory_order_release);
+        return;
+    }
+
+    Event& event = events[tail & (EVENT_CAPACITY - 1)];
+    event.key = static_cast<int16_t>(key);
+    event.type = type;
+    eventTail.store(tail + 1, std::memory_order_release);
+}
+
+void Input::beginFrame() {
+    keysPressed.reset();
+    keysReleased.reset();
+
+    uint32_t head = eventHead.load(std::memory_order_relaxed);
+    uint32_t tail = eventTail.load(std::memory_order_acquire);
+    for (; head != tail; head++) {
+        applyEvent(events[head & (EVENT_CAPACITY - 1)]);
+    }
+    eventHead.store(head, std::memory_order_release);
+
+    if (overflowed.exchange(false, std::memory_order_acquire)) {
+        pollKeys();
+    }
+
+    ActionMask previouslyDown = actionsDown;
+    actionsDown = evaluate(keysDown);
+    actionsPressed = evaluate(keysPressed);
+    // An action stays down while any of its keys is, so only report it released once all are up
+    actionsReleased = evaluate(keysReleased) & previouslyDown & ~actionsDown;
+}
+
+void Input::applyEvent(const Event& event) {
+    switch (event.type) {
+        case EventType::PRESS:
+            keysDown.set(event.key);
+            keysPressed.set(event.key);
+            break;
+        case EventType::RELEASE:
+            // Released keys that were never seen going down (held at startup) are ignored
+            if (keysDown.test(event.key)) {
+                keysDown.reset(event.key);
+                keysReleased.set(event.key);
+            }
+            break;
+        case EventType::RELEASE_ALL:
+            keysReleased |= keysDown;
+            keysDown.reset();
+            break;
+    }
+}
+
+void Input::pollKeys() {
+    if (!window) {
+        return;
+    }
+    for (int key = 0; key < KEY_COUNT; key++) {
+        if (!boundKeys.test(key)) {
+            continue;
+        }
+        bool down = glfwGetKey(window, key) == GLFW_PRESS;
+        if (down && !keysDown.test(key)) {
+            keysPressed.set(key);
+        } else if (!down && keysDown.test(key)) {
+            keysReleased.set(key);
+        }
+        keysDown.set(key, down);
+    }
+}
+
+ActionMask Input::evaluate(const KeySet& keys) const {
+    ActionMask mask = 0;
+    if (keys.none()) {
+        return mask;
+    }
+    for (int i = 0; i < ACTION_COUNT; i++) {
+        if ((keys & bindings[i]).any()) {
+            mask |= ActionMask(1) << i;
+        }
+    }
+    return mask;
+}
+
+void Input::bind(InputAction action, int key) {
+    if (isValidKey(key)) {
+        bindings[static_cast<int>(action)].set(key);
+        boundKeys.set(key);
+    }
+}
+
+void Input::clearBindings(InputAction action) {
+    bindings[static_cast<int>(action)].reset();
+    boundKeys.reset();
+    for (const KeySet& keys : bindings) {
+        boundKeys |= keys;
+    }
+}
+
+void Input::setDefaultBindings() {
+    for (int i = 0; i < ACTION_COUNT; i++) {
+        bindings[i].reset();
+    }
+    boundKeys.reset();
+
+    // Movement: WASD and the arrow keys
+    bind(InputAction::MOVE_UP, GLFW_KEY_W);
+    bind(InputAction::MOVE_UP, GLFW_KEY_UP);
+    bind(InputAction::MOVE_DOWN, GLFW_KEY_S);
+    bind(InputAction::MOVE_DOWN, GLFW_KEY_DOWN);
+    bind(InputAction::MOVE_LEFT, GLFW_KEY_A);
+    bind(InputAction::MOVE_LEFT, GLFW_KEY_LEFT);
+    bind(InputAction::MOVE_RIGHT, GLFW_KEY_D);
+    bind(InputAction::MOVE_RIGHT, GLFW_KEY_RIGHT);
+
+    bind(InputAction::ATTACK, GLFW_KEY_SPACE);
+    bind(InputAction::PICK_UP, GLFW_KEY_E);
+    bind(InputAction::USE_POTION, GLFW_KEY_H);
+    bind(InputAction::TOGGLE_INVENTORY, GLFW_KEY_I);
+
+    // Menus and the inventory
+    bind(InputAction::MENU_UP, GLFW_KEY_UP);
+    bind(InputAction::MENU_DOWN, GLFW_KEY_DOWN);
+    bind(InputAction::MENU_LEFT, GLFW_KEY_LEFT);
+    bind(InputAction::MENU_LEFT, GLFW_KEY_A);
+    bind(InputAction::MENU_RIGHT, GLFW_KEY_RIGHT);
+    bind(InputAction::MENU_RIGHT, GLFW_KEY_D);
+    bind(InputAction::CONFIRM, GLFW_KEY_ENTER);
+    bind(InputAction::CONFIRM, GLFW_KEY_SPACE);
+    bind(InputAction::USE_ITEM, GLFW_KEY_E);
+    bind(InputAction::DROP_ITEM, GLFW_KEY_Q);
+
+    bind(InputAction::RESTART, GLFW_KEY_R);
+    bind(InputAction::UNPAUSE, GLFW_KEY_P);
+    bind(InputAction::QUIT, GLFW_KEY_ESCAPE);
+}
+
+const char* Input::getActionName(InputAction action) {
+    switch (action) {
+        case InputAction::MOVE_UP:
+            return "move_up";
+        case InputAction::MOVE_DOWN:
+            return "move_down";
+        case InputAction::MOVE_LEFT:
+            return "move_left";
+        case InputAction::MOVE_RIGHT:
+            return "move_right";
+        case InputAction::ATTACK:
+            return "attack";
+        case InputAction::PICK_UP:
+            return "pick_up";
+        case InputAction::USE_POTION:
+            return "use_potion";
+        case InputAction::TOGGLE_INVENTORY:
+            return "toggle_inventory";
+        case InputAction::MENU_UP:
+            return "menu_up";
+        case InputAction::MENU_DOWN:
+            return "menu_down";
+        case InputAction::MENU_LEFT:
+            return "menu_left";
+        case InputAction::MENU_RIGHT:
+            return "menu_right";
+        case InputAction::CONFIRM:
+            return "confirm";
+        case InputAction::USE_ITEM:
+            return "use_item";
+        case InputAction::DROP_ITEM:
+            return "drop_item";
+        case InputAction::RESTART:
+            return "restart";
+        case InputAction::UNPAUSE:
+            return "unpause";
+        case InputAction::QUIT:
+            return "quit";
+        default:
+            return "?";
+    }
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <GLFW/glfw3.h>
+#include <atomic>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+
+// What the game responds to; keys are bound to actions rather than tested directly
+enum class InputAction : uint8_t {
+    MOVE_UP,
+    MOVE_DOWN,
+    MOVE_LEFT,
+    MOVE_RIGHT,
+    ATTACK,
+    PICK_UP,
+    USE_POTION,
+    TOGGLE_INVENTORY,
+    MENU_UP,
+    MENU_DOWN,
+    MENU_LEFT,
+    MENU_RIGHT,
+    CONFIRM,
+    USE_ITEM,
+    DROP_ITEM,
+    RESTART,
+    UNPAUSE,
+    QUIT,
+    COUNT
+};
+
+// One bit per InputAction
+using ActionMask = uint32_t;
+
+// Keyboard input fed by GLFW callbacks. The key callback only pushes the event
+// into a single-producer ring buffer; beginFrame() drains it once per frame into
+// a key bitset and per-frame pressed/released edges, then ORs each action's bound
+// keys into action masks. Queries after that are a bit test, and a press and
+// release between two frames still registers as a press.
+class Input {
+public:
+    Input();
+    ~Input();
+    Input(const Input&) = delete;
+    Input& operator=(const Input&) = delete;
+
+    // Installs the key and focus callbacks on the window; one Input per window
+    void attach(GLFWwindow* window);
+    void detach();
+
+    // Call once per frame after glfwPollEvents
+    void beginFrame();
+
+    bool isDown(InputAction action) const { return (actionsDown & getActionBit(action)) != 0; }
+    bool wasPressed(InputAction action) const { return (actionsPressed & getActionBit(action)) != 0; }
+    bool wasReleased(InputAction action) const { return (actionsReleased & getActionBit(action)) != 0; }
+    ActionMask getActionsDown() const { return actionsDown; }
+    ActionMask getActionsPressed() const { return actionsPressed; }
+    ActionMask getActionsReleased() const { return actionsReleased; }
+
+    // Overrides the actions seen until the next beginFrame; used to feed fixed ticks and replays
+    void setActions(ActionMask down, ActionMask pressed) {
+        actionsReleased = actionsDown & ~down;
+        actionsDown = down;
+        actionsPressed = pressed;
+    }
+
+    bool isKeyDown(int key) const { return isValidKey(key) && keysDown.test(key); }
+    bool wasKeyPressed(int key) const { return isValidKey(key) && keysPressed.test(key); }
+
+    // Action mapping; an action can have several keys and a key several actions
+    void bind(InputAction action, int key);
+    void clearBindings(InputAction action);
+    void setDefaultBindings();
+
+    // Events lost to a full buffer; key state is re-polled when that happens
+    size_t getDroppedEventCount() const { return droppedEvents.load(std::memory_order_relaxed); }
+
+    // The producer side, called from the GLFW callbacks
+    void pushKeyEvent(int key, bool pressed);
+    void pushReleaseAll();
+
+    static ActionMask getActionBit(InputAction action) { return ActionMask(1) << static_cast<int>(action); }
+    static const char* getActionName(InputAction action);
+
+    // Constants
+    static constexpr int KEY_COUNT = GLFW_KEY_LAST + 1;
+    static constexpr int ACTION_COUNT = static_cast<int>(InputAction::COUNT);
+    static constexpr uint32_t EVENT_CAPACITY = 256; // Power of two
+
+private:
+    using KeySet = std::bitset<KEY_COUNT>;
+
+    enum class EventType : uint8_t {
+        PRESS,
+        RELEASE,
+        RELEASE_ALL // Focus lost; the window won't see the releases
+    };
+
+    struct Event {
+        int16_t key = 0;
+        EventType type = EventType::PRESS;
+    };
+
+    static void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
+    static void focusCallback(GLFWwindow* window, int focused);
+    static bool isValidKey(int key) { return key >= 0 && key < KEY_COUNT; }
+
+    void pushEvent(EventType type, int key);
+    void applyEvent(const Event& event);
+    void pollKeys();
+    ActionMask evaluate(const KeySet& keys) const;
+
+    GLFWwindow* window = nullptr;
+
+    // Single producer (the callbacks), single consumer (beginFrame)
+    Event events[EVENT_CAPACITY];
+    std::atomic<uint32_t> eventHead{0}; // Next event to read
+    std::atomic<uint32_t> eventTail{0}; // Next event to write
+    std::atomic<size_t> droppedEvents{0};
+    std::atomic<bool> overflowed{false};
+
+    KeySet keysDown;
+    KeySet keysPressed;  // Went down this frame
+    KeySet keysReleased; // Went up this frame
+    KeySet bindings[ACTION_COUNT];
+    KeySet boundKeys; // Union of the bindings
+
+    ActionMask actionsDown = 0;
+    ActionMask actionsPressed = 0;
+    ActionMask actionsReleased = 0;
+};
+
+static_assert(Input::ACTION_COUNT <= 32, "ActionMask has one bit per action");
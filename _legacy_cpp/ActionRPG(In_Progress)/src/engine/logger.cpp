@@ -0,0 +1,302 @@
+#include "logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace {
+    int64_t nowNanoseconds() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+Logger::Logger() : startTime(nowNanoseconds()) {
+    setLevel(static_cast<LogLevel>(std::min(LOG_MIN_LEVEL, static_cast<int>(LogLevel::NONE))));
+    writer = std::thread(&Logger::writerLoop, this);
+}
+
+Logger::~Logger() {
+    running.store(false, std::memory_order_release);
+    writer.join();
+    drain();
+
+    ThreadQueue* queue = queues.load(std::memory_order_acquire);
+    while (queue) {
+        ThreadQueue* next = queue->next;
+        delete queue;
+        queue = next;
+    }
+}
+
+Logger& Logger::get() {
+    static Logger logger;
+    return logger;
+}
+
+void Logger::setLevel(LogCategory category, LogLevel level) {
+    levels[static_cast<int>(category)].store(level, std::memory_order_relaxed);
+}
+
+void Logger::setLevel(LogLevel level) {
+    for (auto& categoryLevel : levels) {
+        categoryLevel.store(level, std::memory_order_relaxed);
+    }
+}
+
+const char* Logger::getLevelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::TRACE:
+            return "TRACE";
+        case LogLevel::DEBUG:
+            return "DEBUG";
+        case LogLevel::INFO:
+            return "INFO";
+        case LogLevel::WARN:
+            return "WARN";
+        case LogLevel::ERR:
+            return "ERROR";
+        default:
+            return "?";
+    }
+}
+
+const char* Logger::getCategoryName(LogCategory category) {
+    switch (category) {
+        case LogCategory::GENERAL:
+            return "general";
+        case LogCategory::ENGINE:
+            return "engine";
+        case LogCategory::RENDER:
+            return "render";
+        case LogCategory::INPUT:
+            return "input";
+        case LogCategory::LEVEL:
+            return "level";
+        case LogCategory::AI:
+            return "ai";
+        case LogCategory::COMBAT:
+            return "combat";
+        case LogCategory::ITEMS:
+            return "items";
+        case LogCategory::UI:
+            return "ui";
+        default:
+            return "?";
+    }
+}
+
+void Logger::flush() {
+    drain();
+}
+
+Logger::ThreadQueue* Logger::getThreadQueue() {
+    // Created on a thread's first message; retired when the thread exits so the writer can free it
+    struct Owner {
+        ThreadQueue* queue = nullptr;
+        ~Owner() {
+            if (queue) {
+                queue->retired.store(true, std::memory_order_release);
+            }
+        }
+    };
+    static thread_local Owner owner;
+
+    if (!owner.queue) {
+        ThreadQueue* queue = new ThreadQueue();
+        queue->next = queues.load(std::memory_order_relaxed);
+        while (!queues.compare_exchange_weak(queue->next, queue, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+        owner.queue = queue;
+    }
+    return owner.queue;
+}
+
+Logger::Record* Logger::beginRecord() {
+    ThreadQueue* queue = getThreadQueue();
+    uint64_t tail = queue->tail.load(std::memory_order_relaxed);
+    if (tail - queue->head.load(std::memory_order_acquire) >= QUEUE_CAPACITY) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Record& record = queue->records[tail & (QUEUE_CAPACITY - 1)];
+    record.sequence = nextSequence.fetch_add(1, std::memory_order_relaxed);
+    record.time = static_cast<uint64_t>(nowNanoseconds() - startTime);
+    record.truncated = false;
+    record.payloadSize = 0;
+    return &record;
+}
+
+void Logger::commitRecord() {
+    // Publishes the record to the writer
+    ThreadQueue* queue = getThreadQueue();
+    queue->tail.store(queue->tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void Logger::append(Record& record, ArgumentType type, const void* data, size_t size) {
+    if (record.truncated || record.payloadSize + 1 + size > PAYLOAD_CAPACITY) {
+        record.truncated = true;
+        return;
+    }
+    record.payload[record.payloadSize++] = static_cast<unsigned char>(type);
+    std::memcpy(record.payload + record.payloadSize, data, size);
+    record.payloadSize = static_cast<uint16_t>(record.payloadSize + size);
+}
+
+void Logger::appendString(Record& record, std::string_view value) {
+    // Type, 16-bit length, then as much of the text as fits
+    const size_t header = 1 + sizeof(uint16_t);
+    if (record.truncated || record.payloadSize + header > PAYLOAD_CAPACITY) {
+        record.truncated = true;
+        return;
+    }
+    size_t available = PAYLOAD_CAPACITY - record.payloadSize - header;
+    uint16_t length = static_cast<uint16_t>(std::min(value.size(), available));
+
+    record.payload[record.payloadSize++] = static_cast<unsigned char>(ArgumentType::STRING);
+    std::memcpy(record.payload + record.payloadSize, &length, sizeof(length));
+    std::memcpy(record.payload + record.payloadSize + sizeof(length), value.data(), length);
+    record.payloadSize = static_cast<uint16_t>(record.payloadSize + sizeof(length) + length);
+    if (length < value.size()) {
+        record.truncated = true;
+    }
+}
+
+void Logger::writerLoop() {
+    while (running.load(std::memory_order_acquire)) {
+        drain();
+        std::this_thread::sleep_for(std::chrono::milliseconds(WRITER_INTERVAL_MILLISECONDS));
+    }
+}
+
+void Logger::drain() {
+    std::lock_guard<std::mutex> lock(drainMutex);
+    batch.clear();
+
+    ThreadQueue* previous = nullptr;
+    ThreadQueue* queue = queues.load(std::memory_order_acquire);
+    while (queue) {
+        // Checked before the tail, so the last records of an exited thread are taken with it
+        bool retired = queue->retired.load(std::memory_order_acquire);
+        uint64_t head = queue->head.load(std::memory_order_relaxed);
+        uint64_t tail = queue->tail.load(std::memory_order_acquire);
+        for (; head < tail; head++) {
+            batch.push_back(queue->records[head & (QUEUE_CAPACITY - 1)]);
+        }
+        queue->head.store(head, std::memory_order_release);
+
+        // New queues are pushed at the front, so only ones behind it can be unlinked safely
+        ThreadQueue* next = queue->next;
+        if (retired && previous) {
+            previous->next = next;
+            delete queue;
+        } else {
+            previous = queue;
+        }
+        queue = next;
+    }
+
+    // Each thread's records are in order; interleave the threads by when they logged
+    std::sort(batch.begin(), batch.end(),
+              [](const Record& a, const Record& b) { return a.sequence < b.sequence; });
+
+    output.clear();
+    errors.clear();
+    for (const Record& record : batch) {
+        format(record, record.level >= LogLevel::WARN ? errors : output);
+    }
+    size_t droppedNow = dropped.load(std::memory_order_relaxed);
+    if (droppedNow != reportedDropped) {
+        errors += std::to_string(droppedNow - reportedDropped) + " log messages dropped\n";
+        reportedDropped = droppedNow;
+    }
+
+    // One write and one flush per batch
+    if (!output.empty()) {
+        std::cout.write(output.data(), static_cast<std::streamsize>(output.size()));
+        std::cout.flush();
+    }
+    if (!errors.empty()) {
+        std::cerr.write(errors.data(), static_cast<std::streamsize>(errors.size()));
+        std::cerr.flush();
+    }
+}
+
+void Logger::format(const Record& record, std::string& out) const {
+    char number[64];
+    std::snprintf(number, sizeof(number), "[%10.3f] %-5s %-7s ", static_cast<double>(record.time) * 1e-9,
+                  getLevelName(record.level), getCategoryName(record.category));
+    out += number;
+
+    // Substitute the arguments, in order, for the {} placeholders
+    size_t offset = 0;
+    for (const char* c = record.format; *c; c++) {
+        if (c[0] != '{' || c[1] != '}') {
+            out += *c;
+            continue;
+        }
+        c++;
+        if (offset >= record.payloadSize) {
+            out += "{}";
+            continue;
+        }
+
+        ArgumentType type = static_cast<ArgumentType>(record.payload[offset++]);
+        const unsigned char* data = record.payload + offset;
+        switch (type) {
+            case ArgumentType::INT: {
+                int64_t value;
+                std::memcpy(&value, data, sizeof(value));
+                std::snprintf(number, sizeof(number), "%" PRId64, value);
+                out += number;
+                offset += sizeof(value);
+                break;
+            }
+            case ArgumentType::UINT: {
+                uint64_t value;
+                std::memcpy(&value, data, sizeof(value));
+                std::snprintf(number, sizeof(number), "%" PRIu64, value);
+                out += number;
+                offset += sizeof(value);
+                break;
+            }
+            case ArgumentType::FLOAT: {
+                double value;
+                std::memcpy(&value, data, sizeof(value));
+                std::snprintf(number, sizeof(number), "%g", value);
+                out += number;
+                offset += sizeof(value);
+                break;
+            }
+            case ArgumentType::BOOL: {
+                bool value;
+                std::memcpy(&value, data, sizeof(value));
+                out += value ? "true" : "false";
+                offset += sizeof(value);
+                break;
+            }
+            case ArgumentType::STRING: {
+                uint16_t length;
+                std::memcpy(&length, data, sizeof(length));
+                out.append(reinterpret_cast<const char*>(data + sizeof(length)), length);
+                offset += sizeof(length) + length;
+                break;
+            }
+            case ArgumentType::POINTER: {
+                uint64_t value;
+                std::memcpy(&value, data, sizeof(value));
+                std::snprintf(number, sizeof(number), "0x%" PRIx64, value);
+                out += number;
+                offset += sizeof(value);
+                break;
+            }
+        }
+    }
+    if (record.truncated) {
+        out += " [truncated]";
+    }
+    out += '\n';
+}
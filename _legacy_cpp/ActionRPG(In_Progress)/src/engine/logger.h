@@ -0,0 +1,217 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Build-time threshold: LOG_* macros below it compile to nothing, arguments and all.
+// 0 trace, 1 debug, 2 info, 3 warnings, 4 errors, 5 silent.
+#ifndef LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define LOG_MIN_LEVEL 2
+#else
+#define LOG_MIN_LEVEL 1
+#endif
+#endif
+
+enum class LogLevel : uint8_t {
+    TRACE,
+    DEBUG,
+    INFO,
+    WARN,
+    ERR,
+    NONE
+};
+
+// What a message is about; each category has its own runtime level
+enum class LogCategory : uint8_t {
+    GENERAL,
+    ENGINE,
+    RENDER,
+    INPUT,
+    LEVEL,
+    AI,
+    COMBAT,
+    ITEMS,
+    UI,
+    COUNT
+};
+
+// Asynchronous logger. A call copies the format string pointer and the raw
+// argument values into a fixed-size record in the calling thread's own ring
+// buffer: no locks, no formatting, and no allocation after the thread's first
+// message. A background writer drains every thread's buffer a few times per
+// frame, formats the records in the order they were made and writes them in
+// one batch, flushing once. Warnings and errors go to stderr, the rest to stdout.
+//
+// Formats use {} placeholders and must be string literals, since only the
+// pointer is kept. Arguments may be integers, floats, bools, enums, strings
+// (copied, truncated to fit the record) and pointers. When a thread's buffer
+// is full its records are dropped and counted rather than blocking the game.
+class Logger {
+public:
+    static Logger& get();
+
+    bool isEnabled(LogLevel level, LogCategory category) const {
+        return level >= levels[static_cast<int>(category)].load(std::memory_order_relaxed);
+    }
+    void setLevel(LogCategory category, LogLevel level);
+    void setLevel(LogLevel level);
+
+    template <typename... Args>
+    void write(LogLevel level, LogCategory category, const char* format, const Args&... args) {
+        if (!isEnabled(level, category)) {
+            return;
+        }
+        Record* record = beginRecord();
+        if (!record) {
+            return;
+        }
+        record->level = level;
+        record->category = category;
+        record->format = format;
+        (encode(*record, args), ...);
+        commitRecord();
+    }
+
+    // Blocks until everything logged before the call has been written
+    void flush();
+    // Records lost to full buffers
+    size_t getDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+    static const char* getLevelName(LogLevel level);
+    static const char* getCategoryName(LogCategory category);
+
+    // Constants
+    static constexpr size_t QUEUE_CAPACITY = 1024;  // Records per thread; power of two
+    static constexpr size_t PAYLOAD_CAPACITY = 192; // Bytes of argument data per record
+    static constexpr int WRITER_INTERVAL_MILLISECONDS = 5;
+
+private:
+    enum class ArgumentType : uint8_t {
+        INT,
+        UINT,
+        FLOAT,
+        BOOL,
+        STRING,
+        POINTER
+    };
+
+    struct Record {
+        uint64_t sequence = 0;
+        uint64_t time = 0; // Nanoseconds since the logger started
+        const char* format = nullptr;
+        LogLevel level = LogLevel::INFO;
+        LogCategory category = LogCategory::GENERAL;
+        bool truncated = false;
+        uint16_t payloadSize = 0;
+        unsigned char payload[PAYLOAD_CAPACITY];
+    };
+
+    // Single producer (its thread), single consumer (whoever holds drainMutex)
+    struct ThreadQueue {
+        Record records[QUEUE_CAPACITY];
+        std::atomic<uint64_t> head{0}; // Next record to read
+        std::atomic<uint64_t> tail{0}; // Next record to write
+        std::atomic<bool> retired{false}; // Its thread has exited
+        ThreadQueue* next = nullptr;
+    };
+
+    Logger();
+    ~Logger();
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    std::atomic<LogLevel> levels[static_cast<int>(LogCategory::COUNT)];
+    std::atomic<ThreadQueue*> queues{nullptr}; // Pushed at the front, lock-free
+    std::atomic<uint64_t> nextSequence{0};
+    std::atomic<size_t> dropped{0};
+    size_t reportedDropped = 0;
+    int64_t startTime = 0;
+
+    std::mutex drainMutex;
+    std::vector<Record> batch;
+    std::string output;
+    std::string errors;
+    std::atomic<bool> running{true};
+    std::thread writer;
+
+    Record* beginRecord();
+    void commitRecord();
+    ThreadQueue* getThreadQueue();
+    void writerLoop();
+    void drain();
+    void format(const Record& record, std::string& out) const;
+
+    static void append(Record& record, ArgumentType type, const void* data, size_t size);
+    static void appendString(Record& record, std::string_view value);
+
+    template <typename T>
+    static void encode(Record& record, const T& value) {
+        if constexpr (std::is_same_v<T, bool>) {
+            append(record, ArgumentType::BOOL, &value, sizeof(value));
+        } else if constexpr (std::is_enum_v<T>) {
+            int64_t number = static_cast<int64_t>(value);
+            append(record, ArgumentType::INT, &number, sizeof(number));
+        } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            int64_t number = value;
+            append(record, ArgumentType::INT, &number, sizeof(number));
+        } else if constexpr (std::is_integral_v<T>) {
+            uint64_t number = value;
+            append(record, ArgumentType::UINT, &number, sizeof(number));
+        } else if constexpr (std::is_floating_point_v<T>) {
+            double number = value;
+            append(record, ArgumentType::FLOAT, &number, sizeof(number));
+        } else if constexpr (std::is_same_v<std::decay_t<T>, const char*> || std::is_same_v<std::decay_t<T>, char*>) {
+            appendString(record, value ? std::string_view(value) : std::string_view("(null)"));
+        } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+            appendString(record, std::string_view(value));
+        } else if constexpr (std::is_pointer_v<T>) {
+            uint64_t address = reinterpret_cast<uintptr_t>(value);
+            append(record, ArgumentType::POINTER, &address, sizeof(address));
+        } else {
+            static_assert(std::is_pointer_v<T>, "Unsupported log argument type");
+        }
+    }
+};
+
+#define LOG_WRITE(level, category, ...) Logger::get().write(level, LogCategory::category, __VA_ARGS__)
+// Stripped calls stay type-checked but sit in an unevaluated operand, so no
+// code is generated and locals used only for logging don't warn as unused
+#define LOG_STRIP(level, category, ...) ((void)sizeof((LOG_WRITE(level, category, __VA_ARGS__), 0)))
+
+#if LOG_MIN_LEVEL <= 0
+#define LOG_TRACE(category, ...) LOG_WRITE(LogLevel::TRACE, category, __VA_ARGS__)
+#else
+#define LOG_TRACE(category, ...) LOG_STRIP(LogLevel::TRACE, category, __VA_ARGS__)
+#endif
+
+#if LOG_MIN_LEVEL <= 1
+#define LOG_DEBUG(category, ...) LOG_WRITE(LogLevel::DEBUG, category, __VA_ARGS__)
+#else
+#define LOG_DEBUG(category, ...) LOG_STRIP(LogLevel::DEBUG, category, __VA_ARGS__)
+#endif
+
+#if LOG_MIN_LEVEL <= 2
+#define LOG_INFO(category, ...) LOG_WRITE(LogLevel::INFO, category, __VA_ARGS__)
+#else
+#define LOG_INFO(category, ...) LOG_STRIP(LogLevel::INFO, category, __VA_ARGS__)
+#endif
+
+#if LOG_MIN_LEVEL <= 3
+#define LOG_WARN(category, ...) LOG_WRITE(LogLevel::WARN, category, __VA_ARGS__)
+#else
+#define LOG_WARN(category, ...) LOG_STRIP(LogLevel::WARN, category, __VA_ARGS__)
+#endif
+
+#if LOG_MIN_LEVEL <= 4
+#define LOG_ERROR(category, ...) LOG_WRITE(LogLevel::ERR, category, __VA_ARGS__)
+#else
+#define LOG_ERROR(category, ...) LOG_STRIP(LogLevel::ERR, category, __VA_ARGS__)
+#endif
@@ -1,4 +1,5 @@
 #include "renderer.h"
+#include "logger.h"
 #include <iostream>
 
 Renderer::Renderer(VulkanRenderer* vulkanRenderer) : 
@@ -35,7 +36,7 @@ void Renderer::cleanupResources() {
 
 void Renderer::initialize() {
     // Create initial empty vertex buffer
-    std::vector<Vertex> emptyVertices;
+    FrameVector<Vertex> emptyVertices(&FrameArena::get());
     createVertexBuffer(emptyVertices);
 }
 
@@ -46,30 +47,35 @@ void Renderer::render(const std::shared_ptr<Level>& level, const std::shared_ptr
     frameCount++;
 
     // Generate vertices for all game elements
-    std::vector<Vertex> allVertices;
+    FrameVector<Vertex> allVertices(&FrameArena::get());
 
     // Level vertices
-    std::vector<Vertex> levelVertices = generateLevelVertices(level);
+    FrameVector<Vertex> levelVertices = generateLevelVertices(level);
     allVertices.insert(allVertices.end(), levelVertices.begin(), levelVertices.end());
 
     // Player vertices
-    std::vector<Vertex> playerVertices = generateCharacterVertices(player);
+    FrameVector<Vertex> playerVertices = generateCharacterVertices(player);
     allVertices.insert(allVertices.end(), playerVertices.begin(), playerVertices.end());
 
-    // Enemy vertices
-    std::vector<Vertex> enemyVertices = generateEnemyVertices(level->getEnemies());
+    // Enemy vertices, culled through the level's spatial index
+    FrameVector<Enemy*> visibleEnemies(&FrameArena::get());
+    level->getEnemyGrid().forEachInRadius(cameraX, cameraY, VIEW_DISTANCE, [&](EnemyHandle enemy, float, float) {
+        visibleEnemies.push_back(level->resolve(enemy));
+    });
+    FrameVector<Vertex> enemyVertices = generateEnemyVertices(visibleEnemies);
     allVertices.insert(allVertices.end(), enemyVertices.begin(), enemyVertices.end());
 
     // Item vertices
-    std::vector<Vertex> itemVertices = generateItemVertices(level);
+    FrameVector<Vertex> itemVertices = generateItemVertices(level);
     allVertices.insert(allVertices.end(), itemVertices.begin(), itemVertices.end());
 
-    // Visual effect vertices
-    std::vector<Vertex> effectVertices = generateVisualEffectVertices(effectManager);
-    allVertices.insert(allVertices.end(), effectVertices.begin(), effectVertices.end());
+    // Visual effect vertices, written straight into the frame buffer
+    size_t effectStart = allVertices.size();
+    effectManager.appendAllEffectVertices(allVertices);
+    size_t effectVertexCount = allVertices.size() - effectStart;
 
     // UI vertices
-    std::vector<Vertex> uiVertices = uiSystem.generateUIVertices(player);
+    FrameVector<Vertex> uiVertices = uiSystem.generateUIVertices(player);
     allVertices.insert(allVertices.end(), uiVertices.begin(), uiVertices.end());
 
     // Update vertex buffer
@@ -81,7 +87,7 @@ void Renderer::render(const std::shared_ptr<Level>& level, const std::shared_ptr
     //           << playerVertices.size() << " player, "
     //           << enemyVertices.size() << " enemies, "
     //           << itemVertices.size() << " items, "
-    //           << effectVertices.size() << " effects, "
+    //           << effectVertexCount << " effects, "
     //           << uiVertices.size() << " UI vertices." << std::endl;
 
     drawScene();
@@ -92,10 +98,10 @@ void Renderer::setCameraPosition(float x, float y) {
     cameraY = y;
 }
 
-void Renderer::createVertexBuffer(const std::vector<Vertex>& vertices) {
+void Renderer::createVertexBuffer(const FrameVector<Vertex>& vertices) {
     // Handle empty vertex arrays
     if (vertices.empty()) {
-        std::cout << "Creating empty vertex buffer" << std::endl;
+        LOG_DEBUG(RENDER, "Creating empty vertex buffer");
         // Create a minimal buffer for empty vertex arrays
         VkDeviceSize bufferSize = sizeof(Vertex);
         
@@ -140,7 +146,7 @@ void Renderer::createVertexBuffer(const std::vector<Vertex>& vertices) {
     }
 }
 
-void Renderer::updateVertexBuffer(const std::vector<Vertex>& vertices) {
+void Renderer::updateVertexBuffer(const FrameVector<Vertex>& vertices) {
     // For simplicity, we'll just recreate the vertex buffer
     if (vertexBuffer != VK_NULL_HANDLE) {
         // Wait for the device to be idle before destroying resources
@@ -161,7 +167,7 @@ void Renderer::drawScene() {
 
     // For now, let's just generate some dummy vertices to test the rendering pipeline.
     // This will be replaced with actual game state later.
-    std::vector<Vertex> allVertices;
+    FrameVector<Vertex> allVertices(&FrameArena::get());
     allVertices.push_back({{0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f, 1.0f}});
     allVertices.push_back({{0.5f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f, 1.0f}});
     allVertices.push_back({{0.0f, 0.5f, 0.0f}, {0.0f, 0.0f, 1.0f, 1.0f}});
@@ -170,8 +176,8 @@ void Renderer::drawScene() {
     currentVertexCount = static_cast<uint32_t>(allVertices.size());
 }
 
-std::vector<Vertex> Renderer::generateLevelVertices(const std::shared_ptr<Level>& level) {
-    std::vector<Vertex> vertices;
+FrameVector<Vertex> Renderer::generateLevelVertices(const std::shared_ptr<Level>& level) {
+    FrameVector<Vertex> vertices(&FrameArena::get());
     
     // Check if level is valid
     if (!level) {
@@ -262,12 +268,12 @@ std::vector<Vertex> Renderer::generateLevelVertices(const std::shared_ptr<Level>
     return vertices;
 }
 
-std::vector<Vertex> Renderer::generateCharacterVertices(const std::shared_ptr<Character>& character) {
-    std::vector<Vertex> vertices;
+FrameVector<Vertex> Renderer::generateCharacterVertices(const std::shared_ptr<Character>& character) {
+    FrameVector<Vertex> vertices(&FrameArena::get());
     
     // Check if character is valid
     if (!character) {
-        std::cout << "Warning: Null character pointer encountered" << std::endl;
+        LOG_WARN(RENDER, "Null character pointer encountered");
         return vertices;
     }
     
@@ -301,17 +307,14 @@ std::vector<Vertex> Renderer::generateCharacterVertices(const std::shared_ptr<Ch
     return vertices;
 }
 
-std::vector<Vertex> Renderer::generateEnemyVertices(const std::vector<std::shared_ptr<Enemy>>& enemies) {
-    std::vector<Vertex> vertices;
+FrameVector<Vertex> Renderer::generateEnemyVertices(const FrameVector<Enemy*>& enemies) {
+    FrameVector<Vertex> vertices(&FrameArena::get());
     
     // Check if enemies vector is empty
     if (enemies.empty()) {
         return vertices;
     }
     
-    // Define view distance for frustum culling
-    const float VIEW_DISTANCE = 15.0f;
-    
     // Pre-allocate memory for vertices (optimization)
     vertices.reserve(enemies.size() * 6); // 6 vertices per enemy (2 triangles)
     
@@ -380,8 +383,8 @@ std::vector<Vertex> Renderer::generateEnemyVertices(const std::vector<std::share
     return vertices;
 }
 
-std::vector<Vertex> Renderer::generateItemVertices(const std::shared_ptr<Level>& level) {
-    std::vector<Vertex> vertices;
+FrameVector<Vertex> Renderer::generateItemVertices(const std::shared_ptr<Level>& level) {
+    FrameVector<Vertex> vertices(&FrameArena::get());
     const float TILE_SIZE = 0.1f; // Size of an item on the screen
 
     for (const auto& item : level->getItems()) {
@@ -405,18 +408,11 @@ std::vector<Vertex> Renderer::generateItemVertices(const std::shared_ptr<Level>&
     return vertices;
 }
 
-std::vector<Vertex> Renderer::generateVisualEffectVertices(const VisualEffectManager& effectManager) {
-    std::vector<Vertex> vertices;
-    for (const auto& effect : effectManager.getEffects()) {
-        if (effect) {
-            auto effectVertices = effect->generateVertices();
-            vertices.insert(vertices.end(), effectVertices.begin(), effectVertices.end());
-        }
-    }
-    return vertices;
+FrameVector<Vertex> Renderer::generateVisualEffectVertices(const VisualEffectManager& effectManager) {
+    return effectManager.generateAllEffectVertices();
 }
 
-std::vector<Vertex> Renderer::generateUIVertices(const std::shared_ptr<Character>& player) {
+FrameVector<Vertex> Renderer::generateUIVertices(const std::shared_ptr<Character>& player) {
     // This function will delegate to the UISystem to generate UI vertices
     // The UISystem will handle the actual UI element generation
     return uiSystem.generateUIVertices(player);
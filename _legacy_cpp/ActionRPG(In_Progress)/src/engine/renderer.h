@@ -3,6 +3,7 @@
 #include <vector>
 #include <memory>
 #include "vertex.h"
+#include "frame_arena.h"
 #include "vulkan_renderer.h"
 #include "../game/level.h"
 #include "../game/character.h"
@@ -31,10 +32,10 @@ public:
     
     void setCameraPosition(float x, float y);
     
-    void updateVertexBuffer(const std::vector<Vertex>& vertices);
+    void updateVertexBuffer(const FrameVector<Vertex>& vertices);
     
     // Generate all vertices for the game world (level, player, enemies, effects)
-    std::vector<Vertex> generateGameWorldVertices(const std::shared_ptr<Level>& level, const std::shared_ptr<Character>& player, const VisualEffectManager& effectManager);
+    FrameVector<Vertex> generateGameWorldVertices(const std::shared_ptr<Level>& level, const std::shared_ptr<Character>& player, const VisualEffectManager& effectManager);
     
 private:
     VulkanRenderer* vulkanRenderer;
@@ -55,12 +56,12 @@ private:
 
     // Methods
     void createVertexBuffer();
-    std::vector<Vertex> generateLevelVertices(const std::shared_ptr<Level>& level);
-    std::vector<Vertex> generateCharacterVertices(const std::shared_ptr<Character>& character);
-    std::vector<Vertex> generateEnemyVertices(const std::vector<std::shared_ptr<Enemy>>& enemies);
-    std::vector<Vertex> generateItemVertices(const std::shared_ptr<Level>& level);
-    std::vector<Vertex> generateVisualEffectVertices(const VisualEffectManager& effectManager);
-    std::vector<Vertex> generateUIVertices(const std::shared_ptr<Character>& player);
+    FrameVector<Vertex> generateLevelVertices(const std::shared_ptr<Level>& level);
+    FrameVector<Vertex> generateCharacterVertices(const std::shared_ptr<Character>& character);
+    FrameVector<Vertex> generateEnemyVertices(const FrameVector<Enemy*>& enemies);
+    FrameVector<Vertex> generateItemVertices(const std::shared_ptr<Level>& level);
+    FrameVector<Vertex> generateVisualEffectVertices(const VisualEffectManager& effectManager);
+    FrameVector<Vertex> generateUIVertices(const std::shared_ptr<Character>& player);
 
     // Helper methods for level generation
     void createRoom(int x1, int y1, int x2, int y2);
@@ -68,4 +69,7 @@ private:
     
     // Enemy drop system
     void dropLoot(float x, float y, int enemyLevel);
+    
+    // Constants
+    static constexpr float VIEW_DISTANCE = 15.0f; // Enemies farther than this from the camera are culled
 }; 
\ No newline at end of file
@@ -0,0 +1,215 @@
+#include "replay.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include "logger.h"
+
+namespace {
+    size_t alignTo8(size_t offset) {
+        return (offset + 7) & ~static_cast<size_t>(7);
+    }
+
+    template <typename T>
+    void writeAt(std::vector<uint8_t>& buffer, size_t offset, const T& value) {
+        std::memcpy(buffer.data() + offset, &value, sizeof(T));
+    }
+
+    template <typename T>
+    T readAt(const std::vector<uint8_t>& buffer, size_t offset) {
+        T value;
+        std::memcpy(&value, buffer.data() + offset, sizeof(T));
+        return value;
+    }
+}
+
+// ReplayRecorder implementation
+ReplayRecorder::ReplayRecorder() {
+}
+
+ReplayRecorder::~ReplayRecorder() {
+}
+
+void ReplayRecorder::begin(const ReplayConfig& newConfig) {
+    config = newConfig;
+    if (config.checksumInterval == 0) {
+        config.checksumInterval = 1;
+    }
+    recording = true;
+    tickCount = 0;
+    runs.clear();
+    checksums.clear();
+}
+
+void ReplayRecorder::recordTick(const TickInput& input) {
+    if (!recording) {
+        return;
+    }
+    tickCount++;
+
+    // Held keys repeat the same input for many ticks; those collapse into one run
+    if (!runs.empty()) {
+        ReplayInputRun& last = runs.back();
+        if (last.actionsDown == input.actionsDown && last.actionsPressed == input.actionsPressed) {
+            last.tickCount++;
+            return;
+        }
+    }
+    runs.push_back(ReplayInputRun{input.actionsDown, input.actionsPressed, 1});
+}
+
+void ReplayRecorder::recordChecksum(uint64_t checksum) {
+    if (recording) {
+        checksums.push_back(checksum);
+    }
+}
+
+bool ReplayRecorder::save(const std::string& path) {
+    if (!recording) {
+        return false;
+    }
+    recording = false;
+
+    ReplayFileHeader header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.headerSize = sizeof(ReplayFileHeader);
+    header.worldSeed = config.worldSeed;
+    header.playerClass = static_cast<uint32_t>(config.playerClass);
+    header.tickRate = config.tickRate;
+    header.checksumInterval = config.checksumInterval;
+    header.levelWidth = config.levelWidth;
+    header.levelHeight = config.levelHeight;
+    header.tickCount = tickCount;
+    header.runCount = static_cast<uint32_t>(runs.size());
+    header.checksumCount = static_cast<uint32_t>(checksums.size());
+
+    const size_t runOffset = alignTo8(sizeof(ReplayFileHeader));
+    const size_t checksumOffset = alignTo8(runOffset + runs.size() * sizeof(ReplayInputRun));
+    std::vector<uint8_t> buffer(checksumOffset + checksums.size() * sizeof(uint64_t), 0);
+    writeAt(buffer, 0, header);
+    for (size_t i = 0; i < runs.size(); i++) {
+        writeAt(buffer, runOffset + i * sizeof(ReplayInputRun), runs[i]);
+    }
+    for (size_t i = 0; i < checksums.size(); i++) {
+        writeAt(buffer, checksumOffset + i * sizeof(uint64_t), checksums[i]);
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open replay file for writing: " << path << std::endl;
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    if (!file) {
+        std::cerr << "Failed to write replay file: " << path << std::endl;
+        return false;
+    }
+
+    LOG_INFO(ENGINE, "Recorded {} ticks ({} input runs, {} checksums) to {}", tickCount, runs.size(),
+             checksums.size(), path);
+    return true;
+}
+
+// ReplayPlayer implementation
+ReplayPlayer::ReplayPlayer() {
+}
+
+ReplayPlayer::~ReplayPlayer() {
+}
+
+bool ReplayPlayer::load(const std::string& path) {
+    loaded = false;
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open replay file: " << path << std::endl;
+        return false;
+    }
+    std::vector<uint8_t> buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (buffer.size() < sizeof(ReplayFileHeader)) {
+        std::cerr << "Replay file is truncated: " << path << std::endl;
+        return false;
+    }
+    ReplayFileHeader header = readAt<ReplayFileHeader>(buffer, 0);
+    if (std::memcmp(header.magic, ReplayRecorder::MAGIC, sizeof(ReplayRecorder::MAGIC)) != 0 ||
+        header.version != ReplayRecorder::VERSION || header.headerSize != sizeof(ReplayFileHeader)) {
+        std::cerr << "Not a replay file, or from an incompatible version: " << path << std::endl;
+        return false;
+    }
+
+    // Every table has to lie inside the file
+    const size_t runOffset = alignTo8(sizeof(ReplayFileHeader));
+    const size_t checksumOffset = alignTo8(runOffset + static_cast<size_t>(header.runCount) * sizeof(ReplayInputRun));
+    if (checksumOffset + static_cast<size_t>(header.checksumCount) * sizeof(uint64_t) > buffer.size() ||
+        header.tickRate == 0 || header.checksumInterval == 0) {
+        std::cerr << "Replay file is corrupt: " << path << std::endl;
+        return false;
+    }
+
+    runs.resize(header.runCount);
+    uint64_t runTicks = 0;
+    for (size_t i = 0; i < runs.size(); i++) {
+        runs[i] = readAt<ReplayInputRun>(buffer, runOffset + i * sizeof(ReplayInputRun));
+        runTicks += runs[i].tickCount;
+    }
+    checksums.resize(header.checksumCount);
+    for (size_t i = 0; i < checksums.size(); i++) {
+        checksums[i] = readAt<uint64_t>(buffer, checksumOffset + i * sizeof(uint64_t));
+    }
+    if (runTicks != header.tickCount) {
+        std::cerr << "Replay file is corrupt: " << path << std::endl;
+        return false;
+    }
+
+    config.worldSeed = header.worldSeed;
+    config.playerClass = static_cast<CharacterClass>(header.playerClass);
+    config.tickRate = header.tickRate;
+    config.checksumInterval = header.checksumInterval;
+    config.levelWidth = header.levelWidth;
+    config.levelHeight = header.levelHeight;
+
+    tickCount = header.tickCount;
+    tick = 0;
+    runIndex = 0;
+    runTick = 0;
+    divergenceCount = 0;
+    firstDivergentTick = 0;
+    loaded = true;
+    return true;
+}
+
+bool ReplayPlayer::nextTick(TickInput& input) {
+    // Skip past runs that are used up (or empty, which the recorder never writes)
+    while (runIndex < runs.size() && runTick >= runs[runIndex].tickCount) {
+        runIndex++;
+        runTick = 0;
+    }
+    if (!loaded || runIndex >= runs.size()) {
+        return false;
+    }
+
+    input.actionsDown = runs[runIndex].actionsDown;
+    input.actionsPressed = runs[runIndex].actionsPressed;
+    runTick++;
+    tick++;
+    return true;
+}
+
+bool ReplayPlayer::verifyChecksum(uint64_t checksum) {
+    if (tick == 0 || tick % config.checksumInterval != 0) {
+        return true;
+    }
+    size_t index = tick / config.checksumInterval - 1;
+    if (index >= checksums.size() || checksums[index] == checksum) {
+        return true;
+    }
+
+    if (divergenceCount == 0) {
+        firstDivergentTick = tick;
+        LOG_ERROR(ENGINE, "Replay diverged at tick {}: expected checksum {}, got {}", tick, checksums[index], checksum);
+    }
+    divergenceCount++;
+    return false;
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "input.h"
+#include "../game/character.h"
+
+// On-disk replay format (little-endian, version 1)
+//
+//   ReplayFileHeader
+//   ReplayInputRun[runCount]   consecutive ticks with the same input, collapsed
+//   uint64_t[checksumCount]    world checksum after every checksumInterval ticks
+//
+// A session is reproduced from the header alone plus the inputs: the world
+// seed fixes every floor, enemy and loot roll, and the simulation advances in
+// fixed ticks on a deterministic Level. Checksums only detect divergence.
+
+struct ReplayFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t worldSeed;
+    uint32_t playerClass;
+    uint32_t tickRate;         // Ticks per simulated second
+    uint32_t checksumInterval; // Ticks between checksums
+    int32_t levelWidth;
+    int32_t levelHeight;
+    uint32_t tickCount;
+    uint32_t runCount;
+    uint32_t checksumCount;
+    uint32_t reserved;
+};
+
+struct ReplayInputRun {
+    uint32_t actionsDown;
+    uint32_t actionsPressed;
+    uint32_t tickCount;
+};
+
+// What a replay needs besides the inputs to rebuild the session
+struct ReplayConfig {
+    uint32_t worldSeed = 0;
+    CharacterClass playerClass = CharacterClass::WARRIOR;
+    uint32_t tickRate = 60;
+    uint32_t checksumInterval = 60;
+    int levelWidth = 0;
+    int levelHeight = 0;
+};
+
+// The actions the simulation saw on one tick
+struct TickInput {
+    ActionMask actionsDown = 0;
+    ActionMask actionsPressed = 0;
+
+    bool operator==(const TickInput& other) const {
+        return actionsDown == other.actionsDown && actionsPressed == other.actionsPressed;
+    }
+};
+
+// Collects a session's inputs and checksums tick by tick and writes them out
+class ReplayRecorder {
+public:
+    ReplayRecorder();
+    ~ReplayRecorder();
+
+    void begin(const ReplayConfig& config);
+    bool isRecording() const { return recording; }
+    uint32_t getTickCount() const { return tickCount; }
+    const ReplayConfig& getConfig() const { return config; }
+
+    // Call once per simulated tick, then recordChecksum when the tick count reaches a multiple of the interval
+    void recordTick(const TickInput& input);
+    void recordChecksum(uint64_t checksum);
+
+    // Writes the file and stops recording
+    bool save(const std::string& path);
+
+    // Constants
+    static constexpr char MAGIC[8] = {'A', 'R', 'P', 'G', 'R', 'P', 'L', '\0'};
+    static constexpr uint32_t VERSION = 1;
+
+private:
+    ReplayConfig config;
+    bool recording = false;
+    uint32_t tickCount = 0;
+    std::vector<ReplayInputRun> runs;
+    std::vector<uint64_t> checksums;
+};
+
+// Feeds a recorded session back one tick at a time and checks the world against its checksums
+class ReplayPlayer {
+public:
+    ReplayPlayer();
+    ~ReplayPlayer();
+
+    bool load(const std::string& path);
+    bool isLoaded() const { return loaded; }
+    const ReplayConfig& getConfig() const { return config; }
+
+    // Input for the next tick; false once every recorded tick has been played
+    bool nextTick(TickInput& input);
+    bool isFinished() const { return tick >= tickCount; }
+    uint32_t getTick() const { return tick; }
+    uint32_t getTickCount() const { return tickCount; }
+
+    // Call after each tick; compares when a checksum was recorded for it. Returns false on divergence.
+    bool verifyChecksum(uint64_t checksum);
+    uint32_t getDivergenceCount() const { return divergenceCount; }
+    uint32_t getFirstDivergentTick() const { return firstDivergentTick; }
+
+private:
+    ReplayConfig config;
+    bool loaded = false;
+    std::vector<ReplayInputRun> runs;
+    std::vector<uint64_t> checksums;
+    uint32_t tickCount = 0;
+    uint32_t tick = 0;
+    size_t runIndex = 0;
+    uint32_t runTick = 0; // Ticks already played from the current run
+    uint32_t divergenceCount = 0;
+    uint32_t firstDivergentTick = 0;
+};
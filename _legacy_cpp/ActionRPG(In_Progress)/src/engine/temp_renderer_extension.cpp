@@ -1,7 +1,8 @@
 #include "renderer.h"
 #include <iostream>
+#include "allocation_tracker.h"
 
-std::vector<Vertex> Renderer::generateGameWorldVertices(const std::shared_ptr<Level>& level, const std::shared_ptr<Character>& player, const VisualEffectManager& effectManager) {
+FrameVector<Vertex> Renderer::generateGameWorldVertices(const std::shared_ptr<Level>& level, const std::shared_ptr<Character>& player, const VisualEffectManager& effectManager) {
     // Check if level and player are valid
     if (!level || !player) {
         std::cerr << "Error: Level or player is null in Renderer::generateGameWorldVertices" << std::endl;
@@ -9,18 +10,23 @@ std::vector<Vertex> Renderer::generateGameWorldVertices(const std::shared_ptr<Le
     }
     
     // Generate level vertices with frustum culling (only render what's visible)
-    std::vector<Vertex> levelVertices = generateLevelVertices(level);
+    FrameVector<Vertex> levelVertices = generateLevelVertices(level);
     
     // Generate player vertices (always visible at center)
-    std::vector<Vertex> playerVertices = generateCharacterVertices(player);
+    FrameVector<Vertex> playerVertices = generateCharacterVertices(player);
     
-    // Get enemies and only generate vertices for visible ones
-    const auto& enemies = level->getEnemies();
-    std::vector<Vertex> enemyVertices = generateEnemyVertices(enemies);
+    // Only generate vertices for enemies the spatial index reports as in view
+    FrameVector<Enemy*> enemies(&FrameArena::get());
+    level->getEnemyGrid().forEachInRadius(cameraX, cameraY, VIEW_DISTANCE, [&](EnemyHandle enemy, float, float) {
+        enemies.push_back(level->resolve(enemy));
+    });
+    FrameVector<Vertex> enemyVertices = generateEnemyVertices(enemies);
     
     // Generate UI elements if enabled
-    std::vector<Vertex> uiVertices;
+    FrameVector<Vertex> uiVertices(&FrameArena::get());
     if (showUI) {
+        AllocationScope uiScope(AllocationTag::UI);
+        
         // Generate enemy health bars
         auto enemyHealthBars = uiSystem.generateEnemyHealthBars(enemies, cameraX, cameraY);
         
@@ -34,13 +40,13 @@ std::vector<Vertex> Renderer::generateGameWorldVertices(const std::shared_ptr<Le
     }
     
     // Get visual effect vertices
-    std::vector<Vertex> effectVertices = effectManager.generateAllEffectVertices();
+    FrameVector<Vertex> effectVertices = effectManager.generateAllEffectVertices();
     
     // Get item drop vertices
-    std::vector<Vertex> itemVertices = level->getItemDropManager().generateAllItemVertices();
+    FrameVector<Vertex> itemVertices = level->getItemDropManager().generateAllItemVertices();
     
     // Combine all vertices efficiently with reserve to avoid reallocations
-    std::vector<Vertex> allVertices;
+    FrameVector<Vertex> allVertices(&FrameArena::get());
     allVertices.reserve(levelVertices.size() + playerVertices.size() + enemyVertices.size() + 
                       effectVertices.size() + itemVertices.size() + uiVertices.size());
     allVertices.insert(allVertices.end(), levelVertices.begin(), levelVertices.end());
@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <fstream>
 #include "renderer.h" // Include Renderer header
+#include "logger.h"
 
 #ifdef NDEBUG
 const bool enableValidationLayers = false;
@@ -55,7 +56,7 @@ bool VulkanRenderer::initialize() {
     // Note: We'll create the surface in the game loop after creating the window
     // The surface must be created before calling pickPhysicalDevice and createLogicalDevice
     
-    std::cout << "Vulkan renderer initialized successfully" << std::endl;
+    LOG_INFO(RENDER, "Vulkan renderer initialized successfully");
     return true;
 }
 
@@ -222,9 +223,9 @@ bool VulkanRenderer::createInstance() {
     std::vector<const char*> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
     
     // Print extensions for debugging
-    std::cout << "Required extensions:" << std::endl;
+    LOG_DEBUG(RENDER, "Required extensions:");
     for (uint32_t i = 0; i < glfwExtensionCount; i++) {
-        std::cout << "\t" << glfwExtensions[i] << std::endl;
+        LOG_DEBUG(RENDER, "    {}", glfwExtensions[i]);
     }
     
     // Add debug extension if needed
@@ -250,7 +251,7 @@ bool VulkanRenderer::createInstance() {
         return false;
     }
     
-    std::cout << "Vulkan instance created successfully" << std::endl;
+    LOG_INFO(RENDER, "Vulkan instance created successfully");
     return true;
 }
 
@@ -333,7 +334,7 @@ bool VulkanRenderer::pickPhysicalDevice() {
     // Print selected device info
     VkPhysicalDeviceProperties deviceProperties;
     vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
-    std::cout << "Selected GPU: " << deviceProperties.deviceName << std::endl;
+    LOG_INFO(RENDER, "Selected GPU: {}", deviceProperties.deviceName);
     
     return true;
 }
@@ -421,7 +422,7 @@ bool VulkanRenderer::createSurface(GLFWwindow* window) {
     // Print debug info about the window
     int width, height;
     glfwGetWindowSize(window, &width, &height);
-    std::cout << "Window dimensions: " << width << "x" << height << std::endl;
+    LOG_INFO(RENDER, "Window dimensions: {}x{}", width, height);
     
     // Check if instance is valid
     if (instance == VK_NULL_HANDLE) {
@@ -454,7 +455,7 @@ bool VulkanRenderer::createSurface(GLFWwindow* window) {
         return false;
     }
     
-    std::cout << "Vulkan surface created successfully" << std::endl;
+    LOG_INFO(RENDER, "Vulkan surface created successfully");
     return true;
 }
 
@@ -683,7 +684,7 @@ bool VulkanRenderer::createRenderPass() {
 }
 
 bool VulkanRenderer::createGraphicsPipeline() {
-    std::cout << "Creating shader modules..." << std::endl;
+    LOG_INFO(RENDER, "Creating shader modules...");
     
     // Try to load compiled SPIR-V shaders
     std::vector<char> vertShaderCode;
@@ -694,9 +695,9 @@ bool VulkanRenderer::createGraphicsPipeline() {
         vertShaderCode = readFile("spirv/vert.spv");
         fragShaderCode = readFile("spirv/frag.spv");
         
-        std::cout << "Loaded compiled SPIR-V shaders successfully" << std::endl;
-        std::cout << "Vertex shader size: " << vertShaderCode.size() << " bytes" << std::endl;
-        std::cout << "Fragment shader size: " << fragShaderCode.size() << " bytes" << std::endl;
+        LOG_INFO(RENDER, "Loaded compiled SPIR-V shaders successfully");
+        LOG_DEBUG(RENDER, "Vertex shader size: {} bytes", vertShaderCode.size());
+        LOG_DEBUG(RENDER, "Fragment shader size: {} bytes", fragShaderCode.size());
     } catch (const std::exception& e) {
         std::cerr << "Failed to load compiled SPIR-V shaders: " << e.what() << std::endl;
         std::cerr << "Please run compile_shaders.bat to compile the shaders first" << std::endl;
@@ -0,0 +1,70 @@
+#include "worker_pool.h"
+
+WorkerPool::WorkerPool() {
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    startCondition.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void WorkerPool::runShares(unsigned int workers, ShareFunction function, void* context) {
+    if (workers <= 1) {
+        function(context, 0);
+        return;
+    }
+
+    // Grow on first use; worker 0 is always the caller. New threads wait for the next job,
+    // not the last one.
+    while (threads.size() < workers - 1) {
+        unsigned int worker = static_cast<unsigned int>(threads.size()) + 1;
+        threads.emplace_back(&WorkerPool::workerLoop, this, worker, generation);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        shareFunction = function;
+        shareContext = context;
+        activeWorkers = workers;
+        remainingShares = workers - 1;
+        generation++;
+    }
+    startCondition.notify_all();
+
+    function(context, 0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCondition.wait(lock, [this]() { return remainingShares == 0; });
+}
+
+void WorkerPool::workerLoop(unsigned int worker, uint64_t seenGeneration) {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        startCondition.wait(lock, [this, seenGeneration]() { return stopping || generation != seenGeneration; });
+        if (stopping) {
+            return;
+        }
+        seenGeneration = generation;
+
+        // Jobs that need fewer workers leave the rest asleep
+        if (worker >= activeWorkers) {
+            continue;
+        }
+
+        ShareFunction function = shareFunction;
+        void* context = shareContext;
+        lock.unlock();
+        function(context, worker);
+        lock.lock();
+
+        if (--remainingShares == 0) {
+            doneCondition.notify_one();
+        }
+    }
+}
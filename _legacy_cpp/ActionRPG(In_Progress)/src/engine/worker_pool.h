@@ -0,0 +1,52 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Threads that are started once and then reused for one parallel job at a
+// time, for work that is split up every tick. Between jobs the threads sleep
+// on a condition variable; run() wakes as many as the job needs, does the
+// first share on the calling thread and returns once every share is done.
+// Threads are only created when a job first needs them, and run() itself
+// never allocates.
+//
+// One caller at a time; jobs must not throw.
+class WorkerPool {
+public:
+    WorkerPool();
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Calls job(worker) for every worker in [0, workers), worker 0 on this thread
+    template <typename Job>
+    void run(unsigned int workers, Job& job) {
+        runShares(workers, [](void* context, unsigned int worker) { (*static_cast<Job*>(context))(worker); }, &job);
+    }
+
+    // Threads started so far, not counting callers
+    size_t getThreadCount() const { return threads.size(); }
+
+private:
+    using ShareFunction = void (*)(void* context, unsigned int worker);
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable startCondition;
+    std::condition_variable doneCondition;
+
+    // The current job, guarded by mutex
+    uint64_t generation = 0;
+    ShareFunction shareFunction = nullptr;
+    void* shareContext = nullptr;
+    unsigned int activeWorkers = 0;
+    unsigned int remainingShares = 0;
+    bool stopping = false;
+
+    void runShares(unsigned int workers, ShareFunction function, void* context);
+    void workerLoop(unsigned int worker, uint64_t seenGeneration);
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include "timer_wheel.h"
+
+// AI level of detail. Enemies close to an observer think every frame, those
+// further out think at a reduced rate, and the rest are dormant and not
+// touched at all until an observer comes near or an alert wakes them.
+enum class AILodTier {
+    NEAR,
+    MID,
+    DORMANT
+};
+
+// What an enemy's timers in the level's timer wheel stand for
+enum class EnemyTimer : uint8_t {
+    MOVE_READY,
+    ATTACK_READY,
+    ALERT_EXPIRY
+};
+
+// Per-enemy scheduling state, owned by the enemy and managed by Level. Awake
+// enemies are only updated when due: a timer fired or something nearby changed.
+struct AILodState {
+    AILodTier tier = AILodTier::DORMANT;
+    float lastTickTime = 0.0f;  // Level time of the last update; the gap is credited on the next one
+    uint32_t frameStamp = 0;    // Last frame this enemy was found awake
+    bool due = true;
+    TimerHandle wakeTimer;      // Next MOVE_READY or ATTACK_READY
+    TimerHandle alertTimer;     // Pending while an alert keeps the enemy awake
+};
+
+// How many enemies were in each tier on the last frame
+struct AILodStats {
+    int nearCount = 0;
+    int midCount = 0;
+    int dormantCount = 0;
+    int updatedCount = 0;  // Enemies whose update actually ran
+    int timersFired = 0;
+};
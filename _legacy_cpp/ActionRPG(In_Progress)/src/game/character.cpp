@@ -1,7 +1,9 @@
 #include "character.h"
 #include "item.h"
-#include <iostream>
+#include "tile_occupancy.h"
+#include "../engine/logger.h"
 #include <algorithm>
+#include <utility>
 
 Character::Character(const std::string& name, CharacterClass characterClass)
     : name(name), characterClass(characterClass), level(1), experience(0), x(0.0f), y(0.0f) {
@@ -9,6 +11,57 @@ Character::Character(const std::string& name, CharacterClass characterClass)
 }
 
 Character::~Character() {
+    // Don't leave a dangling entry behind in the level
+    if (occupancy) {
+        occupancy->remove(occupantId);
+    }
+}
+
+Character::Character(Character&& other) noexcept
+    : name(std::move(other.name)), characterClass(other.characterClass), level(other.level),
+      experience(other.experience), health(other.health), maxHealth(other.maxHealth), mana(other.mana),
+      maxMana(other.maxMana), strength(other.strength), dexterity(other.dexterity),
+      intelligence(other.intelligence), x(other.x), y(other.y), inventory(std::move(other.inventory)),
+      occupancy(other.occupancy), occupantId(other.occupantId) {
+    // Take over the occupancy entry so the moved-from husk doesn't remove it
+    other.occupancy = nullptr;
+    other.occupantId = UINT32_MAX;
+    if (occupancy) {
+        occupancy->relocate(occupantId, this);
+    }
+}
+
+Character& Character::operator=(Character&& other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+    if (occupancy) {
+        occupancy->remove(occupantId);
+    }
+    
+    name = std::move(other.name);
+    characterClass = other.characterClass;
+    level = other.level;
+    experience = other.experience;
+    health = other.health;
+    maxHealth = other.maxHealth;
+    mana = other.mana;
+    maxMana = other.maxMana;
+    strength = other.strength;
+    dexterity = other.dexterity;
+    intelligence = other.intelligence;
+    x = other.x;
+    y = other.y;
+    inventory = std::move(other.inventory);
+    
+    occupancy = other.occupancy;
+    occupantId = other.occupantId;
+    other.occupancy = nullptr;
+    other.occupantId = UINT32_MAX;
+    if (occupancy) {
+        occupancy->relocate(occupantId, this);
+    }
+    return *this;
 }
 
 void Character::initializeStats() {
@@ -46,9 +99,13 @@ void Character::move(float newX, float newY) {
     // Use absolute positioning instead of relative
     x = newX;
     y = newY;
+    if (occupancy) {
+        occupancy->onMoved(occupantId, x, y);
+    }
+    onMoved();
     
     // Debug output to track character movement
-    std::cout << "Character " << name << " moved to (" << x << ", " << y << ")" << std::endl;
+    LOG_TRACE(GENERAL, "Character {} moved to ({}, {})", name, x, y);
 }
 
 Character::AttackType Character::getDefaultAttackType() const {
@@ -102,42 +159,41 @@ int Character::getAttackDamage() const {
     }
 }
 
-void Character::attack(Character* target) {
-    if (!target || target->isDead()) return;
+void Character::attack(Character& target) {
+    if (target.isDead()) return;
     
     // Check if target is in range for melee attack
-    float dx = target->getX() - x;
-    float dy = target->getY() - y;
+    float dx = target.getX() - x;
+    float dy = target.getY() - y;
     float distanceSquared = dx * dx + dy * dy;
     
     // If this is a melee character and target is out of range, don't attack
     if (getDefaultAttackType() == AttackType::MELEE && distanceSquared > getAttackRange() * getAttackRange()) {
-        std::cout << name << " is too far to attack " << target->getName() << "!" << std::endl;
+        LOG_DEBUG(COMBAT, "{} is too far to attack {}!", name, target.getName());
         return;
     }
     
     int damage = getAttackDamage();
     
     // Apply damage to target
-    target->takeDamage(damage);
+    target.takeDamage(damage);
     
-    std::cout << name << " attacks " << target->getName() << " with a " 
-              << (getDefaultAttackType() == AttackType::MELEE ? "melee" : "ranged") 
-              << " attack for " << damage << " damage!" << std::endl;
+    LOG_DEBUG(COMBAT, "{} attacks {} with a {} attack for {} damage!", name, target.getName(),
+              getDefaultAttackType() == AttackType::MELEE ? "melee" : "ranged", damage);
     
     // Check if target died
-    if (target->isDead()) {
-        std::cout << target->getName() << " has been defeated!" << std::endl;
+    if (target.isDead()) {
+        LOG_INFO(COMBAT, "{} has been defeated!", target.getName());
         // Award experience (to be implemented)
     }
 }
 
-void Character::rangedAttack(Character* target, float targetX, float targetY) {
-    if (!target || target->isDead()) return;
+void Character::rangedAttack(Character& target, float targetX, float targetY) {
+    if (target.isDead()) return;
     
     // Only ranged classes can use ranged attacks
     if (getDefaultAttackType() != AttackType::RANGED) {
-        std::cout << name << " cannot perform ranged attacks!" << std::endl;
+        LOG_DEBUG(COMBAT, "{} cannot perform ranged attacks!", name);
         return;
     }
     
@@ -147,17 +203,17 @@ void Character::rangedAttack(Character* target, float targetX, float targetY) {
     float distanceSquared = dx * dx + dy * dy;
     
     if (distanceSquared > getAttackRange() * getAttackRange()) {
-        std::cout << name << " cannot reach the target with a ranged attack!" << std::endl;
+        LOG_DEBUG(COMBAT, "{} cannot reach the target with a ranged attack!", name);
         return;
     }
     
     int damage = getAttackDamage();
     
     // Apply damage to target
-    target->takeDamage(damage);
+    target.takeDamage(damage);
     
     // Describe the attack based on character class
-    std::string attackDescription;
+    const char* attackDescription;
     switch (characterClass) {
         case CharacterClass::RANGER:
             attackDescription = "fires an arrow at";
@@ -169,11 +225,11 @@ void Character::rangedAttack(Character* target, float targetX, float targetY) {
             attackDescription = "attacks";
     }
     
-    std::cout << name << " " << attackDescription << " " << target->getName() << " for " << damage << " damage!" << std::endl;
+    LOG_DEBUG(COMBAT, "{} {} {} for {} damage!", name, attackDescription, target.getName(), damage);
     
     // Check if target died
-    if (target->isDead()) {
-        std::cout << target->getName() << " has been defeated!" << std::endl;
+    if (target.isDead()) {
+        LOG_INFO(COMBAT, "{} has been defeated!", target.getName());
         // Award experience (to be implemented)
     }
 }
@@ -181,11 +237,13 @@ void Character::rangedAttack(Character* target, float targetX, float targetY) {
 void Character::takeDamage(int damage) {
     health -= damage;
     if (health < 0) health = 0;
+    onHealthChanged();
 }
 
 void Character::heal(int amount) {
     health += amount;
     if (health > maxHealth) health = maxHealth;
+    onHealthChanged();
 }
 
 void Character::levelUp() {
@@ -219,36 +277,51 @@ void Character::levelUp() {
     // Restore health and mana on level up
     health = maxHealth;
     mana = maxMana;
+    onHealthChanged();
     
-    std::cout << name << " has reached level " << level << "!" << std::endl;
+    LOG_INFO(GENERAL, "{} has reached level {}!", name, level);
 }
 
-void Character::addItem(std::shared_ptr<Item> item) {
-    inventory.push_back(item);
+void Character::gainExperience(int amount) {
+    experience += amount;
+    while (experience >= level * EXPERIENCE_PER_LEVEL) {
+        experience -= level * EXPERIENCE_PER_LEVEL;
+        levelUp();
+    }
 }
 
-void Character::removeItem(std::shared_ptr<Item> item) {
-    // Find and remove the item from the inventory
-    auto it = std::remove(inventory.begin(), inventory.end(), item);
-    if (it != inventory.end()) {
-        inventory.erase(it, inventory.end());
+void Character::addItem(const ItemInstance& item) {
+    if (!inventory) {
+        inventory = std::make_unique<Inventory>();
     }
+    inventory->add(item);
 }
 
 void Character::removeItem(int index) {
-    if (index >= 0 && index < inventory.size()) {
-        inventory.erase(inventory.begin() + index);
+    if (inventory && index >= 0 && index < static_cast<int>(inventory->size())) {
+        inventory->remove(static_cast<Inventory::Slot>(index));
     }
 }
 
+void Character::consumeItem(int index) {
+    if (inventory && index >= 0 && index < static_cast<int>(inventory->size())) {
+        inventory->consume(static_cast<Inventory::Slot>(index));
+    }
+}
+
+const Inventory& Character::getInventory() const {
+    static const Inventory emptyInventory;
+    return inventory ? *inventory : emptyInventory;
+}
+
 void Character::equipWeapon(std::shared_ptr<Weapon> weapon) {
     // For now, just print a message. Actual equipping logic (e.g., updating stats, unequipping old weapon) can be added here.
-    std::cout << name << " equipped weapon: " << weapon->getName() << std::endl;
+    LOG_INFO(ITEMS, "{} equipped weapon: {}", name, weapon->getName());
     // Example: this->equippedWeapon = weapon;
 }
 
 void Character::equipArmor(std::shared_ptr<Armor> armor) {
     // For now, just print a message. Actual equipping logic can be added here.
-    std::cout << name << " equipped armor: " << armor->getName() << std::endl;
+    LOG_INFO(ITEMS, "{} equipped armor: {}", name, armor->getName());
     // Example: this->equippedArmor = armor;
 }
\ No newline at end of file
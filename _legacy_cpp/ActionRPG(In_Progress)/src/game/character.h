@@ -3,10 +3,13 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <cstdint>
+#include "inventory.h"
 
 class Item;
 class Weapon; // Forward declaration for Weapon
 class Armor;  // Forward declaration for Armor
+class TileOccupancy;
 
 enum class CharacterClass {
     WARRIOR,
@@ -17,12 +20,21 @@ enum class CharacterClass {
 class Character {
 public:
     Character(const std::string& name, CharacterClass characterClass);
-    ~Character();
+    virtual ~Character();
+    
+    // Movable so owners can keep characters in dense, compactable storage; the
+    // tile occupancy entry follows the object. Not copyable: it is registered once.
+    // Relocating never throws, and containers rely on that when they grow.
+    Character(Character&& other) noexcept;
+    Character& operator=(Character&& other) noexcept;
+    Character(const Character&) = delete;
+    Character& operator=(const Character&) = delete;
     
     // Getters
     const std::string& getName() const { return name; }
     CharacterClass getClass() const { return characterClass; }
     int getLevel() const { return level; }
+    int getExperience() const { return experience; }
     int getHealth() const { return health; }
     int getMaxHealth() const { return maxHealth; }
     int getMana() const { return mana; }
@@ -49,13 +61,16 @@ public:
     
     // Actions
     void move(float dx, float dy);
-    void attack(Character* target);
-    void rangedAttack(Character* target, float targetX, float targetY);
+    // Targets are resolved by the caller for the duration of the call; hold handles, not characters
+    void attack(Character& target);
+    void rangedAttack(Character& target, float targetX, float targetY);
     AttackType getDefaultAttackType() const;
     VisualEffectType getAttackVisualEffect() const;
     void takeDamage(int damage);
     void heal(int amount);
     void levelUp();
+    // Levels up as often as the new total allows
+    void gainExperience(int amount);
     bool isDead() const { return health <= 0; }
     
     // Attack properties
@@ -63,15 +78,26 @@ public:
     int getAttackDamage() const;
     
     // Inventory
-    void addItem(std::shared_ptr<Item> item);
-    void removeItem(std::shared_ptr<Item> item);
+    void addItem(const ItemInstance& item);
+    // Removes the whole slot; the last slot moves into its place
     void removeItem(int index);
-    const std::vector<std::shared_ptr<Item>>& getInventory() const { return inventory; }
+    // Uses up one item from the slot's stack
+    void consumeItem(int index);
+    // Empty until the first item is added
+    const Inventory& getInventory() const;
     
     // Equip functions
     void equipWeapon(std::shared_ptr<Weapon> weapon);
     void equipArmor(std::shared_ptr<Armor> armor);
     
+    // Tile occupancy this character is registered in, kept current by move(); set by TileOccupancy
+    void setOccupancy(TileOccupancy* tileOccupancy, uint32_t id) { occupancy = tileOccupancy; occupantId = id; }
+    TileOccupancy* getOccupancy() const { return occupancy; }
+    uint32_t getOccupantId() const { return occupantId; }
+    
+    // Constants
+    static constexpr int EXPERIENCE_PER_LEVEL = 100; // Times the current level to reach the next
+    
 protected:
     std::string name;
     CharacterClass characterClass;
@@ -86,7 +112,15 @@ protected:
     int intelligence;
     float x, y; // Position
     
-    std::vector<std::shared_ptr<Item>> inventory;
+    // Created by the first addItem, so characters that never carry items (enemies) don't pay for one
+    std::unique_ptr<Inventory> inventory;
+    
+    TileOccupancy* occupancy = nullptr;
+    uint32_t occupantId = UINT32_MAX;
     
     void initializeStats();
+    
+    // Called after every move or health change so subclasses can keep external copies in step
+    virtual void onMoved() {}
+    virtual void onHealthChanged() {}
 }; 
\ No newline at end of file
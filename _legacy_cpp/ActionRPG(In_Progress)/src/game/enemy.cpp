@@ -1,19 +1,13 @@
 #include "enemy.h"
 #include "level.h"
-#include <iostream>
+#include "../engine/logger.h"
 #include <cmath>
+#include <cstdlib>
+#include <algorithm>
 
 Enemy::Enemy(const std::string& name, EnemyType type, int level)
     : Character(name, CharacterClass::WARRIOR), // Default to warrior stats
-      enemyType(type),
-      attackCooldown(2.0f),
-      currentCooldown(0.0f) {
-    
-    // Randomize initial movement timer to prevent enemies from moving in sync
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    static std::uniform_real_distribution<float> dist(0.0f, 0.5f);
-    movementTimer = dist(gen);
+      enemyType(type) {
     
     // Set level
     for (int i = 1; i < level; i++) {
@@ -31,6 +25,44 @@ Enemy::Enemy(const std::string& name, EnemyType type, int level)
 Enemy::~Enemy() {
 }
 
+void Enemy::seedRandom(uint64_t worldSeed, uint32_t enemyId) {
+    id = enemyId;
+    rng = Random::forStream(worldSeed, RandomStream::ENEMY, enemyId);
+    
+    // Randomize initial movement timer to prevent enemies from moving in sync
+    movementTimer() = rng.nextFloat() * 0.5f;
+}
+
+void Enemy::attachStore(EnemyStore* enemyStore) {
+    if (store) {
+        detachStore();
+    }
+    storeSlot = enemyStore->add(handle, detachedState, getX(), getY(), getHealth(), static_cast<uint8_t>(enemyType));
+    store = enemyStore;
+}
+
+void Enemy::detachStore() {
+    if (!store) {
+        return;
+    }
+    detachedState = store->remove(storeSlot);
+    store = nullptr;
+    storeSlot = EnemyStore::INVALID_SLOT;
+}
+
+void Enemy::onMoved() {
+    // Keep the store's copy current; the level's spatial index is updated by whoever moved us
+    if (store) {
+        store->setPosition(storeSlot, getX(), getY());
+    }
+}
+
+void Enemy::onHealthChanged() {
+    if (store) {
+        store->setHealth(storeSlot, getHealth());
+    }
+}
+
 void Enemy::initializeByType() {
     // Adjust stats based on enemy type
     switch (enemyType) {
@@ -40,7 +72,7 @@ void Enemy::initializeByType() {
             dexterity += 4;
             maxHealth = static_cast<int>(maxHealth * 0.8);
             health = maxHealth;
-            attackCooldown = 1.5f;
+            attackCooldown() = 1.5f;
             break;
             
         case EnemyType::SKELETON:
@@ -56,7 +88,7 @@ void Enemy::initializeByType() {
             dexterity -= 2;
             maxHealth = static_cast<int>(maxHealth * 1.2);
             health = maxHealth;
-            attackCooldown = 2.5f;
+            attackCooldown() = 2.5f;
             break;
             
         case EnemyType::TROLL:
@@ -65,7 +97,7 @@ void Enemy::initializeByType() {
             dexterity -= 4;
             maxHealth = static_cast<int>(maxHealth * 2.0);
             health = maxHealth;
-            attackCooldown = 3.0f;
+            attackCooldown() = 3.0f;
             break;
             
         case EnemyType::DRAGON:
@@ -75,7 +107,7 @@ void Enemy::initializeByType() {
             intelligence += 10;
             maxHealth = static_cast<int>(maxHealth * 5.0);
             health = maxHealth;
-            attackCooldown = 4.0f;
+            attackCooldown() = 4.0f;
             
             // Increase rewards for dragon
             experienceReward *= 5;
@@ -84,176 +116,219 @@ void Enemy::initializeByType() {
     }
 }
 
-void Enemy::update(float deltaTime, Character* player) {
+void Enemy::update(Level& level, float deltaTime, CharacterHandle target) {
+    EnemyIntent intent;
+    decide(level, deltaTime, level.resolve(target), intent);
+    commit(level, intent, target);
+}
+
+void Enemy::decide(const Level& level, float deltaTime, const Character* player, EnemyIntent& intent) {
+    intent = EnemyIntent();
+    
     // Skip update if player is null
     if (!player) {
         return;
     }
     
-    // Always ensure we have a level reference
-    if (!currentLevel) {
-        std::cerr << "Enemy " << getName() << " has no level reference!" << std::endl;
-        return;
-    }
-    
     // Update cooldowns
-    if (currentCooldown > 0) {
-        currentCooldown -= deltaTime;
+    if (currentCooldown() > 0) {
+        currentCooldown() -= deltaTime;
     }
     
     // Always update movement timer
-    movementTimer -= deltaTime;
+    movementTimer() -= deltaTime;
+    
+    // Distance and range flags from the level's classification pass
+    if (store) {
+        intent.distanceSquared = store->getDistanceSquared(storeSlot);
+        intent.rangeFlags = store->getFlags(storeSlot);
+    } else {
+        float dx = player->getX() - getX();
+        float dy = player->getY() - getY();
+        intent.distanceSquared = dx * dx + dy * dy;
+        intent.rangeFlags = (intent.distanceSquared < ATTACK_RANGE * ATTACK_RANGE ? EnemyStore::IN_ATTACK_RANGE : 0) |
+                            (intent.distanceSquared <= CHASE_RADIUS * CHASE_RADIUS ? EnemyStore::IN_CHASE_RADIUS : 0);
+    }
+    uint8_t rangeFlags = intent.rangeFlags;
     
-    // Calculate distance to player
-    float dx = player->getX() - getX();
-    float dy = player->getY() - getY();
-    float distance = std::sqrt(dx * dx + dy * dy);
+    // Next step toward the player from the shared flow field; none if the player can't be reached nearby
+    const FlowField& field = level.getPlayerFlowField();
+    int tileX = static_cast<int>(std::round(getX()));
+    int tileY = static_cast<int>(std::round(getY()));
+    int stepX = 0, stepY = 0;
+    bool canReachPlayer = field.getStep(tileX, tileY, stepX, stepY);
     
     // Debug output occasionally
     debugTimer += deltaTime;
     if (debugTimer > 5.0f) {
         debugTimer = 0.0f;
-        std::cout << "Enemy " << getName() << " at (" << getX() << ", " << getY() 
-                  << "), distance to player: " << distance 
-                  << ", movement timer: " << movementTimer << std::endl;
+        intent.logStatus = true;
     }
     
     // Attack if in range
-    if (distance < 1.5f) {
-        if (currentCooldown <= 0) {
-            // Attack player
-            attack(player);
-            currentCooldown = attackCooldown;
-            
-            // Debug attack
-            std::cout << "Enemy " << getName() << " attacking player!" << std::endl;
+    if (rangeFlags & EnemyStore::IN_ATTACK_RANGE) {
+        if (currentCooldown() <= 0) {
+            intent.action = EnemyIntent::Action::ATTACK;
         }
     } 
     // Always try to move if not attacking and within chase radius
-    else if (distance <= 10.0f) { // Increased to 10-block radius as requested
+    else if ((rangeFlags & EnemyStore::IN_CHASE_RADIUS) && canReachPlayer) {
         // Only wait for movement timer if we're very close to the player
-        if (movementTimer <= 0.0f || distance > 3.0f) {
-            // Debug output
-            std::cout << "Enemy " << getName() << " chasing player, distance: " << distance << std::endl;
+        if (movementTimer() <= 0.0f || intent.distanceSquared > 9.0f) {
+            intent.action = EnemyIntent::Action::CHASE;
             
-            // Always move towards player within chase radius
-            float moveX = 0.0f;
-            float moveY = 0.0f;
-            
-            // Normalize direction vector
-            if (distance > 0) {
-                moveX = dx / distance;
-                moveY = dy / distance;
+            // Follow the flow field around walls; any other neighbour one step closer
+            // is a fallback for when another enemy gets the preferred tile first
+            intent.candidateX[0] = tileX + stepX;
+            intent.candidateY[0] = tileY + stepY;
+            intent.candidateCount = 1;
+            int closer = field.getDistance(tileX, tileY) - 1;
+            for (int dy = -1; dy <= 1; dy++) {
+                for (int dx = -1; dx <= 1; dx++) {
+                    if ((dx == 0 && dy == 0) || (dx == stepX && dy == stepY)) continue;
+                    if (intent.candidateCount < EnemyIntent::MAX_CANDIDATES &&
+                        field.getDistance(tileX + dx, tileY + dy) == closer) {
+                        intent.candidateX[intent.candidateCount] = tileX + dx;
+                        intent.candidateY[intent.candidateCount] = tileY + dy;
+                        intent.candidateCount++;
+                    }
+                }
             }
-            
-            // Round to get grid-based movement (0, 1, or -1)
-            moveX = moveX > 0.3f ? 1.0f : (moveX < -0.3f ? -1.0f : 0.0f);
-            moveY = moveY > 0.3f ? 1.0f : (moveY < -0.3f ? -1.0f : 0.0f);
-            
-            // Make sure we have a valid movement direction
-            if (moveX == 0.0f && moveY == 0.0f) {
-                // Force a movement direction if both are zero
-                moveX = (dx >= 0) ? 1.0f : -1.0f;
+        }
+    } else {
+        // Patrol between nearby points when the player is out of reach
+        if (movementTimer() <= 0.0f) {
+            intent.action = EnemyIntent::Action::PATROL;
+        }
+    }
+}
+
+void Enemy::commit(Level& level, const EnemyIntent& intent, CharacterHandle target) {
+    if (intent.logStatus) {
+        LOG_TRACE(AI, "Enemy {} at ({}, {}), distance to player: {}, movement timer: {}", getName(), getX(), getY(),
+                  std::sqrt(intent.distanceSquared), movementTimer());
+    }
+    
+    switch (intent.action) {
+        case EnemyIntent::Action::ATTACK:
+            // Attack the player, unless it left the level since we decided
+            if (Character* player = level.resolve(target)) {
+                attack(*player);
             }
+            currentCooldown() = attackCooldown();
             
-            // Calculate new position
-            float newX = getX() + moveX;
-            float newY = getY() + moveY;
-            
-            // Check if new position is walkable
-            int tileX = static_cast<int>(std::round(newX));
-            int tileY = static_cast<int>(std::round(newY));
+            // Debug attack
+            LOG_DEBUG(COMBAT, "Enemy {} attacking player!", getName());
+            break;
             
-            bool moved = false;
+        case EnemyIntent::Action::CHASE:
+            // Debug output
+            LOG_TRACE(AI, "Enemy {} chasing player, distance: {}", getName(), std::sqrt(intent.distanceSquared));
             
-            if (currentLevel->isWalkable(tileX, tileY)) {
-                // Move enemy to the new position
-                move(newX, newY);
-                moved = true;
-            } else {
-                // If we can't move in the desired direction, try alternative directions
-                // Try horizontal movement first if vertical is blocked
-                if (moveY != 0.0f) {
-                    newY = getY(); // Keep Y the same
-                    tileY = static_cast<int>(std::round(newY));
-                    
-                    if (currentLevel->isWalkable(tileX, tileY)) {
-                        move(newX, newY);
-                        moved = true;
+            // Take the first candidate no one has claimed; if all are taken, wait and try again next frame
+            for (int i = 0; i < intent.candidateCount; i++) {
+                if (tryStep(level, intent.candidateX[i], intent.candidateY[i])) {
+                    // Set a shorter cooldown if we're far from the player to move faster
+                    if (intent.distanceSquared > 25.0f) {
+                        movementTimer() = movementCooldown() * 0.5f; // Move twice as fast when far away
+                    } else {
+                        movementTimer() = movementCooldown();
                     }
+                    break;
                 }
-                
-                // Try vertical movement if horizontal is blocked or was also blocked
-                if (!moved && moveX != 0.0f) {
-                    newX = getX(); // Keep X the same
-                    newY = getY() + moveY; // Use original moveY
-                    tileX = static_cast<int>(std::round(newX));
-                    tileY = static_cast<int>(std::round(newY));
-                    
-                    if (currentLevel->isWalkable(tileX, tileY)) {
-                        move(newX, newY);
-                        moved = true;
-                    }
-                }
-                
-                // If still blocked, try random directions
-                if (!moved) {
-                    // Try up to 8 directions (all surrounding tiles)
-                    for (int dy = -1; dy <= 1; dy++) {
-                        for (int dx = -1; dx <= 1; dx++) {
-                            if (dx == 0 && dy == 0) continue; // Skip center
-                            
-                            newX = getX() + dx;
-                            newY = getY() + dy;
-                            tileX = static_cast<int>(std::round(newX));
-                            tileY = static_cast<int>(std::round(newY));
-                            
-                            if (currentLevel->isWalkable(tileX, tileY)) {
-                                move(newX, newY);
-                                moved = true;
-                                break;
-                            }
-                        }
-                        if (moved) break;
-                    }
-                }
-            }
-            
-            // Set a shorter cooldown if we're far from the player to move faster
-            if (distance > 5.0f) {
-                movementTimer = movementCooldown * 0.5f; // Move twice as fast when far away
-            } else {
-                movementTimer = movementCooldown;
             }
-        }
-    } else {
-        // Random movement when outside chase radius (> 10 blocks)
-        if (movementTimer <= 0.0f) {
-            // Use non-static RNG for random movement
-            std::random_device rd;
-            std::mt19937 gen(rd());
-            std::uniform_int_distribution<> dir(-1, 1);
-            
-            float moveX = static_cast<float>(dir(gen));
-            float moveY = static_cast<float>(dir(gen));
+            break;
             
-            // Ensure we have movement
-            if (moveX == 0.0f && moveY == 0.0f) {
-                moveX = static_cast<float>(dir(gen) ? 1 : -1);
-            }
+        case EnemyIntent::Action::PATROL:
+            // Route requests touch the shared path service, so patrolling happens entirely here
+            updatePatrol(level, static_cast<int>(std::round(getX())), static_cast<int>(std::round(getY())));
             
-            // Calculate new position
-            float newX = getX() + moveX;
-            float newY = getY() + moveY;
-            int tileX = static_cast<int>(std::round(newX));
-            int tileY = static_cast<int>(std::round(newY));
+            // Longer cooldown for patrol movement
+            movementTimer() = movementCooldown() * 1.5f;
+            break;
             
-            if (currentLevel->isWalkable(tileX, tileY)) {
-                move(newX, newY);
+        case EnemyIntent::Action::NONE:
+            break;
+    }
+}
+
+float Enemy::getWakeDelay(const EnemyIntent& intent, const Character* player, EnemyTimer& kind) {
+    // Measured from where the commit left us, which may be a step closer than when deciding
+    float distanceSquared = intent.distanceSquared;
+    if (player) {
+        float dx = player->getX() - getX();
+        float dy = player->getY() - getY();
+        distanceSquared = dx * dx + dy * dy;
+    }
+    
+    // Next to the player only the attack cooldown matters
+    if (distanceSquared < ATTACK_RANGE * ATTACK_RANGE) {
+        kind = EnemyTimer::ATTACK_READY;
+        return std::max(currentCooldown(), 0.0f);
+    }
+    
+    // Distant chasers step every frame; everyone else waits for the movement timer
+    kind = EnemyTimer::MOVE_READY;
+    if (intent.action == EnemyIntent::Action::CHASE && distanceSquared > 9.0f) {
+        return 0.0f;
+    }
+    return std::max(movementTimer(), 0.0f);
+}
+
+bool Enemy::tryStep(Level& level, int x, int y) {
+    // Claim the tile first so no one else can step onto it; the move commits the claim
+    if (occupancy && !occupancy->tryReserve(occupantId, x, y)) {
+        return false;
+    }
+    move(static_cast<float>(x), static_cast<float>(y));
+    level.onEnemyMoved(*this);
+    return true;
+}
+
+void Enemy::cancelPatrol(PathService& paths) {
+    if (patrolTicket != PathService::INVALID_TICKET) {
+        paths.cancel(patrolTicket);
+        patrolTicket = PathService::INVALID_TICKET;
+    }
+    patrolPath.clear();
+    patrolIndex = 0;
+}
+
+void Enemy::updatePatrol(Level& level, int tileX, int tileY) {
+    PathService& paths = level.getPathService();
+    
+    // Collect the route once the path service has solved it
+    if (patrolTicket != PathService::INVALID_TICKET) {
+        if (paths.getStatus(patrolTicket) == PathStatus::PENDING) {
+            return;
+        }
+        patrolPath.clear();
+        paths.takePath(patrolTicket, patrolPath);
+        patrolTicket = PathService::INVALID_TICKET;
+        patrolIndex = 1; // The first point is where we already stand
+    }
+    
+    // Take the next step unless chasing has pulled us off the route
+    if (patrolIndex < patrolPath.size()) {
+        const PathPoint& next = patrolPath[patrolIndex];
+        if (std::abs(next.x - tileX) <= 1 && std::abs(next.y - tileY) <= 1 && level.isWalkable(next.x, next.y)) {
+            // Wait for whoever stands on the next point to move on
+            if (tryStep(level, next.x, next.y)) {
+                patrolIndex++;
             }
-            
-            // Longer cooldown for random movement
-            movementTimer = movementCooldown * 1.5f;
+            return;
+        }
+    }
+    
+    // Route finished or abandoned: pick a new patrol point nearby
+    patrolPath.clear();
+    patrolIndex = 0;
+    for (int attempt = 0; attempt < PATROL_POINT_ATTEMPTS; attempt++) {
+        int goalX = tileX + rng.nextInt(-PATROL_RADIUS, PATROL_RADIUS);
+        int goalY = tileY + rng.nextInt(-PATROL_RADIUS, PATROL_RADIUS);
+        if (level.isWalkable(goalX, goalY)) {
+            patrolTicket = paths.requestPath(tileX, tileY, goalX, goalY);
+            break;
         }
     }
 } 
\ No newline at end of file
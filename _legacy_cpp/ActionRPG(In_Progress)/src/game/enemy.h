@@ -1,8 +1,13 @@
 #pragma once
 
 #include "character.h"
+#include "path_service.h"
+#include "ai_lod.h"
+#include "random.h"
+#include "enemy_store.h"
+#include "entity_handle.h"
 #include <string>
-#include <random>
+#include <type_traits>
 
 enum class EnemyType {
     GOBLIN,
@@ -14,31 +19,117 @@ enum class EnemyType {
 
 class Level; // Forward declaration
 
+// What an enemy wants to do this tick, worked out from a read-only view of the world
+struct EnemyIntent {
+    enum class Action : uint8_t {
+        NONE,
+        ATTACK,
+        CHASE,
+        PATROL
+    };
+    static constexpr int MAX_CANDIDATES = 4;
+    
+    Action action = Action::NONE;
+    float distanceSquared = 0.0f;
+    uint8_t rangeFlags = 0;
+    bool logStatus = false;
+    
+    // Chase destinations in order of preference; the first one still free when committing is taken
+    int candidateCount = 0;
+    int candidateX[MAX_CANDIDATES];
+    int candidateY[MAX_CANDIDATES];
+};
+
 class Enemy : public Character {
 public:
     Enemy(const std::string& name, EnemyType type, int level);
     ~Enemy();
+    Enemy(Enemy&&) = default;
+    Enemy& operator=(Enemy&&) = default;
     
     EnemyType getEnemyType() const { return enemyType; }
     int getExperienceReward() const { return experienceReward; }
     int getGoldReward() const { return goldReward; }
     
-    // Set the level reference for collision detection
-    void setLevel(Level* level) { currentLevel = level; }
+    // This enemy's handle in the level that owns it; set by Level
+    void setHandle(EnemyHandle enemyHandle) { handle = enemyHandle; }
+    EnemyHandle getHandle() const { return handle; }
+    
+    // Derive this enemy's random stream from the world seed and its id within the level
+    void seedRandom(uint64_t worldSeed, uint32_t enemyId);
+    // Id within the level; also the enemy's priority when committing, lower first
+    uint32_t getId() const { return id; }
+    
+    // Move the AI timers into a level's enemy store, or back out of it
+    void attachStore(EnemyStore* enemyStore);
+    void detachStore();
+    // Called by Level when it moves this enemy to another slot
+    void setStoreSlot(EnemyStore::Slot slot) { storeSlot = slot; }
+    EnemyStore::Slot getStoreSlot() const { return storeSlot; }
+    
+    // AI behavior in two phases; both expect the store to have been classified against the player this frame.
+    // decide only reads the world and writes this enemy's own timers, so enemies can decide in parallel.
+    // commit applies the intent: moves claim their tile through the occupancy layer, attacks damage the
+    // target if it is still in the level.
+    void decide(const Level& level, float deltaTime, const Character* player, EnemyIntent& intent);
+    void commit(Level& level, const EnemyIntent& intent, CharacterHandle target);
+    // Both phases at once, for a lone enemy
+    void update(Level& level, float deltaTime, CharacterHandle target);
+    // After commit: how long until this enemy has something to do again, and what
+    float getWakeDelay(const EnemyIntent& intent, const Character* player, EnemyTimer& kind);
+    // Give up the patrol route, including a request the path service hasn't solved yet
+    void cancelPatrol(PathService& paths);
+    
+    // Constants
+    static constexpr float ATTACK_RANGE = 1.5f;
+    static constexpr float CHASE_RADIUS = 10.0f; // Increased to 10-block radius as requested
     
-    // AI behavior
-    void update(float deltaTime, Character* player);
+    // Level-of-detail scheduling state, managed by Level
+    AILodState& getLodState() { return lodState; }
+    const AILodState& getLodState() const { return lodState; }
+    
+    // Queued to leave the level at the end of the tick; set by Level
+    void setDespawnPending(bool pending) { despawnPending = pending; }
+    bool isDespawnPending() const { return despawnPending; }
     
 private:
     EnemyType enemyType;
     int experienceReward;
     int goldReward;
-    float attackCooldown;
-    float currentCooldown;
-    Level* currentLevel = nullptr; // Reference to the level for collision detection
-    float movementCooldown = 0.8f; // Time between enemy movements (Increased to slow them down)
-    float movementTimer = 0.0f;    // Current movement timer
+    EnemyHandle handle;
+    uint32_t id = 0;
     float debugTimer = 0.0f;       // Timer for debug output
     
+    // AI timers live in the level's store while attached, here otherwise
+    EnemyStore* store = nullptr;
+    EnemyStore::Slot storeSlot = EnemyStore::INVALID_SLOT;
+    EnemyHotState detachedState;
+    Random rng;                    // Own stream, so behaviour doesn't depend on update order
+    AILodState lodState;
+    bool despawnPending = false;
+    
+    // Patrol route, requested from the level's path service
+    PathService::Ticket patrolTicket = PathService::INVALID_TICKET;
+    std::vector<PathPoint> patrolPath;
+    size_t patrolIndex = 0;
+    
+    float& attackCooldown() { return store ? store->attackCooldown(storeSlot) : detachedState.attackCooldown; }
+    float& currentCooldown() { return store ? store->currentCooldown(storeSlot) : detachedState.currentCooldown; }
+    float& movementCooldown() { return store ? store->movementCooldown(storeSlot) : detachedState.movementCooldown; }
+    float& movementTimer() { return store ? store->movementTimer(storeSlot) : detachedState.movementTimer; }
+    
     void initializeByType();
-}; 
\ No newline at end of file
+    void updatePatrol(Level& level, int tileX, int tileY);
+    // Move one tile if no one else has it or claims it first
+    bool tryStep(Level& level, int x, int y);
+    void onMoved() override;
+    void onHealthChanged() override;
+    
+    // Constants
+    static constexpr int PATROL_RADIUS = 8;
+    static constexpr int PATROL_POINT_ATTEMPTS = 4;
+};
+
+// Level keeps enemies in a vector and relocates them by move
+static_assert(std::is_nothrow_move_constructible<Enemy>::value && std::is_nothrow_move_assignable<Enemy>::value,
+              "Enemy moves must not throw");
@@ -0,0 +1,110 @@
+#include "enemy_store.h"
+#include <utility>
+
+EnemyStore::EnemyStore() {
+}
+
+EnemyStore::~EnemyStore() {
+}
+
+EnemyStore::Slot EnemyStore::add(EnemyHandle owner, const EnemyHotState& state, float x, float y, int health, uint8_t type) {
+    Slot slot = static_cast<Slot>(owners.size());
+
+    positionsX.push_back(x);
+    positionsY.push_back(y);
+    healths.push_back(health);
+    currentCooldowns.push_back(state.currentCooldown);
+    movementTimers.push_back(state.movementTimer);
+    attackCooldowns.push_back(state.attackCooldown);
+    movementCooldowns.push_back(state.movementCooldown);
+    types.push_back(type);
+    distancesSquared.push_back(0.0f);
+    flags.push_back(0);
+    owners.push_back(owner);
+
+    return slot;
+}
+
+EnemyHotState EnemyStore::remove(Slot slot) {
+    EnemyHotState state;
+    state.currentCooldown = currentCooldowns[slot];
+    state.movementTimer = movementTimers[slot];
+    state.attackCooldown = attackCooldowns[slot];
+    state.movementCooldown = movementCooldowns[slot];
+
+    // Swap-and-pop every array; the level moves its own copy of the last enemy the same way
+    Slot last = static_cast<Slot>(owners.size() - 1);
+    if (slot != last) {
+        positionsX[slot] = positionsX[last];
+        positionsY[slot] = positionsY[last];
+        healths[slot] = healths[last];
+        currentCooldowns[slot] = currentCooldowns[last];
+        movementTimers[slot] = movementTimers[last];
+        attackCooldowns[slot] = attackCooldowns[last];
+        movementCooldowns[slot] = movementCooldowns[last];
+        types[slot] = types[last];
+        distancesSquared[slot] = distancesSquared[last];
+        flags[slot] = flags[last];
+        owners[slot] = owners[last];
+    }
+
+    positionsX.pop_back();
+    positionsY.pop_back();
+    healths.pop_back();
+    currentCooldowns.pop_back();
+    movementTimers.pop_back();
+    attackCooldowns.pop_back();
+    movementCooldowns.pop_back();
+    types.pop_back();
+    distancesSquared.pop_back();
+    flags.pop_back();
+    owners.pop_back();
+
+    return state;
+}
+
+void EnemyStore::swapSlots(Slot a, Slot b) {
+    std::swap(positionsX[a], positionsX[b]);
+    std::swap(positionsY[a], positionsY[b]);
+    std::swap(healths[a], healths[b]);
+    std::swap(currentCooldowns[a], currentCooldowns[b]);
+    std::swap(movementTimers[a], movementTimers[b]);
+    std::swap(attackCooldowns[a], attackCooldowns[b]);
+    std::swap(movementCooldowns[a], movementCooldowns[b]);
+    std::swap(types[a], types[b]);
+    std::swap(distancesSquared[a], distancesSquared[b]);
+    std::swap(flags[a], flags[b]);
+    std::swap(owners[a], owners[b]);
+}
+
+void EnemyStore::classify(float playerX, float playerY, float attackRange, float chaseRadius) {
+    // Plain indexed loop over local pointers with no branches or calls, so it vectorizes
+    const size_t count = owners.size();
+    const float* xs = positionsX.data();
+    const float* ys = positionsY.data();
+    const int32_t* hp = healths.data();
+    float* distances = distancesSquared.data();
+    uint8_t* out = flags.data();
+
+    const float attackRangeSquared = attackRange * attackRange;
+    const float chaseRadiusSquared = chaseRadius * chaseRadius;
+
+    for (size_t i = 0; i < count; i++) {
+        float dx = xs[i] - playerX;
+        float dy = ys[i] - playerY;
+        float distanceSquared = dx * dx + dy * dy;
+        distances[i] = distanceSquared;
+        out[i] = static_cast<uint8_t>((distanceSquared < attackRangeSquared ? IN_ATTACK_RANGE : 0) |
+                                      (distanceSquared <= chaseRadiusSquared ? IN_CHASE_RADIUS : 0) |
+                                      (hp[i] <= 0 ? DEAD : 0));
+    }
+}
+
+void EnemyStore::collectDead(std::vector<EnemyHandle>& out) const {
+    // Scans the health array rather than the flags, which may predate this frame's damage
+    for (size_t i = 0; i < healths.size(); i++) {
+        if (healths[i] <= 0) {
+            out.push_back(owners[i]);
+        }
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "entity_handle.h"
+
+// AI timers an enemy carries around; lives in the store while the enemy is in a level
+struct EnemyHotState {
+    float currentCooldown = 0.0f;   // Time until the next attack is allowed
+    float movementTimer = 0.0f;     // Time until the next step
+    float attackCooldown = 2.0f;    // Delay between attacks
+    float movementCooldown = 0.8f;  // Delay between steps
+};
+
+// Structure-of-arrays store for the per-frame enemy data of one level:
+// positions, health, AI timers, type and the result of the per-frame
+// classification against the player. Each array is contiguous so the
+// classification pass is a straight loop the compiler can vectorize. Names,
+// stats and other cold data stay on the Enemy objects. AI timers live only
+// here and enemies reach them through their slot; positions and health are
+// copies, since combat and the renderer still read them from Character, and
+// Enemy writes every change through to its slot.
+class EnemyStore {
+public:
+    using Slot = uint32_t;
+    static constexpr Slot INVALID_SLOT = UINT32_MAX;
+
+    // Classification bits
+    static constexpr uint8_t IN_ATTACK_RANGE = 1 << 0;
+    static constexpr uint8_t IN_CHASE_RADIUS = 1 << 1;
+    static constexpr uint8_t DEAD = 1 << 2;
+
+    EnemyStore();
+    ~EnemyStore();
+
+    // Slots are dense: removing one moves the last enemy into it. The level keeps
+    // its enemies in the same order, so a slot is also the enemy's index there.
+    Slot add(EnemyHandle owner, const EnemyHotState& state, float x, float y, int health, uint8_t type);
+    EnemyHotState remove(Slot slot);
+    // Exchange two enemies' data, for reordering
+    void swapSlots(Slot a, Slot b);
+    size_t size() const { return owners.size(); }
+
+    // Mirrors of Character state, kept current by the Enemy hooks
+    void setPosition(Slot slot, float x, float y) { positionsX[slot] = x; positionsY[slot] = y; }
+    void setHealth(Slot slot, int health) { healths[slot] = health; }
+
+    // AI timers
+    float& currentCooldown(Slot slot) { return currentCooldowns[slot]; }
+    float& movementTimer(Slot slot) { return movementTimers[slot]; }
+    float& attackCooldown(Slot slot) { return attackCooldowns[slot]; }
+    float& movementCooldown(Slot slot) { return movementCooldowns[slot]; }
+
+    EnemyHandle getOwner(Slot slot) const { return owners[slot]; }
+    uint8_t getType(Slot slot) const { return types[slot]; }
+
+    // Distance and range classification of every enemy against the player in one pass
+    void classify(float playerX, float playerY, float attackRange, float chaseRadius);
+    float getDistanceSquared(Slot slot) const { return distancesSquared[slot]; }
+    uint8_t getFlags(Slot slot) const { return flags[slot]; }
+
+    // Owners of every enemy whose health has reached zero
+    void collectDead(std::vector<EnemyHandle>& out) const;
+
+private:
+    // Hot data, one entry per slot
+    std::vector<float> positionsX;
+    std::vector<float> positionsY;
+    std::vector<int32_t> healths;
+    std::vector<float> currentCooldowns;
+    std::vector<float> movementTimers;
+    std::vector<float> attackCooldowns;
+    std::vector<float> movementCooldowns;
+    std::vector<uint8_t> types;
+
+    // Classification output
+    std::vector<float> distancesSquared;
+    std::vector<uint8_t> flags;
+
+    // Back references for gameplay lookups
+    std::vector<EnemyHandle> owners;
+};
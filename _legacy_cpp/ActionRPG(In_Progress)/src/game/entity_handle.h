@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Reference to an entity that survives its storage being compacted or
+// reordered; goes stale once the entity is released. T only tags the handle,
+// so an enemy handle can't be passed where a character handle is expected.
+template <typename T>
+struct EntityHandle {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool isValid() const { return index != UINT32_MAX; }
+    bool operator==(const EntityHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const EntityHandle& other) const { return !(*this == other); }
+};
+
+namespace std {
+    template <typename T>
+    struct hash<EntityHandle<T>> {
+        size_t operator()(const EntityHandle<T>& handle) const {
+            return hash<uint64_t>()((static_cast<uint64_t>(handle.generation) << 32) | handle.index);
+        }
+    };
+}
+
+// Maps handles to where their entity currently sits in its owner's dense
+// storage. The owner calls move() whenever it relocates an entity, and
+// release() when it removes one; the slot's generation then changes, so
+// every outstanding handle to it resolves to INVALID_INDEX instead of to
+// whatever takes the slot next. Slots are reused, handles never are.
+template <typename T>
+class HandleTable {
+public:
+    using Handle = EntityHandle<T>;
+    static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+    Handle create(uint32_t denseIndex) {
+        uint32_t slot;
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            slot = static_cast<uint32_t>(slots.size());
+            slots.emplace_back();
+        }
+        slots[slot].denseIndex = denseIndex;
+        liveCount++;
+
+        Handle handle;
+        handle.index = slot;
+        handle.generation = slots[slot].generation;
+        return handle;
+    }
+
+    // Returns false for a stale handle
+    bool release(Handle handle) {
+        if (!isAlive(handle)) {
+            return false;
+        }
+        Slot& slot = slots[handle.index];
+        slot.denseIndex = INVALID_INDEX;
+        slot.generation++;
+        freeSlots.push_back(handle.index);
+        liveCount--;
+        return true;
+    }
+
+    // The entity now lives at denseIndex
+    void move(Handle handle, uint32_t denseIndex) {
+        if (isAlive(handle)) {
+            slots[handle.index].denseIndex = denseIndex;
+        }
+    }
+
+    // Where the entity lives, or INVALID_INDEX once it is gone
+    uint32_t getIndex(Handle handle) const {
+        return isAlive(handle) ? slots[handle.index].denseIndex : INVALID_INDEX;
+    }
+
+    bool isAlive(Handle handle) const {
+        return handle.index < slots.size() && slots[handle.index].generation == handle.generation &&
+               slots[handle.index].denseIndex != INVALID_INDEX;
+    }
+
+    size_t size() const { return liveCount; }
+
+    // Releases everything; handles from before stay stale
+    void clear() {
+        for (uint32_t i = 0; i < slots.size(); i++) {
+            if (slots[i].denseIndex != INVALID_INDEX) {
+                slots[i].denseIndex = INVALID_INDEX;
+                slots[i].generation++;
+                freeSlots.push_back(i);
+            }
+        }
+        liveCount = 0;
+    }
+
+private:
+    struct Slot {
+        uint32_t denseIndex = INVALID_INDEX;
+        uint32_t generation = 0;
+    };
+
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    size_t liveCount = 0;
+};
+
+class Enemy;
+class Character;
+class ItemDrop;
+using EnemyHandle = EntityHandle<Enemy>;
+using CharacterHandle = EntityHandle<Character>;
+using ItemDropHandle = EntityHandle<ItemDrop>;
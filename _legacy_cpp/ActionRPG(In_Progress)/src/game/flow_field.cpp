@@ -0,0 +1,107 @@
+#include "flow_field.h"
+#include "level.h"
+#include <algorithm>
+#include <cstdlib>
+
+FlowField::FlowField()
+    : width(0), height(0), targetX(-1), targetY(-1), maxDistance(0), dirty(true), currentStamp(0) {
+}
+
+FlowField::~FlowField() {
+}
+
+void FlowField::reset(int newWidth, int newHeight) {
+    width = newWidth;
+    height = newHeight;
+    stamp.assign(width * height, 0);
+    distance.assign(width * height, 0);
+    direction.assign(width * height, NO_DIRECTION);
+    currentStamp = 0;
+    frontier.clear();
+    targetX = -1;
+    targetY = -1;
+    dirty = true;
+}
+
+bool FlowField::update(const Level& level, int newTargetX, int newTargetY, int newMaxDistance) {
+    if (!dirty && newTargetX == targetX && newTargetY == targetY && newMaxDistance == maxDistance) {
+        return false;
+    }
+
+    targetX = newTargetX;
+    targetY = newTargetY;
+    maxDistance = newMaxDistance;
+    dirty = false;
+    rebuild(level);
+    return true;
+}
+
+void FlowField::rebuild(const Level& level) {
+    // Bumping the stamp invalidates the previous field in O(1)
+    currentStamp++;
+    if (currentStamp == 0) {
+        std::fill(stamp.begin(), stamp.end(), 0);
+        currentStamp = 1;
+    }
+
+    frontier.clear();
+    if (!level.isWalkable(targetX, targetY)) {
+        return;
+    }
+
+    int targetCell = targetY * width + targetX;
+    stamp[targetCell] = currentStamp;
+    distance[targetCell] = 0;
+    direction[targetCell] = NO_DIRECTION;
+    frontier.push_back(targetCell);
+
+    // Every step costs one tile, diagonal or not, so plain BFS gives shortest paths
+    for (size_t head = 0; head < frontier.size(); head++) {
+        int cell = frontier[head];
+        int cellDistance = distance[cell];
+        if (cellDistance >= maxDistance) {
+            continue;
+        }
+
+        int x = cell % width;
+        int y = cell / width;
+        for (int d = 0; d < 8; d++) {
+            int nx = x + DIRECTION_X[d];
+            int ny = y + DIRECTION_Y[d];
+            if (nx < 0 || nx >= width || ny < 0 || ny >= height) continue;
+
+            int neighbour = ny * width + nx;
+            if (isReached(neighbour) || !level.isWalkable(nx, ny)) continue;
+
+            // The neighbour steps back along d to reach this cell
+            stamp[neighbour] = currentStamp;
+            distance[neighbour] = static_cast<uint16_t>(cellDistance + 1);
+            direction[neighbour] = static_cast<int8_t>(d);
+            frontier.push_back(neighbour);
+        }
+    }
+}
+
+bool FlowField::getStep(int x, int y, int& stepX, int& stepY) const {
+    if (x < 0 || x >= width || y < 0 || y >= height) {
+        return false;
+    }
+
+    int cell = y * width + x;
+    if (!isReached(cell) || direction[cell] == NO_DIRECTION) {
+        return false;
+    }
+
+    stepX = -DIRECTION_X[direction[cell]];
+    stepY = -DIRECTION_Y[direction[cell]];
+    return true;
+}
+
+int FlowField::getDistance(int x, int y) const {
+    if (x < 0 || x >= width || y < 0 || y >= height) {
+        return -1;
+    }
+
+    int cell = y * width + x;
+    return isReached(cell) ? distance[cell] : -1;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Level; // Forward declaration
+
+// Breadth-first flow field over the level's walkability grid, rooted at a
+// target tile (normally the player). Each reached cell stores the direction of
+// its next step toward the target, so any number of chasers can look up their
+// move in O(1). The search is bounded to a radius around the target and is
+// only rerun when the target changes tile or the walkability grid changes.
+class FlowField {
+public:
+    FlowField();
+    ~FlowField();
+
+    // Size the buffers for a level and forget the current field
+    void reset(int width, int height);
+
+    // Rebuild the field toward (targetX, targetY) if the target tile or the grid has changed.
+    // Returns true if the field was rebuilt.
+    bool update(const Level& level, int targetX, int targetY, int maxDistance);
+
+    // Force a rebuild on the next update (called when tiles change walkability)
+    void invalidate() { dirty = true; }
+
+    // Next step (each -1, 0 or 1) from (x, y) toward the target; false if the
+    // cell is outside the field, unreachable, or already the target
+    bool getStep(int x, int y, int& stepX, int& stepY) const;
+
+    // Steps from (x, y) to the target, or -1 if the cell was not reached
+    int getDistance(int x, int y) const;
+
+    int getTargetX() const { return targetX; }
+    int getTargetY() const { return targetY; }
+    size_t getReachedCellCount() const { return frontier.size(); }
+
+private:
+    int width;
+    int height;
+    int targetX;
+    int targetY;
+    int maxDistance;
+    bool dirty;
+
+    // Per-cell data is only valid where stamp matches currentStamp, so a
+    // rebuild never has to clear the whole grid
+    std::vector<uint32_t> stamp;
+    std::vector<uint16_t> distance;
+    std::vector<int8_t> direction;
+    uint32_t currentStamp;
+
+    // BFS queue; after a rebuild it holds every reached cell
+    std::vector<int> frontier;
+
+    void rebuild(const Level& level);
+    bool isReached(int cell) const { return stamp[cell] == currentStamp; }
+
+    // Constants
+    static constexpr int8_t NO_DIRECTION = -1;
+    static constexpr int DIRECTION_X[8] = {1, -1, 0, 0, 1, 1, -1, -1};
+    static constexpr int DIRECTION_Y[8] = {0, 0, 1, -1, 1, -1, 1, -1};
+};
@@ -0,0 +1,154 @@
+#include "inventory.h"
+#include <algorithm>
+
+Inventory::Inventory() {
+}
+
+Inventory::~Inventory() {
+}
+
+uint64_t Inventory::stackKey(const ItemInstance& item) {
+    return (static_cast<uint64_t>(item.definition) << 32) | (static_cast<uint64_t>(item.rarity) << 16) |
+           static_cast<uint16_t>(item.stat);
+}
+
+Inventory::Slot Inventory::add(const ItemInstance& item) {
+    if (!item.isValid() || item.stackCount == 0) {
+        return INVALID_SLOT;
+    }
+
+    const ItemDefinition& definition = item.getDefinition();
+    uint16_t maxStack = definition.maxStack;
+    uint64_t key = stackKey(item);
+    int remaining = item.stackCount;
+    Slot slot = INVALID_SLOT;
+
+    // Fill open stacks first
+    if (maxStack > 1) {
+        while (remaining > 0) {
+            auto it = openStacks.find(key);
+            if (it == openStacks.end()) {
+                break;
+            }
+            slot = it->second;
+            ItemInstance& stack = items[slot];
+            int taken = std::min(remaining, maxStack - static_cast<int>(stack.stackCount));
+            stack.stackCount = static_cast<uint16_t>(stack.stackCount + taken);
+            remaining -= taken;
+            if (stack.stackCount >= maxStack) {
+                openStacks.erase(it);
+            }
+        }
+    }
+
+    // Then new stacks of at most maxStack
+    while (remaining > 0) {
+        ItemInstance stack = item;
+        stack.stackCount = static_cast<uint16_t>(std::min(remaining, static_cast<int>(maxStack)));
+        remaining -= stack.stackCount;
+        slot = addSlot(stack, definition.type);
+        if (maxStack > 1 && stack.stackCount < maxStack) {
+            openStacks[key] = slot;
+        }
+    }
+    return slot;
+}
+
+void Inventory::consume(Slot slot, uint16_t count) {
+    if (slot >= items.size()) {
+        return;
+    }
+    ItemInstance& stack = items[slot];
+    if (stack.stackCount <= count) {
+        remove(slot);
+        return;
+    }
+
+    stack.stackCount = static_cast<uint16_t>(stack.stackCount - count);
+    // Now has room; becomes the open stack unless another already is
+    openStacks.emplace(stackKey(stack), slot);
+}
+
+void Inventory::remove(Slot slot) {
+    if (slot >= items.size()) {
+        return;
+    }
+    unindex(slot);
+
+    // Move the last slot into the hole and point its index entries at the new place
+    Slot last = static_cast<Slot>(items.size() - 1);
+    if (slot != last) {
+        items[slot] = items[last];
+        entries[slot] = entries[last];
+        typeSlots[static_cast<int>(entries[slot].type)][entries[slot].typePosition] = slot;
+        raritySlots[items[slot].rarity][entries[slot].rarityPosition] = slot;
+
+        auto it = openStacks.find(stackKey(items[slot]));
+        if (it != openStacks.end() && it->second == last) {
+            it->second = slot;
+        }
+    }
+    items.pop_back();
+    entries.pop_back();
+}
+
+void Inventory::clear() {
+    items.clear();
+    entries.clear();
+    for (auto& slots : typeSlots) {
+        slots.clear();
+    }
+    for (auto& slots : raritySlots) {
+        slots.clear();
+    }
+    openStacks.clear();
+}
+
+Inventory::Slot Inventory::findFirst(ItemType type) const {
+    const auto& slots = typeSlots[static_cast<int>(type)];
+    return slots.empty() ? INVALID_SLOT : slots.front();
+}
+
+Inventory::Slot Inventory::findFirst(ItemRarity rarity) const {
+    const auto& slots = raritySlots[static_cast<int>(rarity)];
+    return slots.empty() ? INVALID_SLOT : slots.front();
+}
+
+Inventory::Slot Inventory::addSlot(const ItemInstance& item, ItemType type) {
+    Slot slot = static_cast<Slot>(items.size());
+    auto& slotsOfType = typeSlots[static_cast<int>(type)];
+    auto& slotsOfRarity = raritySlots[item.rarity];
+
+    Entry entry;
+    entry.type = type;
+    entry.typePosition = static_cast<uint32_t>(slotsOfType.size());
+    entry.rarityPosition = static_cast<uint32_t>(slotsOfRarity.size());
+
+    items.push_back(item);
+    entries.push_back(entry);
+    slotsOfType.push_back(slot);
+    slotsOfRarity.push_back(slot);
+    return slot;
+}
+
+void Inventory::unindex(Slot slot) {
+    const Entry& entry = entries[slot];
+
+    // Swap-and-pop out of the type and rarity lists
+    auto& slotsOfType = typeSlots[static_cast<int>(entry.type)];
+    Slot movedByType = slotsOfType.back();
+    slotsOfType[entry.typePosition] = movedByType;
+    entries[movedByType].typePosition = entry.typePosition;
+    slotsOfType.pop_back();
+
+    auto& slotsOfRarity = raritySlots[items[slot].rarity];
+    Slot movedByRarity = slotsOfRarity.back();
+    slotsOfRarity[entry.rarityPosition] = movedByRarity;
+    entries[movedByRarity].rarityPosition = entry.rarityPosition;
+    slotsOfRarity.pop_back();
+
+    auto it = openStacks.find(stackKey(items[slot]));
+    if (it != openStacks.end() && it->second == slot) {
+        openStacks.erase(it);
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "item_database.h"
+
+// Item storage for characters and stashes. Items sit densely in slots, each
+// tagged with its type so nothing needs RTTI or a definition lookup to tell
+// a potion from a sword. Slots are also listed per type and per rarity, and
+// stackable items remember one stack with room, so adding, removing and
+// "any potion?" are all O(1) however large the inventory gets.
+//
+// Removing a slot moves the last slot into its place.
+class Inventory {
+public:
+    using Slot = uint32_t;
+    static constexpr Slot INVALID_SLOT = UINT32_MAX;
+
+    Inventory();
+    ~Inventory();
+    Inventory(const Inventory&) = default;
+    Inventory& operator=(const Inventory&) = default;
+    Inventory(Inventory&&) = default;
+    Inventory& operator=(Inventory&&) = default;
+
+    // Tops up a matching stack with room before taking new slots; returns the last slot used
+    Slot add(const ItemInstance& item);
+    // Take count items off a stack; the slot goes once it is empty
+    void consume(Slot slot, uint16_t count = 1);
+    // Drop the whole slot, however many it holds
+    void remove(Slot slot);
+    void clear();
+
+    size_t size() const { return items.size(); }
+    bool empty() const { return items.empty(); }
+    const ItemInstance& operator[](Slot slot) const { return items[slot]; }
+    const std::vector<ItemInstance>& getItems() const { return items; }
+
+    // Cached when the item was added
+    ItemType getType(Slot slot) const { return entries[slot].type; }
+
+    // Some slot holding an item of the type or rarity, or INVALID_SLOT
+    Slot findFirst(ItemType type) const;
+    Slot findFirst(ItemRarity rarity) const;
+    const std::vector<Slot>& getSlots(ItemType type) const { return typeSlots[static_cast<int>(type)]; }
+    const std::vector<Slot>& getSlots(ItemRarity rarity) const { return raritySlots[static_cast<int>(rarity)]; }
+
+private:
+    static constexpr int TYPE_COUNT = static_cast<int>(ItemType::MISC) + 1;
+
+    // Per slot, alongside items
+    struct Entry {
+        ItemType type;
+        uint32_t typePosition;   // Index into typeSlots[type]
+        uint32_t rarityPosition; // Index into raritySlots[rarity]
+    };
+
+    std::vector<ItemInstance> items;
+    std::vector<Entry> entries;
+    std::vector<Slot> typeSlots[TYPE_COUNT];
+    std::vector<Slot> raritySlots[ITEM_RARITY_COUNT];
+
+    // One stack with room per kind of stackable item, keyed by stackKey
+    std::unordered_map<uint64_t, Slot> openStacks;
+
+    // Items only stack with others of the same definition, rarity and stat
+    static uint64_t stackKey(const ItemInstance& item);
+    Slot addSlot(const ItemInstance& item, ItemType type);
+    void unindex(Slot slot);
+};
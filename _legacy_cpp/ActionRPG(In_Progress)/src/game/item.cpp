@@ -1,6 +1,32 @@
 #include "item.h"
-#include <iostream>
-#include <sstream>
+#include "../engine/logger.h"
+#include <cstdio>
+
+namespace {
+    // Shown in front of the name in descriptions
+    const char* getRarityTag(ItemRarity rarity) {
+        switch (rarity) {
+            case ItemRarity::COMMON:
+                return "[Common] ";
+            case ItemRarity::UNCOMMON:
+                return "[Uncommon] ";
+            case ItemRarity::RARE:
+                return "[Rare] ";
+            case ItemRarity::EPIC:
+                return "[Epic] ";
+            case ItemRarity::LEGENDARY:
+                return "[Legendary] ";
+        }
+        return "";
+    }
+
+    // Formats in place; std::to_string would build a temporary string
+    void appendNumber(FrameString& text, int number) {
+        char digits[16];
+        std::snprintf(digits, sizeof(digits), "%d", number);
+        text += digits;
+    }
+}
 
 // Base Item implementation
 Item::Item(const std::string& name, ItemType type, ItemRarity rarity)
@@ -40,36 +66,24 @@ Weapon::~Weapon() {
 }
 
 void Weapon::use() {
-    std::cout << "You brandish the " << name << "." << std::endl;
+    LOG_INFO(ITEMS, "You brandish the {}.", name);
 }
 
-std::string Weapon::getDescription() const {
-    std::stringstream ss;
+FrameString Weapon::getDescription() const {
+    // Built in the frame arena; descriptions are only shown for the frame they were asked for
+    FrameString description(&FrameArena::get());
     
-    // Add rarity color (in a real game, we'd use actual colors)
-    switch (rarity) {
-        case ItemRarity::COMMON:
-            ss << "[Common] ";
-            break;
-        case ItemRarity::UNCOMMON:
-            ss << "[Uncommon] ";
-            break;
-        case ItemRarity::RARE:
-            ss << "[Rare] ";
-            break;
-        case ItemRarity::EPIC:
-            ss << "[Epic] ";
-            break;
-        case ItemRarity::LEGENDARY:
-            ss << "[Legendary] ";
-            break;
-    }
+    // Add rarity tag (in a real game, we'd use actual colors)
+    description += getRarityTag(rarity);
     
-    ss << name << "\n";
-    ss << "Damage: " << damage << "\n";
-    ss << "Value: " << value << " gold";
+    description += name;
+    description += "\nDamage: ";
+    appendNumber(description, damage);
+    description += "\nValue: ";
+    appendNumber(description, value);
+    description += " gold";
     
-    return ss.str();
+    return description;
 }
 
 // Armor implementation
@@ -83,36 +97,23 @@ Armor::~Armor() {
 }
 
 void Armor::use() {
-    std::cout << "You equip the " << name << "." << std::endl;
+    LOG_INFO(ITEMS, "You equip the {}.", name);
 }
 
-std::string Armor::getDescription() const {
-    std::stringstream ss;
+FrameString Armor::getDescription() const {
+    FrameString description(&FrameArena::get());
     
-    // Add rarity color
-    switch (rarity) {
-        case ItemRarity::COMMON:
-            ss << "[Common] ";
-            break;
-        case ItemRarity::UNCOMMON:
-            ss << "[Uncommon] ";
-            break;
-        case ItemRarity::RARE:
-            ss << "[Rare] ";
-            break;
-        case ItemRarity::EPIC:
-            ss << "[Epic] ";
-            break;
-        case ItemRarity::LEGENDARY:
-            ss << "[Legendary] ";
-            break;
-    }
+    // Add rarity tag
+    description += getRarityTag(rarity);
     
-    ss << name << "\n";
-    ss << "Defense: " << defense << "\n";
-    ss << "Value: " << value << " gold";
+    description += name;
+    description += "\nDefense: ";
+    appendNumber(description, defense);
+    description += "\nValue: ";
+    appendNumber(description, value);
+    description += " gold";
     
-    return ss.str();
+    return description;
 }
 
 // Potion implementation
@@ -126,34 +127,21 @@ Potion::~Potion() {
 }
 
 void Potion::use() {
-    std::cout << "You drink the " << name << " and restore " << healAmount << " health." << std::endl;
+    LOG_INFO(ITEMS, "You drink the {} and restore {} health.", name, healAmount);
 }
 
-std::string Potion::getDescription() const {
-    std::stringstream ss;
+FrameString Potion::getDescription() const {
+    FrameString description(&FrameArena::get());
     
-    // Add rarity color
-    switch (rarity) {
-        case ItemRarity::COMMON:
-            ss << "[Common] ";
-            break;
-        case ItemRarity::UNCOMMON:
-            ss << "[Uncommon] ";
-            break;
-        case ItemRarity::RARE:
-            ss << "[Rare] ";
-            break;
-        case ItemRarity::EPIC:
-            ss << "[Epic] ";
-            break;
-        case ItemRarity::LEGENDARY:
-            ss << "[Legendary] ";
-            break;
-    }
+    // Add rarity tag
+    description += getRarityTag(rarity);
     
-    ss << name << "\n";
-    ss << "Heals: " << healAmount << " HP\n";
-    ss << "Value: " << value << " gold";
+    description += name;
+    description += "\nHeals: ";
+    appendNumber(description, healAmount);
+    description += " HP\nValue: ";
+    appendNumber(description, value);
+    description += " gold";
     
-    return ss.str();
+    return description;
 } 
\ No newline at end of file
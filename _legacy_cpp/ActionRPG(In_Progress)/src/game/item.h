@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include "../engine/frame_arena.h"
 
 enum class ItemType {
     WEAPON,
@@ -36,7 +37,7 @@ public:
     
     // Virtual methods
     virtual void use() = 0;
-    virtual std::string getDescription() const = 0;
+    virtual FrameString getDescription() const = 0;
     
 protected:
     std::string name;
@@ -54,7 +55,7 @@ public:
     int getDamage() const { return damage; }
     
     void use() override;
-    std::string getDescription() const override;
+    FrameString getDescription() const override;
     
 private:
     int damage;
@@ -68,7 +69,7 @@ public:
     int getDefense() const { return defense; }
     
     void use() override;
-    std::string getDescription() const override;
+    FrameString getDescription() const override;
     
 private:
     int defense;
@@ -82,7 +83,7 @@ public:
     int getHealAmount() const { return healAmount; }
     
     void use() override;
-    std::string getDescription() const override;
+    FrameString getDescription() const override;
     
 private:
     int healAmount;
@@ -0,0 +1,159 @@
+#include "item_database.h"
+#include <algorithm>
+#include <iostream>
+
+// ItemInstance implementation
+const ItemDefinition& ItemInstance::getDefinition() const {
+    return ItemDatabase::get().getDefinition(definition);
+}
+
+const std::string& ItemInstance::getName() const {
+    return ItemDatabase::get().getName(getDefinition().name);
+}
+
+int ItemInstance::getValue() const {
+    return ItemDatabase::getRarityValue(getRarity()) + stat * getDefinition().valuePerStat;
+}
+
+std::shared_ptr<Item> ItemInstance::toItem() const {
+    switch (getType()) {
+        case ItemType::WEAPON:
+            return std::make_shared<Weapon>(getName(), getRarity(), stat);
+        case ItemType::ARMOR:
+            return std::make_shared<Armor>(getName(), getRarity(), stat);
+        case ItemType::POTION:
+            return std::make_shared<Potion>(getName(), getRarity(), stat);
+        default:
+            return nullptr;
+    }
+}
+
+// ItemDatabase implementation
+ItemDatabase::ItemDatabase() {
+    // Loot dropped by enemies
+    addDefinition("Sword", ItemType::WEAPON, 5, 2, {0, 3, 7, 12, 20}, 5, 1);
+    addDefinition("Armor", ItemType::ARMOR, 3, 1, {0, 2, 4, 7, 12}, 7, 1);
+    addDefinition("Potion", ItemType::POTION, 10, 3, {0, 5, 15, 30, 50}, 2, 20);
+
+    // Starting equipment and items placed in rooms
+    addDefinition("Iron Sword", ItemType::WEAPON, 10, 0, {0, 0, 0, 0, 0}, 5, 1);
+    addDefinition("Wooden Bow", ItemType::WEAPON, 5, 0, {0, 0, 0, 0, 0}, 5, 1);
+    addDefinition("Apprentice Staff", ItemType::WEAPON, 7, 0, {0, 0, 0, 0, 0}, 5, 1);
+    addDefinition("Leather Armor", ItemType::ARMOR, 5, 0, {0, 0, 0, 0, 0}, 7, 1);
+    addDefinition("Light Leather Armor", ItemType::ARMOR, 3, 0, {0, 0, 0, 0, 0}, 7, 1);
+    addDefinition("Cloth Robe", ItemType::ARMOR, 2, 0, {0, 0, 0, 0, 0}, 7, 1);
+    addDefinition("Health Potion", ItemType::POTION, 20, 0, {0, 0, 0, 0, 0}, 2, 20);
+    addDefinition("Small Health Potion", ItemType::POTION, 10, 0, {0, 0, 0, 0, 0}, 2, 20);
+}
+
+ItemDatabase::~ItemDatabase() {
+}
+
+const ItemDatabase& ItemDatabase::get() {
+    static const ItemDatabase database;
+    return database;
+}
+
+NameId ItemDatabase::intern(const std::string& name) {
+    auto it = nameIds.find(name);
+    if (it != nameIds.end()) {
+        return it->second;
+    }
+    NameId id = static_cast<NameId>(names.size());
+    names.push_back(name);
+    nameIds.emplace(name, id);
+    return id;
+}
+
+ItemDefId ItemDatabase::addDefinition(const std::string& name, ItemType type, int baseStat, int statPerLevel,
+                                      const int (&rarityStatBonus)[ITEM_RARITY_COUNT], int valuePerStat, uint16_t maxStack) {
+    if (definitions.size() >= INVALID_ITEM_DEFINITION) {
+        std::cerr << "Too many item definitions, cannot add " << name << std::endl;
+        return INVALID_ITEM_DEFINITION;
+    }
+
+    ItemDefinition definition;
+    definition.name = intern(name);
+    definition.type = type;
+    definition.baseStat = baseStat;
+    definition.statPerLevel = statPerLevel;
+    std::copy(rarityStatBonus, rarityStatBonus + ITEM_RARITY_COUNT, definition.rarityStatBonus);
+    definition.valuePerStat = valuePerStat;
+    definition.maxStack = std::max<uint16_t>(maxStack, 1);
+
+    ItemDefId id = static_cast<ItemDefId>(definitions.size());
+    definitions.push_back(definition);
+    definitionsByName.emplace(definition.name, id);
+    return id;
+}
+
+ItemDefId ItemDatabase::findDefinition(const std::string& name) const {
+    auto nameIt = nameIds.find(name);
+    if (nameIt == nameIds.end()) {
+        return INVALID_ITEM_DEFINITION;
+    }
+    auto it = definitionsByName.find(nameIt->second);
+    return it != definitionsByName.end() ? it->second : INVALID_ITEM_DEFINITION;
+}
+
+ItemDefId ItemDatabase::findDefinition(ItemType type) const {
+    for (size_t i = 0; i < definitions.size(); i++) {
+        if (definitions[i].type == type) {
+            return static_cast<ItemDefId>(i);
+        }
+    }
+    return INVALID_ITEM_DEFINITION;
+}
+
+int ItemDatabase::getRarityValue(ItemRarity rarity) {
+    switch (rarity) {
+        case ItemRarity::COMMON:
+            return 10;
+        case ItemRarity::UNCOMMON:
+            return 25;
+        case ItemRarity::RARE:
+            return 100;
+        case ItemRarity::EPIC:
+            return 500;
+        case ItemRarity::LEGENDARY:
+            return 2000;
+    }
+    return 0;
+}
+
+ItemRarity ItemDatabase::rollRarity(int roll, int enemyLevel) {
+    int rarityValue = roll + enemyLevel * 5;
+
+    if (rarityValue > 95) {
+        return ItemRarity::LEGENDARY;
+    } else if (rarityValue > 80) {
+        return ItemRarity::EPIC;
+    } else if (rarityValue > 60) {
+        return ItemRarity::RARE;
+    } else if (rarityValue > 30) {
+        return ItemRarity::UNCOMMON;
+    }
+    return ItemRarity::COMMON;
+}
+
+ItemInstance ItemDatabase::createInstance(ItemDefId id, ItemRarity rarity, int stat) const {
+    ItemInstance instance;
+    if (id >= definitions.size()) {
+        return instance;
+    }
+    instance.definition = id;
+    instance.rarity = static_cast<uint8_t>(rarity);
+    instance.stackCount = 1;
+    instance.stat = static_cast<int16_t>(std::max(-32768, std::min(stat, 32767)));
+    return instance;
+}
+
+ItemInstance ItemDatabase::rollInstance(ItemDefId id, ItemRarity rarity, int enemyLevel) const {
+    if (id >= definitions.size()) {
+        return ItemInstance();
+    }
+    const ItemDefinition& definition = definitions[id];
+    int stat = definition.baseStat + definition.statPerLevel * enemyLevel +
+               definition.rarityStatBonus[static_cast<int>(rarity)];
+    return createInstance(id, rarity, stat);
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "item.h"
+
+using ItemDefId = uint16_t;
+using NameId = uint32_t;
+
+static constexpr ItemDefId INVALID_ITEM_DEFINITION = UINT16_MAX;
+static constexpr int ITEM_RARITY_COUNT = static_cast<int>(ItemRarity::LEGENDARY) + 1;
+
+// Everything items of one kind share. Instances only carry what was rolled.
+struct ItemDefinition {
+    NameId name;
+    ItemType type;
+    int baseStat;      // Damage, defense or heal amount before level and rarity
+    int statPerLevel;  // Added per level of the enemy that dropped it
+    int rarityStatBonus[ITEM_RARITY_COUNT];
+    int valuePerStat;
+    uint16_t maxStack;
+};
+
+// One item in a drop or an inventory. Plain 8-byte value; names, base stats
+// and everything else shared comes from the definition.
+struct ItemInstance {
+    ItemDefId definition = INVALID_ITEM_DEFINITION;
+    uint8_t rarity = 0;
+    uint16_t stackCount = 1;
+    int16_t stat = 0; // Damage, defense or heal amount depending on the type
+
+    bool isValid() const { return definition != INVALID_ITEM_DEFINITION; }
+    ItemRarity getRarity() const { return static_cast<ItemRarity>(rarity); }
+    const ItemDefinition& getDefinition() const;
+    ItemType getType() const { return getDefinition().type; }
+    const std::string& getName() const;
+    int getValue() const;
+
+    // Polymorphic view for the inventory UI, which still works with Item; allocates
+    std::shared_ptr<Item> toItem() const;
+};
+
+// Registry of item definitions with interned names and the rarity tables.
+// The built-in definitions are registered on first use and never change, so
+// the shared database can be read from any thread.
+class ItemDatabase {
+public:
+    // Built-in definitions, in registration order
+    enum BuiltinItem : ItemDefId {
+        SWORD,
+        ARMOR,
+        POTION,
+        IRON_SWORD,
+        WOODEN_BOW,
+        APPRENTICE_STAFF,
+        LEATHER_ARMOR,
+        LIGHT_LEATHER_ARMOR,
+        CLOTH_ROBE,
+        HEALTH_POTION,
+        SMALL_HEALTH_POTION,
+        BUILTIN_COUNT
+    };
+
+    ItemDatabase();
+    ~ItemDatabase();
+
+    // The game's database, holding the built-in definitions
+    static const ItemDatabase& get();
+
+    // Same id for the same string, for the database's lifetime
+    NameId intern(const std::string& name);
+    const std::string& getName(NameId id) const { return names[id]; }
+
+    ItemDefId addDefinition(const std::string& name, ItemType type, int baseStat, int statPerLevel,
+                            const int (&rarityStatBonus)[ITEM_RARITY_COUNT], int valuePerStat, uint16_t maxStack);
+    const ItemDefinition& getDefinition(ItemDefId id) const { return definitions[id]; }
+    size_t getDefinitionCount() const { return definitions.size(); }
+    // INVALID_ITEM_DEFINITION if no definition has that name
+    ItemDefId findDefinition(const std::string& name) const;
+    // First definition of a type, for items whose own definition is unknown
+    ItemDefId findDefinition(ItemType type) const;
+
+    // Rarity tables
+    static int getRarityValue(ItemRarity rarity);
+    // roll is 0..100; higher enemy levels shift it towards rarer results
+    static ItemRarity rollRarity(int roll, int enemyLevel);
+
+    // Instance with an explicit stat
+    ItemInstance createInstance(ItemDefId id, ItemRarity rarity, int stat) const;
+    // Instance with the stat a drop from an enemy of this level gets
+    ItemInstance rollInstance(ItemDefId id, ItemRarity rarity, int enemyLevel) const;
+
+private:
+    // Deque so references returned by getName stay valid as names are added
+    std::deque<std::string> names;
+    std::unordered_map<std::string, NameId> nameIds;
+    std::vector<ItemDefinition> definitions;
+    std::unordered_map<NameId, ItemDefId> definitionsByName;
+};
@@ -1,9 +1,9 @@
 #include "item_drop.h"
+#include "../engine/logger.h"
 #include <cmath>
-#include <iostream>
 
 // ItemDrop implementation
-ItemDrop::ItemDrop(std::shared_ptr<Item> item, float x, float y)
+ItemDrop::ItemDrop(const ItemInstance& item, float x, float y)
     : item(item), x(x), y(y), hoverOffset(0.0f), hoverDirection(1.0f), rotationAngle(0.0f) {
 }
 
@@ -34,13 +34,11 @@ void ItemDrop::update(float deltaTime) {
     }
 }
 
-std::vector<Vertex> ItemDrop::generateVertices() const {
-    std::vector<Vertex> vertices;
-    
+void ItemDrop::appendVertices(FrameVector<Vertex>& vertices) const {
     // Get item color based on rarity
     float r = 1.0f, g = 1.0f, b = 1.0f; // Default white
     
-    switch (item->getRarity()) {
+    switch (item.getRarity()) {
         case ItemRarity::COMMON:
             r = 0.8f; g = 0.8f; b = 0.8f; // Gray
             break;
@@ -68,7 +66,7 @@ std::vector<Vertex> ItemDrop::generateVertices() const {
     float cosR = cos(rotationAngle);
     float sinR = sin(rotationAngle);
     
-    switch (item->getType()) {
+    switch (item.getType()) {
         case ItemType::WEAPON: {
             // Sword shape (elongated rectangle)
             float width = size * 0.3f;
@@ -212,8 +210,6 @@ std::vector<Vertex> ItemDrop::generateVertices() const {
             break;
         }
     }
-    
-    return vertices;
 }
 
 // ItemDropManager implementation
@@ -223,44 +219,67 @@ ItemDropManager::ItemDropManager() {
 ItemDropManager::~ItemDropManager() {
 }
 
-void ItemDropManager::addItemDrop(std::shared_ptr<Item> item, float x, float y) {
-    auto itemDrop = std::make_shared<ItemDrop>(item, x, y);
-    itemDrops.push_back(itemDrop);
-    std::cout << "Item dropped: " << item->getName() << " at position (" << x << ", " << y << ")" << std::endl;
+void ItemDropManager::setWorldSize(int width, int height) {
+    grid.reset(width, height, GRID_CELL_SIZE);
+    for (size_t i = 0; i < itemDrops.size(); i++) {
+        grid.insert(dropHandles[i], itemDrops[i].getX(), itemDrops[i].getY());
+    }
+}
+
+ItemDropHandle ItemDropManager::addItemDrop(const ItemInstance& item, float x, float y) {
+    ItemDropHandle handle = handles.create(static_cast<uint32_t>(itemDrops.size()));
+    itemDrops.emplace_back(item, x, y);
+    dropHandles.push_back(handle);
+    grid.insert(handle, x, y);
+    LOG_DEBUG(ITEMS, "Item dropped: {} at position ({}, {})", item.getName(), x, y);
+    return handle;
 }
 
-void ItemDropManager::removeItemDrop(size_t index) {
-    if (index < itemDrops.size()) {
-        auto item = itemDrops[index]->getItem();
-        std::cout << "Item picked up: " << item->getName() << std::endl;
-        
-        itemDrops.erase(itemDrops.begin() + index);
+bool ItemDropManager::removeItemDrop(ItemDropHandle handle) {
+    uint32_t index = handles.getIndex(handle);
+    if (index == HandleTable<ItemDrop>::INVALID_INDEX) {
+        return false;
+    }
+    LOG_DEBUG(ITEMS, "Item picked up: {}", itemDrops[index].getItem().getName());
+    
+    // Swap-and-pop the dense arrays; the grid is keyed by handle so only the handle table changes
+    uint32_t last = static_cast<uint32_t>(itemDrops.size() - 1);
+    if (index != last) {
+        itemDrops[index] = std::move(itemDrops[last]);
+        dropHandles[index] = dropHandles[last];
+        handles.move(dropHandles[index], index);
     }
+    itemDrops.pop_back();
+    dropHandles.pop_back();
+    
+    grid.remove(handle);
+    handles.release(handle);
+    return true;
+}
+
+const ItemDrop* ItemDropManager::getItemDrop(ItemDropHandle handle) const {
+    uint32_t index = handles.getIndex(handle);
+    return index != HandleTable<ItemDrop>::INVALID_INDEX ? &itemDrops[index] : nullptr;
 }
 
 void ItemDropManager::update(float deltaTime) {
     for (auto& itemDrop : itemDrops) {
-        itemDrop->update(deltaTime);
+        itemDrop.update(deltaTime);
     }
 }
 
-std::vector<Vertex> ItemDropManager::generateAllItemVertices() const {
-    std::vector<Vertex> allVertices;
+FrameVector<Vertex> ItemDropManager::generateAllItemVertices() const {
+    FrameVector<Vertex> allVertices(&FrameArena::get());
     
     for (const auto& itemDrop : itemDrops) {
-        auto vertices = itemDrop->generateVertices();
-        allVertices.insert(allVertices.end(), vertices.begin(), vertices.end());
+        itemDrop.appendVertices(allVertices);
     }
     
     return allVertices;
 }
 
-int ItemDropManager::getPickupItemIndex(float playerX, float playerY) const {
-    for (size_t i = 0; i < itemDrops.size(); i++) {
-        if (itemDrops[i]->canPickup(playerX, playerY)) {
-            return static_cast<int>(i);
-        }
-    }
-    
-    return -1; // No item in range
+ItemDropHandle ItemDropManager::getPickupItemHandle(float playerX, float playerY) const {
+    ItemDropHandle handle;
+    grid.findNearest(playerX, playerY, ItemDrop::getPickupRadius(), handle);
+    return handle; // Invalid if no item in range
 }
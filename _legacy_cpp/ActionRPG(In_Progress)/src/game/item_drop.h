@@ -1,30 +1,35 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <vector>
-#include "item.h"
+#include "entity_handle.h"
+#include "item_database.h"
+#include "spatial_grid.h"
 #include "../engine/vertex.h"
+#include "../engine/frame_arena.h"
 
 // Represents an item that exists in the game world and can be picked up
 class ItemDrop {
 public:
-    ItemDrop(std::shared_ptr<Item> item, float x, float y);
+    ItemDrop(const ItemInstance& item, float x, float y);
     ~ItemDrop();
     
     // Getters
-    std::shared_ptr<Item> getItem() const { return item; }
+    const ItemInstance& getItem() const { return item; }
     float getX() const { return x; }
     float getY() const { return y; }
     
     // Check if player is close enough to pick up the item
     bool canPickup(float playerX, float playerY) const;
+    static float getPickupRadius() { return PICKUP_RADIUS; }
     
     // Visual effects
     void update(float deltaTime);
-    std::vector<Vertex> generateVertices() const;
+    void appendVertices(FrameVector<Vertex>& vertices) const;
     
 private:
-    std::shared_ptr<Item> item;
+    ItemInstance item;
     float x, y;
     
     // Visual properties
@@ -39,30 +44,50 @@ private:
     static constexpr float ROTATION_SPEED = 1.0f;
 };
 
-// Class to manage all item drops in the game
+// Class to manage all item drops in the game. Drops are stored densely for
+// update and render; handles go through a HandleTable, so adding and removing
+// are O(1) and a picked-up drop's handle can never reach a newer one.
 class ItemDropManager {
 public:
     ItemDropManager();
     ~ItemDropManager();
     
+    // Size the spatial index for the level the drops live in
+    void setWorldSize(int width, int height);
+    
     // Add a new item drop to the world
-    void addItemDrop(std::shared_ptr<Item> item, float x, float y);
+    ItemDropHandle addItemDrop(const ItemInstance& item, float x, float y);
+    
+    // Remove an item drop (when picked up); returns false for a stale handle
+    bool removeItemDrop(ItemDropHandle handle);
     
-    // Remove an item drop (when picked up)
-    void removeItemDrop(size_t index);
+    // nullptr once the drop is gone
+    const ItemDrop* getItemDrop(ItemDropHandle handle) const;
     
     // Update all item drops
     void update(float deltaTime);
     
     // Generate vertices for rendering all item drops
-    std::vector<Vertex> generateAllItemVertices() const;
+    FrameVector<Vertex> generateAllItemVertices() const;
+    
+    // Nearest drop the player can pick up, or an invalid handle
+    ItemDropHandle getPickupItemHandle(float playerX, float playerY) const;
     
-    // Check if player can pick up any items and return the index if possible
-    int getPickupItemIndex(float playerX, float playerY) const;
+    // All item drops, densely packed in no particular order
+    const std::vector<ItemDrop>& getItemDrops() const { return itemDrops; }
+    size_t getItemDropCount() const { return itemDrops.size(); }
     
-    // Get all item drops
-    const std::vector<std::shared_ptr<ItemDrop>>& getItemDrops() const { return itemDrops; }
+    // Handles of item drops by position
+    const SpatialGrid<ItemDropHandle>& getGrid() const { return grid; }
     
 private:
-    std::vector<std::shared_ptr<ItemDrop>> itemDrops;
+    // Dense drop storage and, in parallel, the handle of each drop
+    std::vector<ItemDrop> itemDrops;
+    std::vector<ItemDropHandle> dropHandles;
+    
+    HandleTable<ItemDrop> handles;
+    SpatialGrid<ItemDropHandle> grid;
+    
+    // Constants
+    static constexpr float GRID_CELL_SIZE = 4.0f;
 };
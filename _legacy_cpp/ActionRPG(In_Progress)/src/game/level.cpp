@@ -1,8 +1,47 @@
 #include "level.h"
 #include <algorithm>
-#include <random>
 #include <ctime>
 #include <iostream>
+#include <cstdlib>
+#include <limits>
+#include <cmath>
+#include "../engine/allocation_tracker.h"
+
+namespace {
+    // Interleaves the bits of x and y, so cells that are close get close codes
+    uint32_t mortonCode(uint32_t x, uint32_t y) {
+        auto spread = [](uint32_t value) {
+            value &= 0xFFFF;
+            value = (value | (value << 8)) & 0x00FF00FF;
+            value = (value | (value << 4)) & 0x0F0F0F0F;
+            value = (value | (value << 2)) & 0x33333333;
+            value = (value | (value << 1)) & 0x55555555;
+            return value;
+        };
+        return spread(x) | (spread(y) << 1);
+    }
+    
+    // FNV-1a over raw bytes; floats are hashed by bit pattern, so any drift shows
+    void hashBytes(uint64_t& hash, const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+    }
+    
+    template <typename T>
+    void hashValue(uint64_t& hash, const T& value) {
+        hashBytes(hash, &value, sizeof(value));
+    }
+    
+    void hashCharacter(uint64_t& hash, const Character& character) {
+        hashValue(hash, character.getX());
+        hashValue(hash, character.getY());
+        hashValue(hash, character.getHealth());
+        hashValue(hash, character.getLevel());
+        hashValue(hash, character.getExperience());
+    }
+}
 
 Level::Level(int width, int height) : width(width), height(height) {
     // Initialize all tiles as walls
@@ -12,9 +51,16 @@ Level::Level(int width, int height) : width(width), height(height) {
         tile.explored = false;
         tile.visible = false;
     }
+    walkableIndex.reset(width, height);
+    playerFlowField.reset(width, height);
+    pathService.reset(width, height);
+    enemyGrid.reset(width, height, SPATIAL_CELL_SIZE);
+    occupancy.reset(width, height);
+    itemDropManager.setWorldSize(width, height);
 }
 
 Level::~Level() {
+    occupancy.clear();
 }
 
 Tile Level::getTile(int x, int y) const {
@@ -32,7 +78,29 @@ Tile Level::getTile(int x, int y) const {
 
 void Level::setTile(int x, int y, TileType type) {
     if (x >= 0 && x < width && y >= 0 && y < height) {
+        bool wasWalkable = isWalkable(x, y);
         tiles[y * width + x].type = type;
+        
+        // Keep the walkable-cell index in step with the tiles
+        bool nowWalkable = isWalkable(x, y);
+        if (nowWalkable && !wasWalkable) {
+            walkableIndex.addCell(x, y);
+        } else if (wasWalkable && !nowWalkable) {
+            walkableIndex.removeCell(x, y);
+        }
+        
+        if (nowWalkable != wasWalkable) {
+            playerFlowField.invalidate();
+            pathService.onTileChanged(x, y, nowWalkable);
+        }
+    }
+}
+
+void Level::setTileState(int x, int y, const Tile& tile) {
+    if (x >= 0 && x < width && y >= 0 && y < height) {
+        setTile(x, y, tile.type);
+        tiles[y * width + x].explored = tile.explored;
+        tiles[y * width + x].visible = tile.visible;
     }
 }
 
@@ -46,108 +114,262 @@ bool Level::isWalkable(int x, int y) const {
 }
 
 void Level::generateDungeon() {
-    // Simple dungeon generation algorithm
-    std::mt19937 rng(static_cast<unsigned int>(std::time(nullptr)));
+    generateDungeon(static_cast<unsigned int>(std::time(nullptr)));
+}
+
+void Level::generateDungeon(unsigned int dungeonSeed, const std::function<void(float)>& onProgress) {
+    // Room-graph dungeon: scatter rooms, join them with a minimum spanning tree
+    // of corridors so the floor is a single walkable region, then populate them
+    setSeed(dungeonSeed);
+    Random rng = Random::forStream(seed, RandomStream::LAYOUT);
     
     // Create a few random rooms
     int numRooms = 5 + rng() % 10;
+    std::vector<Room> rooms = placeRooms(rng, numRooms);
     
-    for (int i = 0; i < numRooms; i++) {
-        int roomWidth = 3 + rng() % 8;
-        int roomHeight = 3 + rng() % 6;
-        int x = rng() % (width - roomWidth - 2) + 1;
-        int y = rng() % (height - roomHeight - 2) + 1;
-        
-        createRoom(x, y, x + roomWidth, y + roomHeight);
+    for (const auto& room : rooms) {
+        createRoom(room.x, room.y, room.x + room.width, room.y + room.height);
+    }
+    connectRooms(rooms, rng);
+    
+    for (size_t i = 0; i < rooms.size(); i++) {
+        if (onProgress) {
+            onProgress(static_cast<float>(i) / rooms.size());
+        }
+        populateRoom(rooms[i], rng);
+    }
+    
+    findPlayerStart();
+    
+    if (onProgress) {
+        onProgress(1.0f);
+    }
+}
+
+std::vector<Level::Room> Level::placeRooms(Random& rng, int count) {
+    std::vector<Room> rooms;
+    
+    // Reject rooms that overlap (with a one-tile margin) so each room stays distinct
+    for (int attempt = 0; attempt < count * 10 && static_cast<int>(rooms.size()) < count; attempt++) {
+        Room room;
+        room.width = 3 + rng() % 8;
+        room.height = 3 + rng() % 6;
+        room.x = rng() % (width - room.width - 2) + 1;
+        room.y = rng() % (height - room.height - 2) + 1;
         
-        // Connect to previous room
-        if (i > 0) {
-            // Get center of current room
-            int newX = x + roomWidth / 2;
-            int newY = y + roomHeight / 2;
-            
-            // Get center of previous room
-            int prevX = rng() % (width - 4) + 2;
-            int prevY = rng() % (height - 4) + 2;
-            
-            // Create corridor between rooms
-            if (rng() % 2 == 0) {
-                createCorridor(prevX, prevY, newX, prevY);
-                createCorridor(newX, prevY, newX, newY);
-            } else {
-                createCorridor(prevX, prevY, prevX, newY);
-                createCorridor(prevX, newY, newX, newY);
+        bool overlaps = false;
+        for (const auto& other : rooms) {
+            if (room.x <= other.x + other.width + 1 && other.x <= room.x + room.width + 1 &&
+                room.y <= other.y + other.height + 1 && other.y <= room.y + room.height + 1) {
+                overlaps = true;
+                break;
             }
         }
         
-        // Add enemies to the room
-        int numEnemies = rng() % 3;
-        for (int j = 0; j < numEnemies; j++) {
-            int enemyX = x + 1 + rng() % (roomWidth - 2);
-            int enemyY = y + 1 + rng() % (roomHeight - 2);
-            
-            // Create random enemy type based on level depth
-            EnemyType type;
-            int roll = rng() % 100;
-            if (roll < 50) {
-                type = EnemyType::GOBLIN;
-            } else if (roll < 80) {
-                type = EnemyType::SKELETON;
-            } else if (roll < 95) {
-                type = EnemyType::ORC;
-            } else {
-                type = EnemyType::TROLL;
+        if (!overlaps) {
+            rooms.push_back(room);
+        }
+    }
+    
+    return rooms;
+}
+
+void Level::connectRooms(const std::vector<Room>& rooms, Random& rng) {
+    if (rooms.size() < 2) {
+        return;
+    }
+    
+    auto distance = [&rooms](size_t a, size_t b) {
+        return std::abs(rooms[a].centerX() - rooms[b].centerX()) + std::abs(rooms[a].centerY() - rooms[b].centerY());
+    };
+    
+    auto carve = [this, &rooms, &rng](size_t a, size_t b) {
+        int fromX = rooms[a].centerX(), fromY = rooms[a].centerY();
+        int toX = rooms[b].centerX(), toY = rooms[b].centerY();
+        
+        // L-shaped corridor, bending either way
+        if (rng() % 2 == 0) {
+            createCorridor(fromX, fromY, toX, fromY);
+            createCorridor(toX, fromY, toX, toY);
+        } else {
+            createCorridor(fromX, fromY, fromX, toY);
+            createCorridor(fromX, toY, toX, toY);
+        }
+    };
+    
+    // Prim's algorithm over room centres (room counts are small, so O(n^2) is fine)
+    std::vector<bool> inTree(rooms.size(), false);
+    std::vector<int> bestDistance(rooms.size(), std::numeric_limits<int>::max());
+    std::vector<size_t> bestParent(rooms.size(), 0);
+    bestDistance[0] = 0;
+    
+    for (size_t step = 0; step < rooms.size(); step++) {
+        size_t next = rooms.size();
+        for (size_t i = 0; i < rooms.size(); i++) {
+            if (!inTree[i] && (next == rooms.size() || bestDistance[i] < bestDistance[next])) {
+                next = i;
             }
-            
-            // Create enemy with random level (1-3)
-            int enemyLevel = 1 + rng() % 3;
-            std::string enemyName;
-            
-            switch (type) {
-                case EnemyType::GOBLIN:
-                    enemyName = "Goblin";
-                    break;
-                case EnemyType::SKELETON:
-                    enemyName = "Skeleton";
-                    break;
-                case EnemyType::ORC:
-                    enemyName = "Orc";
-                    break;
-                case EnemyType::TROLL:
-                    enemyName = "Troll";
-                    break;
-                case EnemyType::DRAGON:
-                    enemyName = "Dragon";
-                    break;
+        }
+        
+        inTree[next] = true;
+        if (step > 0) {
+            carve(bestParent[next], next);
+        }
+        
+        for (size_t i = 0; i < rooms.size(); i++) {
+            if (!inTree[i] && distance(next, i) < bestDistance[i]) {
+                bestDistance[i] = distance(next, i);
+                bestParent[i] = next;
             }
-            
-            auto enemy = std::make_shared<Enemy>(enemyName, type, enemyLevel);
-            enemy->move(static_cast<float>(enemyX), static_cast<float>(enemyY));
-            addEnemy(enemy);
         }
+    }
+    
+    // A few extra corridors add loops so the layout is not a pure tree
+    size_t extraCorridors = rooms.size() / 4;
+    for (size_t i = 0; i < extraCorridors; i++) {
+        size_t a = rng() % rooms.size();
+        size_t b = rng() % rooms.size();
+        if (a != b) {
+            carve(a, b);
+        }
+    }
+}
+
+void Level::populateRoom(const Room& room, Random& rng) {
+    int x = room.x;
+    int y = room.y;
+    int roomWidth = room.width;
+    int roomHeight = room.height;
+    
+    // Add enemies to the room
+    int numEnemies = rng() % 3;
+    for (int j = 0; j < numEnemies; j++) {
+        // Position, type and level rolls for this enemy in one batch
+        uint32_t rolls[4];
+        rng.fill(rolls, 4);
+        int enemyX = x + 1 + rolls[0] % (roomWidth - 2);
+        int enemyY = y + 1 + rolls[1] % (roomHeight - 2);
         
-        // Add items to the room
-        if (rng() % 3 == 0) {
-            int itemX = x + 1 + rng() % (roomWidth - 2);
-            int itemY = y + 1 + rng() % (roomHeight - 2);
-            
-            // Create random item
-            int itemRoll = rng() % 100;
-            std::shared_ptr<Item> item;
-            
-            if (itemRoll < 40) {
-                // Create potion
-                item = std::make_shared<Potion>("Health Potion", ItemRarity::COMMON, 20);
-            } else if (itemRoll < 70) {
-                // Create weapon
-                item = std::make_shared<Weapon>("Iron Sword", ItemRarity::UNCOMMON, 10);
-            } else {
-                // Create armor
-                item = std::make_shared<Armor>("Leather Armor", ItemRarity::UNCOMMON, 5);
+        // Never stack enemies on one tile
+        if (occupancy.isOccupied(enemyX, enemyY)) {
+            continue;
+        }
+        
+        // Create random enemy type based on level depth
+        EnemyType type;
+        int roll = rolls[2] % 100;
+        if (roll < 50) {
+            type = EnemyType::GOBLIN;
+        } else if (roll < 80) {
+            type = EnemyType::SKELETON;
+        } else if (roll < 95) {
+            type = EnemyType::ORC;
+        } else {
+            type = EnemyType::TROLL;
+        }
+        
+        // Create enemy with random level (1-3)
+        int enemyLevel = 1 + rolls[3] % 3;
+        std::string enemyName;
+        
+        switch (type) {
+            case EnemyType::GOBLIN:
+                enemyName = "Goblin";
+                break;
+            case EnemyType::SKELETON:
+                enemyName = "Skeleton";
+                break;
+            case EnemyType::ORC:
+                enemyName = "Orc";
+                break;
+            case EnemyType::TROLL:
+                enemyName = "Troll";
+                break;
+            case EnemyType::DRAGON:
+                enemyName = "Dragon";
+                break;
+        }
+        
+        Enemy enemy(enemyName, type, enemyLevel);
+        enemy.move(static_cast<float>(enemyX), static_cast<float>(enemyY));
+        addEnemy(std::move(enemy));
+    }
+    
+    // Add items to the room
+    if (rng() % 3 == 0) {
+        int itemX = x + 1 + rng() % (roomWidth - 2);
+        int itemY = y + 1 + rng() % (roomHeight - 2);
+        
+        // Create random item
+        int itemRoll = rng() % 100;
+        const ItemDatabase& database = ItemDatabase::get();
+        ItemInstance item;
+        
+        if (itemRoll < 40) {
+            // Create potion
+            item = database.createInstance(ItemDatabase::HEALTH_POTION, ItemRarity::COMMON, 20);
+        } else if (itemRoll < 70) {
+            // Create weapon
+            item = database.createInstance(ItemDatabase::IRON_SWORD, ItemRarity::UNCOMMON, 10);
+        } else {
+            // Create armor
+            item = database.createInstance(ItemDatabase::LEATHER_ARMOR, ItemRarity::UNCOMMON, 5);
+        }
+        
+        addItem(item, static_cast<float>(itemX), static_cast<float>(itemY));
+    }
+}
+
+void Level::findPlayerStart() {
+    // Start somewhere in the largest connected area so most of the floor is reachable
+    Random rng = Random::forStream(seed, RandomStream::PLAYER_START);
+    int x = 0, y = 0;
+    if (sampleWalkable(rng, walkableIndex.getLargestRegion(), x, y)) {
+        playerStartX = x;
+        playerStartY = y;
+    }
+}
+
+bool Level::areConnected(int x1, int y1, int x2, int y2) const {
+    int region = walkableIndex.getRegion(x1, y1);
+    return region >= 0 && region == walkableIndex.getRegion(x2, y2);
+}
+
+bool Level::sampleWalkable(Random& rng, int region, int& outX, int& outY) const {
+    return walkableIndex.sample(rng, region, outX, outY);
+}
+
+bool Level::sampleWalkableAwayFrom(Random& rng, int fromX, int fromY, int minDistance, bool sameRegion,
+                                   int& outX, int& outY) const {
+    int region = sameRegion ? walkableIndex.getRegion(fromX, fromY) : -1;
+    if (sameRegion && region < 0) {
+        return false;
+    }
+    return walkableIndex.sampleAwayFrom(rng, region, fromX, fromY, minDistance, outX, outY);
+}
+
+void Level::spawnWanderingEnemies(int count, int minDistanceFromStart) {
+    // A separate stream of the level seed keeps spawns reproducible
+    Random rng = Random::forStream(seed, RandomStream::SPAWNS);
+    
+    for (int i = 0; i < count; i++) {
+        // Pick a free tile in the player's region outside the exclusion zone
+        int x = 0, y = 0;
+        bool found = false;
+        for (int attempt = 0; attempt < SPAWN_ATTEMPTS && !found; attempt++) {
+            if (!sampleWalkableAwayFrom(rng, playerStartX, playerStartY, minDistanceFromStart, true, x, y)) {
+                return;
             }
-            
-            addItem(item, static_cast<float>(itemX), static_cast<float>(itemY));
+            found = !occupancy.isOccupied(x, y);
+        }
+        if (!found) {
+            continue;
         }
+        
+        // Create and add the enemy
+        Enemy enemy("Enemy", EnemyType::GOBLIN, 1);
+        enemy.move(static_cast<float>(x), static_cast<float>(y));
+        addEnemy(std::move(enemy));
     }
 }
 
@@ -195,134 +417,491 @@ void Level::createCorridor(int x1, int y1, int x2, int y2) {
     }
 }
 
-void Level::addEnemy(std::shared_ptr<Enemy> enemy) {
-    // Set the level reference for the enemy
-    enemy->setLevel(this);
-    enemies.push_back(enemy);
+void Level::setSeed(unsigned int newSeed) {
+    seed = newSeed;
+    lootRandom = Random::forStream(seed, RandomStream::LOOT);
+}
+
+EnemyHandle Level::addEnemy(Enemy enemy) {
+    // Hand out a handle to the new slot and give the enemy its own random stream
+    EnemyHandle handle = enemyHandles.create(static_cast<uint32_t>(enemies.size()));
+    enemies.push_back(std::move(enemy));
+    Enemy& added = enemies.back();
+    added.setHandle(handle);
+    added.seedRandom(seed, nextEnemyId++);
+    added.getLodState().lastTickTime = levelTime;
+    enemyGrid.insert(handle, added.getX(), added.getY());
+    added.attachStore(&enemyStore);
+    registerOccupant(&added);
+    return handle;
 }
 
-void Level::removeEnemy(std::shared_ptr<Enemy> enemy) {
-    auto it = std::find(enemies.begin(), enemies.end(), enemy);
-    if (it != enemies.end()) {
-        enemies.erase(it);
+void Level::removeEnemy(EnemyHandle enemy) {
+    if (Enemy* removed = resolve(enemy)) {
+        queueDespawn(*removed);
     }
 }
 
-void Level::addItem(std::shared_ptr<Item> item, float x, float y) {
-    itemDropManager.addItemDrop(item, x, y);
+void Level::removeEnemyAt(uint32_t index) {
+    Enemy& enemy = enemies[index];
+    enemyHandles.release(enemy.getHandle());
+    
+    // The store swap-pops the slot; do the same here so the two stay in step
+    enemy.detachStore();
+    uint32_t last = static_cast<uint32_t>(enemies.size() - 1);
+    if (index != last) {
+        enemies[index] = std::move(enemies[last]);
+        placeEnemy(index);
+    }
+    enemies.pop_back();
+}
+
+void Level::placeEnemy(uint32_t index) {
+    Enemy& enemy = enemies[index];
+    enemy.setStoreSlot(index);
+    enemyHandles.move(enemy.getHandle(), index);
 }
 
-int Level::getPickupItemIndex(float playerX, float playerY) const {
-    return itemDropManager.getPickupItemIndex(playerX, playerY);
+uint64_t Level::computeChecksum() const {
+    uint64_t hash = 14695981039346656037ull;
+    hashValue(hash, levelTime);
+    
+    // Storage order is itself deterministic: removals and compaction happen on fixed ticks
+    for (const Enemy& enemy : enemies) {
+        hashValue(hash, enemy.getId());
+        hashCharacter(hash, enemy);
+    }
+    for (const CharacterEntry& entry : characters) {
+        hashCharacter(hash, *entry.character);
+    }
+    for (const ItemDrop& drop : itemDropManager.getItemDrops()) {
+        hashValue(hash, drop.getX());
+        hashValue(hash, drop.getY());
+    }
+    return hash;
 }
 
-std::shared_ptr<Item> Level::pickupItem(int index) {
-    if (index < 0) {
-        return nullptr;
+void Level::compactEnemies() {
+    ticksSinceCompaction = 0;
+    uint32_t count = static_cast<uint32_t>(enemies.size());
+    
+    // Sort by the Morton code of each enemy's grid cell, then by id so the order is reproducible
+    compactionKeys.resize(count);
+    compactionOrder.resize(count);
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t cellX = static_cast<uint32_t>(std::max(0.0f, enemies[i].getX()) / SPATIAL_CELL_SIZE);
+        uint32_t cellY = static_cast<uint32_t>(std::max(0.0f, enemies[i].getY()) / SPATIAL_CELL_SIZE);
+        compactionKeys[i] = (static_cast<uint64_t>(mortonCode(cellX, cellY)) << 32) | enemies[i].getId();
+        compactionOrder[i] = i;
     }
+    std::sort(compactionOrder.begin(), compactionOrder.end(),
+              [this](uint32_t a, uint32_t b) { return compactionKeys[a] < compactionKeys[b]; });
     
-    // Get the item before removing it from the manager
-    auto itemDrops = itemDropManager.getItemDrops();
-    if (index >= static_cast<int>(itemDrops.size())) {
-        return nullptr;
+    // Apply the order in place with swaps, mirrored in the store. Positions tracks where each
+    // enemy is now, originals which enemy is at each position.
+    compactionPositions.resize(count);
+    compactionOriginals.resize(count);
+    for (uint32_t i = 0; i < count; i++) {
+        compactionPositions[i] = i;
+        compactionOriginals[i] = i;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t wanted = compactionOrder[i];
+        uint32_t from = compactionPositions[wanted];
+        if (from == i) {
+            continue;
+        }
+        std::swap(enemies[i], enemies[from]);
+        enemyStore.swapSlots(i, from);
+        uint32_t displaced = compactionOriginals[i];
+        compactionOriginals[from] = displaced;
+        compactionPositions[displaced] = from;
+        compactionOriginals[i] = wanted;
+        compactionPositions[wanted] = i;
     }
     
-    auto item = itemDrops[index]->getItem();
-    itemDropManager.removeItemDrop(index);
-    return item;
+    // Hand back what a crowd that has since died left behind
+    if (enemies.capacity() > 2 * static_cast<size_t>(count) + MIN_ENEMIES_PER_WORKER) {
+        enemies.shrink_to_fit();
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        placeEnemy(i);
+    }
 }
 
-void Level::update(float deltaTime, Character* player) {
-    // Update all enemies
-    for (auto it = enemies.begin(); it != enemies.end();) {
-        auto& enemy = *it;
-        
-        // Update enemy
-        enemy->update(deltaTime, player);
-        
-        // Check if enemy is dead
+void Level::addDespawnHook(DespawnHook hook) {
+    despawnHooks.push_back(std::move(hook));
+}
+
+void Level::queueDespawn(Enemy& enemy) {
+    if (!enemy.isDespawnPending()) {
+        enemy.setDespawnPending(true);
+        despawnQueue.push_back(enemy.getHandle());
+    }
+}
+
+void Level::processDespawns(Character* player) {
+    if (despawnQueue.empty()) {
+        return;
+    }
+    
+    // Nothing moves until the removals at the end, so the pointers hold until then
+    despawnedEnemies.clear();
+    for (EnemyHandle handle : despawnQueue) {
+        despawnedEnemies.push_back(resolve(handle));
+    }
+    
+    // Take everyone out of the spatial structures first, so alerts below only reach survivors
+    for (Enemy* enemy : despawnedEnemies) {
+        detachEnemy(*enemy);
+    }
+    
+    // Loot and noise where each one fell; experience goes to the player in one award
+    int experience = 0;
+    for (Enemy* enemy : despawnedEnemies) {
         if (enemy->isDead()) {
-            // Drop loot at enemy position
             dropLoot(enemy->getX(), enemy->getY(), enemy->getLevel());
-            
-            // Remove dead enemy
-            it = enemies.erase(it);
-        } else {
-            ++it;
+            alertEnemies(enemy->getX(), enemy->getY(), ALERT_RADIUS);
+            experience += enemy->getExperienceReward();
+        }
+    }
+    if (player && experience > 0) {
+        player->gainExperience(experience);
+    }
+    
+    for (auto& hook : despawnHooks) {
+        hook(despawnedEnemies);
+    }
+    
+    // One pass over the alert list instead of a search per enemy; the awake list is rebuilt next tick
+    alertedEnemies.erase(std::remove_if(alertedEnemies.begin(), alertedEnemies.end(),
+                                        [this](EnemyHandle enemy) { return resolve(enemy)->isDespawnPending(); }),
+                         alertedEnemies.end());
+    awakeEnemies.clear();
+    
+    // Swap-and-pop each one out; this is where enemies move
+    for (EnemyHandle handle : despawnQueue) {
+        removeEnemyAt(enemyHandles.getIndex(handle));
+    }
+    despawnQueue.clear();
+}
+
+CharacterHandle Level::addCharacter(Character* character) {
+    registerOccupant(character);
+    CharacterHandle handle = characterHandles.create(static_cast<uint32_t>(characters.size()));
+    characters.push_back(CharacterEntry{character, handle});
+    return handle;
+}
+
+void Level::removeCharacter(CharacterHandle character) {
+    uint32_t index = characterHandles.getIndex(character);
+    if (index == HandleTable<Character>::INVALID_INDEX) {
+        return;
+    }
+    unregisterOccupant(characters[index].character);
+    removeObserver(character);
+    characterHandles.release(character);
+    
+    characters[index] = characters.back();
+    characterHandles.move(characters[index].handle, index);
+    characters.pop_back();
+}
+
+void Level::registerOccupant(Character* character) {
+    if (character->getOccupancy()) {
+        character->getOccupancy()->remove(character->getOccupantId());
+    }
+    occupancy.add(character, true);
+}
+
+void Level::unregisterOccupant(Character* character) {
+    if (character->getOccupancy() == &occupancy) {
+        occupancy.remove(character->getOccupantId());
+    }
+}
+
+bool Level::canEnter(int x, int y, const Character* character) const {
+    if (!isWalkable(x, y)) {
+        return false;
+    }
+    if (character->getOccupancy() != &occupancy) {
+        return !occupancy.isOccupied(x, y);
+    }
+    return occupancy.isFreeFor(x, y, character->getOccupantId());
+}
+
+void Level::onEnemyMoved(const Enemy& enemy) {
+    enemyGrid.update(enemy.getHandle(), enemy.getX(), enemy.getY());
+}
+
+EnemyHandle Level::findNearestEnemy(float x, float y, float maxDistance) const {
+    EnemyHandle nearest;
+    enemyGrid.findNearest(x, y, maxDistance, [this](EnemyHandle enemy) { return !resolve(enemy)->isDead(); }, nearest);
+    return nearest;
+}
+
+void Level::addItem(const ItemInstance& item, float x, float y) {
+    itemDropManager.addItemDrop(item, x, y);
+}
+
+ItemDropHandle Level::getPickupItemHandle(float playerX, float playerY) const {
+    return itemDropManager.getPickupItemHandle(playerX, playerY);
+}
+
+bool Level::pickupItem(ItemDropHandle handle, ItemInstance& item) {
+    // Get the item before removing it from the manager
+    const ItemDrop* itemDrop = itemDropManager.getItemDrop(handle);
+    if (!itemDrop) {
+        return false;
+    }
+    
+    item = itemDrop->getItem();
+    itemDropManager.removeItemDrop(handle);
+    return true;
+}
+
+void Level::update(float deltaTime, CharacterHandle playerHandle) {
+    // Pathing and enemy decisions; the despawns and drops at the end are charged to loot
+    AllocationScope aiScope(AllocationTag::AI);
+    Character* player = resolve(playerHandle);
+    
+    // Refresh the chase field once, only if the player changed tile, before any enemy reads it
+    if (player) {
+        playerFlowField.update(*this, static_cast<int>(std::round(player->getX())),
+                               static_cast<int>(std::round(player->getY())), FLOW_FIELD_RADIUS);
+    }
+    
+    // Serve queued path requests; results are picked up by their enemies from the next update on
+    if (deterministic) {
+        pathService.processCount(*this, PATH_BUDGET_REQUESTS);
+    } else {
+        pathService.process(*this, PATH_BUDGET_MICROSECONDS);
+    }
+    
+    // Fire wake-ups that came due: enemies whose cooldowns ran out, alerts that expired
+    levelTime += deltaTime;
+    int timersFired = 0;
+    enemyTimers.advance(deltaTime, [this, &timersFired](EnemyHandle enemy, uint8_t kind) {
+        timersFired++;
+        if (static_cast<EnemyTimer>(kind) == EnemyTimer::ALERT_EXPIRY) {
+            alertedEnemies.erase(std::remove(alertedEnemies.begin(), alertedEnemies.end(), enemy), alertedEnemies.end());
+        } else if (Enemy* woken = resolve(enemy)) {
+            woken->getLodState().due = true;
+        }
+    });
+    
+    // Work out which enemies are awake this frame and in which tier
+    gatherAwakeEnemies(player);
+    lodStats.timersFired = timersFired;
+    
+    // The player stepping onto another tile changes the ranges of everyone around
+    if (player) {
+        int playerTileX = static_cast<int>(std::round(player->getX()));
+        int playerTileY = static_cast<int>(std::round(player->getY()));
+        if (playerTileX != lastPlayerTileX || playerTileY != lastPlayerTileY) {
+            lastPlayerTileX = playerTileX;
+            lastPlayerTileY = playerTileY;
+            enemyGrid.forEachInRadius(player->getX(), player->getY(), Enemy::CHASE_RADIUS + 1.0f,
+                                      [this](EnemyHandle enemy, float, float) { resolve(enemy)->getLodState().due = true; });
         }
     }
     
+    // Distance and range checks for every enemy in one vectorized pass over the store
+    if (player) {
+        enemyStore.classify(player->getX(), player->getY(), Enemy::ATTACK_RANGE, Enemy::CHASE_RADIUS);
+    }
+    
+    // Pick the awake enemies that are due; each is credited with all the time since its last update
+    // so cooldowns carry over between wake-ups and tiers
+    scheduledEnemies.clear();
+    for (Enemy* enemy : awakeEnemies) {
+        AILodState& lod = enemy->getLodState();
+        float elapsed = levelTime - lod.lastTickTime;
+        if (!lod.due || enemy->isDespawnPending() || (lod.tier == AILodTier::MID && elapsed < LOD_MID_INTERVAL)) {
+            continue;
+        }
+        
+        scheduledEnemies.push_back({enemy, std::min(elapsed, LOD_MAX_CATCH_UP)});
+        lod.lastTickTime = levelTime;
+        lod.due = false;
+        lodStats.updatedCount++;
+    }
+    
+    // Commit order is by enemy id, so results don't depend on how the work was split
+    std::sort(scheduledEnemies.begin(), scheduledEnemies.end(),
+              [](const ScheduledEnemy& a, const ScheduledEnemy& b) { return a.enemy->getId() < b.enemy->getId(); });
+    
+    // Decide in parallel against the unchanged world, then apply every intent in order on this thread
+    intents.resize(scheduledEnemies.size());
+    decideEnemies(player);
+    for (size_t i = 0; i < scheduledEnemies.size(); i++) {
+        scheduledEnemies[i].enemy->commit(*this, intents[i], playerHandle);
+    }
+    
+    // Sleep until the next cooldown runs out, unless something wakes them sooner
+    for (size_t i = 0; i < scheduledEnemies.size(); i++) {
+        Enemy* enemy = scheduledEnemies[i].enemy;
+        EnemyTimer kind;
+        float delay = enemy->getWakeDelay(intents[i], player, kind);
+        enemyTimers.reschedule(enemy->getLodState().wakeTimer, delay, enemy->getHandle(), static_cast<uint8_t>(kind));
+    }
+    
+    // Find the dead from the store's health column rather than by visiting every enemy,
+    // then let them all go in one batch with anything removed during the tick
+    deadEnemies.clear();
+    enemyStore.collectDead(deadEnemies);
+    for (EnemyHandle enemy : deadEnemies) {
+        queueDespawn(*resolve(enemy));
+    }
+    AllocationScope lootScope(AllocationTag::LOOT);
+    processDespawns(player);
+    
     // Update item drops (animations, etc.)
     itemDropManager.update(deltaTime);
+    
+    // Between ticks nothing holds an enemy pointer, so storage can be reordered
+    if (++ticksSinceCompaction >= COMPACTION_INTERVAL) {
+        AllocationScope compactionScope(AllocationTag::AI);
+        compactEnemies();
+    }
 }
 
-void Level::dropLoot(float x, float y, int enemyLevel) {
-    // Random number generator
-    static std::mt19937 rng(static_cast<unsigned int>(std::time(nullptr)));
-    std::uniform_real_distribution<float> dropChance(0.0f, 1.0f);
-    std::uniform_int_distribution<int> itemTypeRoll(0, 2); // 0=Weapon, 1=Armor, 2=Potion
-    std::uniform_int_distribution<int> rarityRoll(0, 100);
+void Level::decideEnemies(const Character* player) {
+    auto decideRange = [this, player](size_t begin, size_t end) {
+        // Workers start untagged
+        AllocationScope aiScope(AllocationTag::AI);
+        for (size_t i = begin; i < end; i++) {
+            scheduledEnemies[i].enemy->decide(*this, scheduledEnemies[i].deltaTime, player, intents[i]);
+        }
+    };
     
-    // 50% chance to drop an item
-    if (dropChance(rng) < 0.5f) {
-        // Determine item type
-        int itemType = itemTypeRoll(rng);
-        
-        // Determine rarity based on enemy level
-        ItemRarity rarity;
-        int rarityValue = rarityRoll(rng) + enemyLevel * 5;
-        
-        if (rarityValue > 95) {
-            rarity = ItemRarity::LEGENDARY;
-        } else if (rarityValue > 80) {
-            rarity = ItemRarity::EPIC;
-        } else if (rarityValue > 60) {
-            rarity = ItemRarity::RARE;
-        } else if (rarityValue > 30) {
-            rarity = ItemRarity::UNCOMMON;
+    size_t count = scheduledEnemies.size();
+    size_t workers = std::min<size_t>(workerThreads, count / MIN_ENEMIES_PER_WORKER);
+    if (workers <= 1) {
+        decideRange(0, count);
+        return;
+    }
+    
+    // Contiguous ranges per worker on the level's persistent threads; this thread takes the first
+    size_t perWorker = (count + workers - 1) / workers;
+    auto decideShare = [&decideRange, perWorker, count](unsigned int worker) {
+        size_t begin = std::min(worker * perWorker, count);
+        decideRange(begin, std::min(begin + perWorker, count));
+    };
+    decidePool.run(static_cast<unsigned int>(workers), decideShare);
+}
+
+void Level::gatherAwakeEnemies(const Character* player) {
+    lodFrame++;
+    awakeEnemies.clear();
+    lodStats = AILodStats();
+    
+    // Without a player nothing is simulated, as before
+    if (!player) {
+        lodStats.dormantCount = static_cast<int>(enemies.size());
+        return;
+    }
+    
+    // Only enemies near an observer are visited; everything else stays dormant untouched
+    auto gatherAround = [this](const Character* observer) {
+        float observerX = observer->getX();
+        float observerY = observer->getY();
+        enemyGrid.forEachInRadius(observerX, observerY, LOD_MID_RADIUS, [&](EnemyHandle enemy, float x, float y) {
+            float dx = x - observerX;
+            float dy = y - observerY;
+            bool near = dx * dx + dy * dy <= LOD_NEAR_RADIUS * LOD_NEAR_RADIUS;
+            markAwake(*resolve(enemy), near ? AILodTier::NEAR : AILodTier::MID);
+        });
+    };
+    gatherAround(player);
+    for (CharacterHandle observer : observers) {
+        if (const Character* character = resolve(observer)) {
+            gatherAround(character);
+        }
+    }
+    
+    // Alerted enemies stay awake until their alert timer fires
+    for (EnemyHandle enemy : alertedEnemies) {
+        markAwake(*resolve(enemy), AILodTier::MID);
+    }
+    
+    for (Enemy* enemy : awakeEnemies) {
+        if (enemy->getLodState().tier == AILodTier::NEAR) {
+            lodStats.nearCount++;
         } else {
-            rarity = ItemRarity::COMMON;
+            lodStats.midCount++;
+        }
+    }
+    lodStats.dormantCount = static_cast<int>(enemies.size() - awakeEnemies.size());
+}
+
+void Level::markAwake(Enemy& enemy, AILodTier tier) {
+    AILodState& lod = enemy.getLodState();
+    if (lod.frameStamp != lodFrame) {
+        // Just woke up: the world may have changed since it last looked
+        if (lod.frameStamp + 1 != lodFrame) {
+            lod.due = true;
+        }
+        lod.frameStamp = lodFrame;
+        lod.tier = tier;
+        awakeEnemies.push_back(&enemy);
+    } else if (tier == AILodTier::NEAR) {
+        // Closest observer wins
+        lod.tier = AILodTier::NEAR;
+    }
+}
+
+void Level::addObserver(CharacterHandle observer) {
+    if (resolve(observer) && std::find(observers.begin(), observers.end(), observer) == observers.end()) {
+        observers.push_back(observer);
+    }
+}
+
+void Level::removeObserver(CharacterHandle observer) {
+    observers.erase(std::remove(observers.begin(), observers.end(), observer), observers.end());
+}
+
+void Level::alertEnemies(float x, float y, float radius) {
+    int region = getRegionId(static_cast<int>(std::round(x)), static_cast<int>(std::round(y)));
+    
+    enemyGrid.forEachInRadius(x, y, radius, [&](EnemyHandle handle, float enemyX, float enemyY) {
+        // Walls muffle the noise: only enemies that could walk over are woken
+        if (getRegionId(static_cast<int>(std::round(enemyX)), static_cast<int>(std::round(enemyY))) != region) {
+            return;
         }
         
-        // Create the item based on type
-        std::shared_ptr<Item> item;
-        
-        switch (itemType) {
-            case 0: { // Weapon
-                int damage = 5 + enemyLevel * 2;
-                if (rarity == ItemRarity::UNCOMMON) damage += 3;
-                if (rarity == ItemRarity::RARE) damage += 7;
-                if (rarity == ItemRarity::EPIC) damage += 12;
-                if (rarity == ItemRarity::LEGENDARY) damage += 20;
-                
-                item = std::make_shared<Weapon>("Sword", rarity, damage);
-                break;
-            }
-            case 1: { // Armor
-                int defense = 3 + enemyLevel;
-                if (rarity == ItemRarity::UNCOMMON) defense += 2;
-                if (rarity == ItemRarity::RARE) defense += 4;
-                if (rarity == ItemRarity::EPIC) defense += 7;
-                if (rarity == ItemRarity::LEGENDARY) defense += 12;
-                
-                item = std::make_shared<Armor>("Armor", rarity, defense);
-                break;
-            }
-            case 2: { // Potion
-                int healAmount = 10 + enemyLevel * 3;
-                if (rarity == ItemRarity::UNCOMMON) healAmount += 5;
-                if (rarity == ItemRarity::RARE) healAmount += 15;
-                if (rarity == ItemRarity::EPIC) healAmount += 30;
-                if (rarity == ItemRarity::LEGENDARY) healAmount += 50;
-                
-                item = std::make_shared<Potion>("Potion", rarity, healAmount);
-                break;
-            }
+        // A repeated alert only pushes the expiry back
+        AILodState& lod = resolve(handle)->getLodState();
+        if (!enemyTimers.isPending(lod.alertTimer)) {
+            alertedEnemies.push_back(handle);
         }
+        enemyTimers.reschedule(lod.alertTimer, ALERT_DURATION, handle, static_cast<uint8_t>(EnemyTimer::ALERT_EXPIRY));
+        lod.due = true;
+    });
+}
+
+void Level::detachEnemy(Enemy& enemy) {
+    // Leaves the store alone; removeEnemyAt takes it out of the store and the enemy list together
+    enemyGrid.remove(enemy.getHandle());
+    unregisterOccupant(&enemy);
+    enemyTimers.cancel(enemy.getLodState().wakeTimer);
+    enemyTimers.cancel(enemy.getLodState().alertTimer);
+    enemy.cancelPatrol(pathService);
+}
+
+void Level::dropLoot(float x, float y, int enemyLevel) {
+    // Drop, type and rarity rolls come from the level's loot stream in one batch
+    uint32_t rolls[3];
+    lootRandom.fill(rolls, 3);
+    
+    // 50% chance to drop an item
+    if ((rolls[0] & 1u) == 0) {
+        // Determine item type, then rarity based on enemy level; stats come from the definition
+        static const ItemDefId LOOT_TABLE[] = {ItemDatabase::SWORD, ItemDatabase::ARMOR, ItemDatabase::POTION};
+        ItemDefId definition = LOOT_TABLE[rolls[1] % 3];
+        ItemRarity rarity = ItemDatabase::rollRarity(static_cast<int>(rolls[2] % 101), enemyLevel);
         
         // Add the item to the world
-        if (item) {
-            addItem(item, x, y);
-        }
+        addItem(ItemDatabase::get().rollInstance(definition, rarity, enemyLevel), x, y);
     }
 }
\ No newline at end of file
@@ -3,10 +3,20 @@
 #include <vector>
 #include <memory>
 #include <string>
+#include <functional>
 #include "character.h"
 #include "enemy.h"
 #include "item.h"
 #include "item_drop.h"
+#include "walkable_index.h"
+#include "random.h"
+#include "flow_field.h"
+#include "path_service.h"
+#include "spatial_grid.h"
+#include "enemy_store.h"
+#include "tile_occupancy.h"
+#include "entity_handle.h"
+#include "../engine/worker_pool.h"
 
 enum class TileType {
     FLOOR,
@@ -29,40 +39,226 @@ public:
     
     // Level generation
     void generateDungeon();
+    // Seeded variant; onProgress receives 0..1 as generation advances (may be called from a worker thread)
+    void generateDungeon(unsigned int seed, const std::function<void(float)>& onProgress = nullptr);
     void generateForest();
     void generateCave();
     
     // Getters
     int getWidth() const { return width; }
     int getHeight() const { return height; }
+    unsigned int getSeed() const { return seed; }
+    int getPlayerStartX() const { return playerStartX; }
+    int getPlayerStartY() const { return playerStartY; }
     Tile getTile(int x, int y) const;
-    const std::vector<std::shared_ptr<Enemy>>& getEnemies() const { return enemies; }
+    // Every enemy, densely packed; the order changes whenever enemies leave or are compacted
+    const std::vector<Enemy>& getEnemies() const { return enemies; }
     const std::vector<std::shared_ptr<Item>>& getItems() const { return items; }
     ItemDropManager& getItemDropManager() { return itemDropManager; }
+    const ItemDropManager& getItemDropManager() const { return itemDropManager; }
     
     // Level manipulation
     void setTile(int x, int y, TileType type);
-    void addEnemy(std::shared_ptr<Enemy> enemy);
-    void removeEnemy(std::shared_ptr<Enemy> enemy);
-    void addItem(std::shared_ptr<Item> item, float x, float y);
-    int getPickupItemIndex(float playerX, float playerY) const;
-    std::shared_ptr<Item> pickupItem(int index);
+    void setTileState(int x, int y, const Tile& tile);
+    void setSeed(unsigned int newSeed);
+    void setPlayerStart(int x, int y) { playerStartX = x; playerStartY = y; }
+    // The level takes the enemy over; refer to it by the returned handle from then on
+    EnemyHandle addEnemy(Enemy enemy);
+    // Scatter wandering enemies on walkable tiles away from the player start
+    void spawnWanderingEnemies(int count, int minDistanceFromStart);
+    // Deferred: the enemy leaves with the rest of the tick's despawns
+    void removeEnemy(EnemyHandle enemy);
+    void addItem(const ItemInstance& item, float x, float y);
+    ItemDropHandle getPickupItemHandle(float playerX, float playerY) const;
+    // Takes the drop off the floor; false if it is already gone
+    bool pickupItem(ItemDropHandle handle, ItemInstance& item);
     
     // Game logic
-    void update(float deltaTime, Character* player);
+    void update(float deltaTime, CharacterHandle player);
     bool isWalkable(int x, int y) const;
     
+    // Walkable-cell queries backed by the incremental index
+    int getRegionId(int x, int y) const { return walkableIndex.getRegion(x, y); }
+    int getRegionCount() const { return walkableIndex.getRegionCount(); }
+    bool areConnected(int x1, int y1, int x2, int y2) const;
+    size_t getWalkableCellCount() const { return walkableIndex.getCellCount(); }
+    bool sampleWalkable(Random& rng, int region, int& outX, int& outY) const;
+    bool sampleWalkableAwayFrom(Random& rng, int fromX, int fromY, int minDistance, bool sameRegion,
+                                int& outX, int& outY) const;
+    
+    // Which tiles characters stand on. Enemies are registered by addEnemy, the player with addCharacter;
+    // movers should tryReserve their destination and then move to commit it.
+    TileOccupancy& getOccupancy() { return occupancy; }
+    const TileOccupancy& getOccupancy() const { return occupancy; }
+    // Characters the level doesn't own, such as the player; the handle goes stale on removal
+    CharacterHandle addCharacter(Character* character);
+    void removeCharacter(CharacterHandle character);
+    // Walkable and not taken by another character
+    bool canEnter(int x, int y, const Character* character) const;
+    
+    // Shared field that chasing enemies follow toward the player, refreshed in update()
+    const FlowField& getPlayerFlowField() const { return playerFlowField; }
+    
+    // Queued point-to-point paths, served under a time budget in update()
+    PathService& getPathService() { return pathService; }
+    
+    // What a handle refers to, or nullptr once it has left the level. Enemy pointers are
+    // only good until the next addEnemy() or update(), either of which may move enemies.
+    Enemy* resolve(EnemyHandle enemy) {
+        uint32_t index = enemyHandles.getIndex(enemy);
+        return index != HandleTable<Enemy>::INVALID_INDEX ? &enemies[index] : nullptr;
+    }
+    const Enemy* resolve(EnemyHandle enemy) const {
+        uint32_t index = enemyHandles.getIndex(enemy);
+        return index != HandleTable<Enemy>::INVALID_INDEX ? &enemies[index] : nullptr;
+    }
+    Character* resolve(CharacterHandle character) const {
+        uint32_t index = characterHandles.getIndex(character);
+        return index != HandleTable<Character>::INVALID_INDEX ? characters[index].character : nullptr;
+    }
+    
+    // Spatial index of living enemies, kept current as they move
+    const SpatialGrid<EnemyHandle>& getEnemyGrid() const { return enemyGrid; }
+    // Nearest living enemy, or an invalid handle
+    EnemyHandle findNearestEnemy(float x, float y, float maxDistance) const;
+    void onEnemyMoved(const Enemy& enemy);
+    
+    // Sort enemy storage by position so neighbours in the world are neighbours in memory;
+    // update() does this every COMPACTION_INTERVAL ticks. Handles stay valid, pointers don't.
+    void compactEnemies();
+    
+    // AI level of detail: enemies are scheduled by distance to the player and any extra observers
+    void addObserver(CharacterHandle observer);
+    void removeObserver(CharacterHandle observer);
+    // Wake dormant enemies within radius that share (x, y)'s region, e.g. on combat noise
+    void alertEnemies(float x, float y, float radius);
+    const AILodStats& getLodStats() const { return lodStats; }
+    
+    // Called once at the end of every tick that despawned enemies, before they are released.
+    // Killed enemies report isDead(); the rest were removed with removeEnemy. The pointers
+    // are only good for the call, and hooks must not add enemies.
+    using DespawnHook = std::function<void(const std::vector<Enemy*>& despawned)>;
+    void addDespawnHook(DespawnHook hook);
+    
+    // Threads enemies decide on; results are the same for any count. The extra
+    // threads are started the first time a tick has enough enemies to split.
+    void setWorkerThreads(unsigned int count) { workerThreads = count > 0 ? count : 1; }
+    unsigned int getWorkerThreads() const { return workerThreads; }
+    
+    // A deterministic level bounds each tick's path work by request count instead of wall-clock
+    // time, so a run replays identically given the same seed, ticks and inputs
+    void setDeterministic(bool enabled) { deterministic = enabled; }
+    bool isDeterministic() const { return deterministic; }
+    // Hash of the simulation state (enemies, characters, item drops, level time), for spotting replay divergence
+    uint64_t computeChecksum() const;
+    
+    // Constants
+    static constexpr int FLOW_FIELD_RADIUS = 16; // Path length, in steps, that chasers will follow
+    static constexpr float PATH_BUDGET_MICROSECONDS = 500.0f; // Per-frame time spent on path requests
+    static constexpr int PATH_BUDGET_REQUESTS = 16; // Per-frame path requests when deterministic
+    static constexpr float SPATIAL_CELL_SIZE = 4.0f; // Tiles per spatial grid cell
+    static constexpr float LOD_NEAR_RADIUS = 16.0f;  // Enemies this close to an observer update every frame
+    static constexpr float LOD_MID_RADIUS = 40.0f;   // Up to here they update every LOD_MID_INTERVAL seconds
+    static constexpr float LOD_MID_INTERVAL = 0.25f;
+    static constexpr float LOD_MAX_CATCH_UP = 10.0f; // Longest gap credited to a waking enemy's timers
+    static constexpr float ALERT_RADIUS = 24.0f;
+    static constexpr float ALERT_DURATION = 5.0f;
+    static constexpr int SPAWN_ATTEMPTS = 8; // Tries to find a free tile for each wandering enemy
+    static constexpr float TIMER_TICK_SECONDS = 0.01f; // Resolution of enemy wake-ups
+    static constexpr size_t MIN_ENEMIES_PER_WORKER = 256; // Below this a worker costs more than it saves
+    static constexpr uint32_t COMPACTION_INTERVAL = 120; // Ticks between re-sorting enemy storage
+    
 private:
     int width;
     int height;
+    unsigned int seed = 0;
+    int playerStartX = 0;
+    int playerStartY = 0;
+    Random lootRandom;
+    uint32_t nextEnemyId = 0;
     std::vector<Tile> tiles;
-    std::vector<std::shared_ptr<Enemy>> enemies;
+    WalkableIndex walkableIndex;
+    FlowField playerFlowField;
+    PathService pathService;
+    SpatialGrid<EnemyHandle> enemyGrid;
+    EnemyStore enemyStore;
+    TileOccupancy occupancy;
+    std::vector<EnemyHandle> deadEnemies;
+    
+    // Enemies live here in the same order as their store slots. Anything that
+    // outlives a tick refers to them by handle, so they can be moved between ticks.
+    std::vector<Enemy> enemies;
+    HandleTable<Enemy> enemyHandles;
+    void removeEnemyAt(uint32_t index);
+    // The enemy at index was moved there; point its store slot and handle at it
+    void placeEnemy(uint32_t index);
+    
+    // Characters registered with addCharacter
+    struct CharacterEntry {
+        Character* character;
+        CharacterHandle handle;
+    };
+    std::vector<CharacterEntry> characters;
+    HandleTable<Character> characterHandles;
+    void registerOccupant(Character* character);
+    void unregisterOccupant(Character* character);
+    
+    // Scratch space for compactEnemies
+    uint32_t ticksSinceCompaction = 0;
+    std::vector<uint64_t> compactionKeys;
+    std::vector<uint32_t> compactionOrder;
+    std::vector<uint32_t> compactionPositions;
+    std::vector<uint32_t> compactionOriginals;
+    
+    // Enemies leaving the level this tick, in the order they were queued
+    std::vector<EnemyHandle> despawnQueue;
+    std::vector<Enemy*> despawnedEnemies;
+    std::vector<DespawnHook> despawnHooks;
+    void queueDespawn(Enemy& enemy);
+    void processDespawns(Character* player);
+    
+    // AI level-of-detail scheduling
+    float levelTime = 0.0f;
+    bool deterministic = false;
+    uint32_t lodFrame = 0;
+    std::vector<CharacterHandle> observers;
+    std::vector<Enemy*> awakeEnemies; // Rebuilt every tick
+    
+    // Two-phase enemy update: who runs this frame with how much time, and what each decided
+    struct ScheduledEnemy {
+        Enemy* enemy;
+        float deltaTime;
+    };
+    std::vector<ScheduledEnemy> scheduledEnemies;
+    std::vector<EnemyIntent> intents;
+    unsigned int workerThreads = 1;
+    WorkerPool decidePool;
+    void decideEnemies(const Character* player);
+    std::vector<EnemyHandle> alertedEnemies;
+    TimerWheel<EnemyHandle> enemyTimers{TIMER_TICK_SECONDS};
+    int lastPlayerTileX = -1;
+    int lastPlayerTileY = -1;
+    AILodStats lodStats;
+    
+    void gatherAwakeEnemies(const Character* player);
+    void markAwake(Enemy& enemy, AILodTier tier);
+    void detachEnemy(Enemy& enemy);
     std::vector<std::shared_ptr<Item>> items; // Added this line
     ItemDropManager itemDropManager;
     
     // Helper methods for level generation
+    struct Room {
+        int x, y;
+        int width, height;
+        int centerX() const { return x + width / 2; }
+        int centerY() const { return y + height / 2; }
+    };
+    std::vector<Room> placeRooms(Random& rng, int count);
+    void connectRooms(const std::vector<Room>& rooms, Random& rng);
+    void populateRoom(const Room& room, Random& rng);
     void createRoom(int x1, int y1, int x2, int y2);
     void createCorridor(int x1, int y1, int x2, int y2);
+    void findPlayerStart();
     
     // Enemy drop system
     void dropLoot(float x, float y, int enemyLevel);
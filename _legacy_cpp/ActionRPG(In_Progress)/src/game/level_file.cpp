@@ -0,0 +1,558 @@
+#include "level_file.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    size_t alignTo8(size_t offset) {
+        return (offset + 7) & ~static_cast<size_t>(7);
+    }
+
+    template <typename T>
+    void writeAt(std::vector<uint8_t>& buffer, size_t offset, const T& value) {
+        std::memcpy(buffer.data() + offset, &value, sizeof(T));
+    }
+
+    // Also rejects NaN, which fails every comparison
+    bool isInside(float x, float y, int width, int height) {
+        return x >= 0.0f && y >= 0.0f && x < static_cast<float>(width) && y < static_cast<float>(height);
+    }
+
+    // count elements of T at offset lie inside the file and are aligned for T
+    template <typename T>
+    bool fitsInFile(uint64_t offset, uint64_t count, size_t fileSize) {
+        if (offset % alignof(T) != 0 || offset > fileSize) {
+            return false;
+        }
+        return count <= (fileSize - offset) / sizeof(T);
+    }
+
+    const char* getEnemyTypeName(EnemyType type) {
+        switch (type) {
+            case EnemyType::GOBLIN:
+                return "Goblin";
+            case EnemyType::SKELETON:
+                return "Skeleton";
+            case EnemyType::ORC:
+                return "Orc";
+            case EnemyType::TROLL:
+                return "Troll";
+            case EnemyType::DRAGON:
+                return "Dragon";
+            default:
+                return "Enemy";
+        }
+    }
+
+    // Name first, so items keep their definition; otherwise any definition of the type
+    ItemInstance createItem(ItemType type, const std::string& name, ItemRarity rarity, int stat) {
+        const ItemDatabase& database = ItemDatabase::get();
+        ItemDefId definition = database.findDefinition(name);
+        if (definition == INVALID_ITEM_DEFINITION || database.getDefinition(definition).type != type) {
+            definition = database.findDefinition(type);
+        }
+        return database.createInstance(definition, rarity, stat);
+    }
+}
+
+// LevelFile implementation
+uint8_t LevelFile::packTile(const Tile& tile) {
+    uint8_t packed = static_cast<uint8_t>(tile.type) & TILE_TYPE_MASK;
+    if (tile.explored) packed |= TILE_EXPLORED_BIT;
+    if (tile.visible) packed |= TILE_VISIBLE_BIT;
+    return packed;
+}
+
+Tile LevelFile::unpackTile(uint8_t packed) {
+    Tile tile;
+    uint8_t type = packed & TILE_TYPE_MASK;
+    tile.type = type <= static_cast<uint8_t>(TileType::LAVA) ? static_cast<TileType>(type) : TileType::WALL;
+    tile.explored = (packed & TILE_EXPLORED_BIT) != 0;
+    tile.visible = (packed & TILE_VISIBLE_BIT) != 0;
+    return tile;
+}
+
+bool LevelFile::save(const Level& level, const std::string& path, uint32_t generatorVersion) {
+    const int width = level.getWidth();
+    const int height = level.getHeight();
+    const uint32_t chunkCountX = (width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    const uint32_t chunkCountY = (height + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    const uint32_t chunkCount = chunkCountX * chunkCountY;
+    const size_t chunkBytes = CHUNK_SIZE * CHUNK_SIZE;
+
+    const auto& enemies = level.getEnemies();
+    const auto& itemDrops = level.getItemDropManager().getItemDrops();
+
+    // Build the string table up front so the spawn and item records can reference it
+    std::string stringTable;
+    std::vector<LevelSpawnRecord> spawnRecords;
+    spawnRecords.reserve(enemies.size());
+    for (const Enemy& enemy : enemies) {
+        LevelSpawnRecord record = {};
+        record.x = enemy.getX();
+        record.y = enemy.getY();
+        record.enemyType = static_cast<uint8_t>(enemy.getEnemyType());
+        record.level = enemy.getLevel();
+        record.nameOffset = static_cast<uint32_t>(stringTable.size());
+        record.nameLength = static_cast<uint32_t>(enemy.getName().size());
+        stringTable += enemy.getName();
+        spawnRecords.push_back(record);
+    }
+    
+    std::vector<LevelItemRecord> itemRecords;
+    itemRecords.reserve(itemDrops.size());
+    for (const auto& itemDrop : itemDrops) {
+        const ItemInstance& item = itemDrop.getItem();
+        LevelItemRecord record = {};
+        record.x = itemDrop.getX();
+        record.y = itemDrop.getY();
+        record.itemType = static_cast<uint8_t>(item.getType());
+        record.rarity = item.rarity;
+        record.stat = item.stat;
+        record.nameOffset = static_cast<uint32_t>(stringTable.size());
+        record.nameLength = static_cast<uint32_t>(item.getName().size());
+        stringTable += item.getName();
+        itemRecords.push_back(record);
+    }
+
+    // Lay out the sections
+    LevelFileHeader header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.headerSize = sizeof(LevelFileHeader);
+    header.width = width;
+    header.height = height;
+    header.seed = level.getSeed();
+    header.playerStartX = level.getPlayerStartX();
+    header.playerStartY = level.getPlayerStartY();
+    header.chunkSize = CHUNK_SIZE;
+    header.chunkCountX = chunkCountX;
+    header.chunkCountY = chunkCountY;
+    header.chunkIndexOffset = alignTo8(sizeof(LevelFileHeader));
+
+    size_t chunkDataOffset = alignTo8(header.chunkIndexOffset + chunkCount * sizeof(LevelChunkIndexEntry));
+    header.spawnTableOffset = alignTo8(chunkDataOffset + chunkCount * chunkBytes);
+    header.spawnCount = static_cast<uint32_t>(spawnRecords.size());
+    header.itemTableOffset = alignTo8(header.spawnTableOffset + spawnRecords.size() * sizeof(LevelSpawnRecord));
+    header.itemCount = static_cast<uint32_t>(itemRecords.size());
+    header.stringTableOffset = alignTo8(header.itemTableOffset + itemRecords.size() * sizeof(LevelItemRecord));
+    header.stringTableSize = static_cast<uint32_t>(stringTable.size());
+    header.generatorVersion = generatorVersion;
+
+    std::vector<uint8_t> buffer(header.stringTableOffset + stringTable.size(), 0);
+    writeAt(buffer, 0, header);
+
+    // Tile planes, padded to whole chunks with walls
+    const uint8_t paddingTile = packTile(Tile{TileType::WALL, false, false});
+    for (uint32_t cy = 0; cy < chunkCountY; cy++) {
+        for (uint32_t cx = 0; cx < chunkCountX; cx++) {
+            uint32_t chunkIndex = cy * chunkCountX + cx;
+            size_t offset = chunkDataOffset + chunkIndex * chunkBytes;
+
+            LevelChunkIndexEntry entry = {};
+            entry.offset = offset;
+            entry.tileCount = static_cast<uint32_t>(chunkBytes);
+
+            for (uint32_t ly = 0; ly < CHUNK_SIZE; ly++) {
+                for (uint32_t lx = 0; lx < CHUNK_SIZE; lx++) {
+                    int x = static_cast<int>(cx * CHUNK_SIZE + lx);
+                    int y = static_cast<int>(cy * CHUNK_SIZE + ly);
+                    uint8_t packed = paddingTile;
+                    if (x < width && y < height) {
+                        packed = packTile(level.getTile(x, y));
+                    }
+                    if (packed != paddingTile) {
+                        entry.flags |= CHUNK_HAS_CONTENT;
+                    }
+                    buffer[offset + ly * CHUNK_SIZE + lx] = packed;
+                }
+            }
+
+            writeAt(buffer, header.chunkIndexOffset + chunkIndex * sizeof(LevelChunkIndexEntry), entry);
+        }
+    }
+
+    // Entity spawn table
+    for (size_t i = 0; i < spawnRecords.size(); i++) {
+        writeAt(buffer, header.spawnTableOffset + i * sizeof(LevelSpawnRecord), spawnRecords[i]);
+    }
+
+    // Item drops and their names
+    for (size_t i = 0; i < itemRecords.size(); i++) {
+        writeAt(buffer, header.itemTableOffset + i * sizeof(LevelItemRecord), itemRecords[i]);
+    }
+    if (!stringTable.empty()) {
+        std::memcpy(buffer.data() + header.stringTableOffset, stringTable.data(), stringTable.size());
+    }
+
+    const std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open level file for writing: " << tempPath << std::endl;
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        if (!file.flush()) {
+            std::cerr << "Failed to write level file: " << tempPath << std::endl;
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        std::cerr << "Failed to replace level file " << path << ": " << error.message() << std::endl;
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+
+    return true;
+}
+
+std::shared_ptr<Level> LevelFile::load(const std::string& path, uint32_t generatorVersion) {
+    MappedLevelFile mapped;
+    if (!mapped.open(path)) {
+        return nullptr;
+    }
+
+    const LevelFileHeader& header = mapped.getHeader();
+    if (generatorVersion != ANY_GENERATOR && header.generatorVersion != generatorVersion) {
+        std::cerr << "Level file was made by generator version " << header.generatorVersion << ", not "
+                  << generatorVersion << ": " << path << std::endl;
+        return nullptr;
+    }
+    auto level = std::make_shared<Level>(header.width, header.height);
+    level->setSeed(header.seed);
+
+    // Chunks of solid unexplored wall match a fresh Level and are never decoded
+    const int chunkSize = static_cast<int>(header.chunkSize);
+    for (uint32_t cy = 0; cy < header.chunkCountY; cy++) {
+        for (uint32_t cx = 0; cx < header.chunkCountX; cx++) {
+            if (!mapped.chunkHasContent(static_cast<int>(cx), static_cast<int>(cy))) continue;
+            
+            const Tile* chunk = mapped.getChunk(static_cast<int>(cx), static_cast<int>(cy));
+            if (!chunk) continue;
+
+            for (int ly = 0; ly < chunkSize; ly++) {
+                for (int lx = 0; lx < chunkSize; lx++) {
+                    int x = static_cast<int>(cx) * chunkSize + lx;
+                    int y = static_cast<int>(cy) * chunkSize + ly;
+                    if (x < header.width && y < header.height) {
+                        level->setTileState(x, y, chunk[ly * chunkSize + lx]);
+                    }
+                }
+            }
+        }
+    }
+    level->setPlayerStart(header.playerStartX, header.playerStartY);
+
+    // Respawn enemies; a type this build doesn't know means the file is bad
+    const LevelSpawnRecord* spawns = mapped.getSpawns();
+    for (size_t i = 0; i < mapped.getSpawnCount(); i++) {
+        if (spawns[i].enemyType > static_cast<uint8_t>(EnemyType::DRAGON)) {
+            std::cerr << "Level file has an unknown enemy type " << static_cast<int>(spawns[i].enemyType)
+                      << ": " << path << std::endl;
+            return nullptr;
+        }
+        if (spawns[i].level < 1 || spawns[i].level > MAX_ENEMY_LEVEL ||
+            !isInside(spawns[i].x, spawns[i].y, header.width, header.height)) {
+            std::cerr << "Level file has an enemy spawn out of range: " << path << std::endl;
+            return nullptr;
+        }
+        EnemyType type = static_cast<EnemyType>(spawns[i].enemyType);
+        std::string name = mapped.getEnemyName(spawns[i]);
+        if (name.empty()) {
+            name = getEnemyTypeName(type);
+        }
+
+        Enemy enemy(name, type, spawns[i].level);
+        enemy.move(spawns[i].x, spawns[i].y);
+        level->addEnemy(std::move(enemy));
+    }
+
+    // Restore item drops
+    const LevelItemRecord* items = mapped.getItems();
+    for (size_t i = 0; i < mapped.getItemCount(); i++) {
+        if (items[i].itemType > static_cast<uint8_t>(ItemType::MISC) ||
+            items[i].rarity > static_cast<uint8_t>(ItemRarity::LEGENDARY)) {
+            std::cerr << "Level file has an unknown item type or rarity: " << path << std::endl;
+            return nullptr;
+        }
+        if (!isInside(items[i].x, items[i].y, header.width, header.height)) {
+            std::cerr << "Level file has an item drop out of range: " << path << std::endl;
+            return nullptr;
+        }
+        ItemInstance item = createItem(static_cast<ItemType>(items[i].itemType), mapped.getItemName(items[i]),
+                                       static_cast<ItemRarity>(items[i].rarity), items[i].stat);
+        if (item.isValid()) {
+            level->addItem(item, items[i].x, items[i].y);
+        }
+    }
+
+    return level;
+}
+
+bool LevelFile::isSameLevel(const Level& a, const Level& b) {
+    if (a.getWidth() != b.getWidth() || a.getHeight() != b.getHeight() || a.getSeed() != b.getSeed() ||
+        a.getPlayerStartX() != b.getPlayerStartX() || a.getPlayerStartY() != b.getPlayerStartY()) {
+        return false;
+    }
+    for (int y = 0; y < a.getHeight(); y++) {
+        for (int x = 0; x < a.getWidth(); x++) {
+            if (packTile(a.getTile(x, y)) != packTile(b.getTile(x, y))) {
+                return false;
+            }
+        }
+    }
+
+    // The checksum covers enemy ids, positions and stats and the item drop positions
+    const auto& enemiesA = a.getEnemies();
+    const auto& enemiesB = b.getEnemies();
+    if (enemiesA.size() != enemiesB.size() || a.computeChecksum() != b.computeChecksum()) {
+        return false;
+    }
+    for (size_t i = 0; i < enemiesA.size(); i++) {
+        if (enemiesA[i].getEnemyType() != enemiesB[i].getEnemyType() || enemiesA[i].getName() != enemiesB[i].getName()) {
+            return false;
+        }
+    }
+
+    const auto& dropsA = a.getItemDropManager().getItemDrops();
+    const auto& dropsB = b.getItemDropManager().getItemDrops();
+    if (dropsA.size() != dropsB.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < dropsA.size(); i++) {
+        const ItemInstance& itemA = dropsA[i].getItem();
+        const ItemInstance& itemB = dropsB[i].getItem();
+        if (itemA.definition != itemB.definition || itemA.rarity != itemB.rarity || itemA.stat != itemB.stat) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// MappedLevelFile implementation
+MappedLevelFile::MappedLevelFile()
+    : data(nullptr), size(0), header(nullptr), chunkIndex(nullptr)
+#ifdef _WIN32
+    , fileHandle(nullptr), mappingHandle(nullptr)
+#else
+    , fileDescriptor(-1)
+#endif
+{
+}
+
+MappedLevelFile::~MappedLevelFile() {
+    close();
+}
+
+bool MappedLevelFile::open(const std::string& path) {
+    close();
+
+#ifdef _WIN32
+    // Sharing deletion lets LevelFile::save replace the file while it is mapped here
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "Failed to open level file: " << path << std::endl;
+        return false;
+    }
+    fileHandle = file;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        std::cerr << "Level file is empty: " << path << std::endl;
+        close();
+        return false;
+    }
+    size = static_cast<size_t>(fileSize.QuadPart);
+
+    mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mappingHandle) {
+        std::cerr << "Failed to map level file: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    data = static_cast<const uint8_t*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+#else
+    fileDescriptor = ::open(path.c_str(), O_RDONLY);
+    if (fileDescriptor < 0) {
+        std::cerr << "Failed to open level file: " << path << std::endl;
+        return false;
+    }
+
+    struct stat fileStat;
+    if (fstat(fileDescriptor, &fileStat) != 0 || fileStat.st_size == 0) {
+        std::cerr << "Level file is empty: " << path << std::endl;
+        close();
+        return false;
+    }
+    size = static_cast<size_t>(fileStat.st_size);
+
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+    data = (mapping == MAP_FAILED) ? nullptr : static_cast<const uint8_t*>(mapping);
+#endif
+
+    if (!data) {
+        std::cerr << "Failed to map level file: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    header = reinterpret_cast<const LevelFileHeader*>(data);
+    if (size < sizeof(LevelFileHeader) || !validate()) {
+        std::cerr << "Invalid or unsupported level file: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    chunkIndex = reinterpret_cast<const LevelChunkIndexEntry*>(data + header->chunkIndexOffset);
+    materializedChunks.clear();
+    materializedChunks.resize(static_cast<size_t>(header->chunkCountX) * header->chunkCountY);
+    return true;
+}
+
+void MappedLevelFile::close() {
+#ifdef _WIN32
+    if (data) {
+        UnmapViewOfFile(data);
+    }
+    if (mappingHandle) {
+        CloseHandle(mappingHandle);
+        mappingHandle = nullptr;
+    }
+    if (fileHandle) {
+        CloseHandle(fileHandle);
+        fileHandle = nullptr;
+    }
+#else
+    if (data) {
+        munmap(const_cast<uint8_t*>(data), size);
+    }
+    if (fileDescriptor >= 0) {
+        ::close(fileDescriptor);
+        fileDescriptor = -1;
+    }
+#endif
+
+    data = nullptr;
+    size = 0;
+    header = nullptr;
+    chunkIndex = nullptr;
+    materializedChunks.clear();
+}
+
+bool MappedLevelFile::validate() const {
+    if (std::memcmp(header->magic, LevelFile::MAGIC, sizeof(LevelFile::MAGIC)) != 0) return false;
+    if (header->version != LevelFile::VERSION) return false;
+    if (header->headerSize != sizeof(LevelFileHeader)) return false;
+    if (header->width <= 0 || header->height <= 0 || header->chunkSize == 0) return false;
+    if (static_cast<uint64_t>(header->chunkCountX) * header->chunkSize < static_cast<uint64_t>(header->width)) return false;
+    if (static_cast<uint64_t>(header->chunkCountY) * header->chunkSize < static_cast<uint64_t>(header->height)) return false;
+
+    // Every table has to lie inside the file, aligned for its records, so it can be read in place.
+    // The offsets come from the file, so compare against the space left rather than adding to them.
+    const uint64_t chunkCount = static_cast<uint64_t>(header->chunkCountX) * header->chunkCountY;
+    if (!fitsInFile<LevelChunkIndexEntry>(header->chunkIndexOffset, chunkCount, size)) return false;
+    if (!fitsInFile<LevelSpawnRecord>(header->spawnTableOffset, header->spawnCount, size)) return false;
+    if (!fitsInFile<LevelItemRecord>(header->itemTableOffset, header->itemCount, size)) return false;
+    if (!fitsInFile<char>(header->stringTableOffset, header->stringTableSize, size)) return false;
+
+    const uint64_t chunkBytes = static_cast<uint64_t>(header->chunkSize) * header->chunkSize;
+    const LevelChunkIndexEntry* entries = reinterpret_cast<const LevelChunkIndexEntry*>(data + header->chunkIndexOffset);
+    for (uint64_t i = 0; i < chunkCount; i++) {
+        if (entries[i].tileCount != chunkBytes || !fitsInFile<uint8_t>(entries[i].offset, chunkBytes, size)) return false;
+    }
+
+    return true;
+}
+
+uint8_t MappedLevelFile::getRawTile(int x, int y) const {
+    const uint32_t chunkSize = header->chunkSize;
+    const LevelChunkIndexEntry& entry = chunkIndex[(y / chunkSize) * header->chunkCountX + (x / chunkSize)];
+    return data[entry.offset + (y % chunkSize) * chunkSize + (x % chunkSize)];
+}
+
+TileType MappedLevelFile::getTileType(int x, int y) const {
+    if (x < 0 || x >= header->width || y < 0 || y >= header->height) {
+        return TileType::WALL;
+    }
+    return static_cast<TileType>(getRawTile(x, y) & LevelFile::TILE_TYPE_MASK);
+}
+
+Tile MappedLevelFile::getTile(int x, int y) const {
+    if (x < 0 || x >= header->width || y < 0 || y >= header->height) {
+        return Tile{TileType::WALL, false, false};
+    }
+    return LevelFile::unpackTile(getRawTile(x, y));
+}
+
+const Tile* MappedLevelFile::getChunk(int chunkX, int chunkY) {
+    if (chunkX < 0 || chunkY < 0 ||
+        chunkX >= static_cast<int>(header->chunkCountX) || chunkY >= static_cast<int>(header->chunkCountY)) {
+        return nullptr;
+    }
+
+    size_t index = static_cast<size_t>(chunkY) * header->chunkCountX + chunkX;
+    auto& chunk = materializedChunks[index];
+    if (!chunk) {
+        // Decode the tile plane on first access
+        const LevelChunkIndexEntry& entry = chunkIndex[index];
+        const uint8_t* packed = data + entry.offset;
+        chunk.reset(new Tile[entry.tileCount]);
+        for (uint32_t i = 0; i < entry.tileCount; i++) {
+            chunk[i] = LevelFile::unpackTile(packed[i]);
+        }
+    }
+
+    return chunk.get();
+}
+
+bool MappedLevelFile::chunkHasContent(int chunkX, int chunkY) const {
+    if (chunkX < 0 || chunkY < 0 ||
+        chunkX >= static_cast<int>(header->chunkCountX) || chunkY >= static_cast<int>(header->chunkCountY)) {
+        return false;
+    }
+    return (chunkIndex[chunkY * header->chunkCountX + chunkX].flags & LevelFile::CHUNK_HAS_CONTENT) != 0;
+}
+
+const LevelSpawnRecord* MappedLevelFile::getSpawns() const {
+    return reinterpret_cast<const LevelSpawnRecord*>(data + header->spawnTableOffset);
+}
+
+const LevelItemRecord* MappedLevelFile::getItems() const {
+    return reinterpret_cast<const LevelItemRecord*>(data + header->itemTableOffset);
+}
+
+std::string MappedLevelFile::getEnemyName(const LevelSpawnRecord& record) const {
+    return getString(record.nameOffset, record.nameLength);
+}
+
+std::string MappedLevelFile::getItemName(const LevelItemRecord& record) const {
+    return getString(record.nameOffset, record.nameLength);
+}
+
+std::string MappedLevelFile::getString(uint32_t offset, uint32_t length) const {
+    if (static_cast<uint64_t>(offset) + length > header->stringTableSize) {
+        return std::string();
+    }
+    const char* strings = reinterpret_cast<const char*>(data + header->stringTableOffset);
+    return std::string(strings + offset, length);
+}
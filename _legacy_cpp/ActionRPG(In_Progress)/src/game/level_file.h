@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "level.h"
+
+// On-disk level format (little-endian, version 1)
+//
+//   LevelFileHeader
+//   LevelChunkIndexEntry[chunkCountX * chunkCountY]
+//   chunk tile planes, one byte per tile, CHUNK_SIZE x CHUNK_SIZE each
+//   LevelSpawnRecord[spawnCount]
+//   LevelItemRecord[itemCount]
+//   string table (enemy and item names, not null-terminated)
+//
+// Every section starts on an 8-byte boundary so a mapped file can be read in place.
+// Offsets and counts are checked against the file size when it is opened.
+
+struct LevelFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    int32_t width;
+    int32_t height;
+    uint32_t seed;
+    int32_t playerStartX;
+    int32_t playerStartY;
+    uint32_t chunkSize;
+    uint32_t chunkCountX;
+    uint32_t chunkCountY;
+    uint64_t chunkIndexOffset;
+    uint64_t spawnTableOffset;
+    uint64_t itemTableOffset;
+    uint64_t stringTableOffset;
+    uint32_t spawnCount;
+    uint32_t itemCount;
+    uint32_t stringTableSize;
+    uint32_t generatorVersion; // Generator that produced the level, or 0 if it didn't come from one
+};
+
+struct LevelChunkIndexEntry {
+    uint64_t offset;     // Byte offset of the chunk's tile plane
+    uint32_t tileCount;  // Always chunkSize * chunkSize; edge chunks are padded with walls
+    uint32_t flags;      // CHUNK_HAS_CONTENT unless the chunk is solid unexplored wall
+};
+
+struct LevelSpawnRecord {
+    float x;
+    float y;
+    uint8_t enemyType;
+    uint8_t padding[3];
+    int32_t level;
+    uint32_t nameOffset; // Into the string table
+    uint32_t nameLength;
+};
+
+struct LevelItemRecord {
+    float x;
+    float y;
+    uint8_t itemType;
+    uint8_t rarity;
+    uint16_t padding;
+    int32_t stat;        // Damage, defense or heal amount depending on the item type
+    uint32_t nameOffset; // Into the string table
+    uint32_t nameLength;
+};
+
+// Read-only memory mapping of a level file. Tiles are read straight out of the
+// mapping; decoded Tile chunks are only materialized the first time they are
+// requested. The mapping is shared, so several processes loading the same file
+// share its pages through the page cache.
+class MappedLevelFile {
+public:
+    MappedLevelFile();
+    ~MappedLevelFile();
+
+    MappedLevelFile(const MappedLevelFile&) = delete;
+    MappedLevelFile& operator=(const MappedLevelFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return data != nullptr; }
+
+    const LevelFileHeader& getHeader() const { return *header; }
+    int getWidth() const { return header->width; }
+    int getHeight() const { return header->height; }
+
+    // In-place tile access, no decoding of the rest of the level
+    TileType getTileType(int x, int y) const;
+    Tile getTile(int x, int y) const;
+
+    // Decoded tiles of one chunk (chunkSize * chunkSize, row-major), built on first access
+    const Tile* getChunk(int chunkX, int chunkY);
+    bool chunkHasContent(int chunkX, int chunkY) const;
+
+    // Entity tables
+    const LevelSpawnRecord* getSpawns() const;
+    size_t getSpawnCount() const { return header->spawnCount; }
+    std::string getEnemyName(const LevelSpawnRecord& record) const;
+    const LevelItemRecord* getItems() const;
+    size_t getItemCount() const { return header->itemCount; }
+    std::string getItemName(const LevelItemRecord& record) const;
+
+private:
+    const uint8_t* data;
+    size_t size;
+    const LevelFileHeader* header;
+    const LevelChunkIndexEntry* chunkIndex;
+    std::vector<std::unique_ptr<Tile[]>> materializedChunks;
+
+    // Platform mapping handles
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#else
+    int fileDescriptor;
+#endif
+
+    bool validate() const;
+    uint8_t getRawTile(int x, int y) const;
+    std::string getString(uint32_t offset, uint32_t length) const;
+};
+
+// Saving and loading whole levels
+class LevelFile {
+public:
+    // Writes a temporary file and renames it over path, so no one maps a half-written
+    // level. On POSIX, processes that have the old file mapped keep reading it. Windows
+    // only replaces a file whose every open handle allows deletion, as MappedLevelFile's
+    // do; when the replace is refused, save fails and the old file stays.
+    static bool save(const Level& level, const std::string& path, uint32_t generatorVersion = ANY_GENERATOR);
+
+    // Map the file and build a playable Level from it. Every chunk with content is
+    // decoded up front: the level's walkable index and path data need all its tiles.
+    // Given a generator version, files from any other generator are rejected.
+    static std::shared_ptr<Level> load(const std::string& path, uint32_t generatorVersion = ANY_GENERATOR);
+
+    // Same tiles, seed, player start, enemies and item drops; used to check a saved level reloads intact
+    static bool isSameLevel(const Level& a, const Level& b);
+
+    // Constants
+    static constexpr char MAGIC[8] = {'A', 'R', 'P', 'G', 'L', 'V', 'L', '\0'};
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t CHUNK_SIZE = 32;
+    static constexpr uint32_t CHUNK_HAS_CONTENT = 1u;
+    static constexpr int32_t MAX_ENEMY_LEVEL = 100; // Spawn levels beyond this mark a corrupt file
+    static constexpr uint32_t ANY_GENERATOR = 0;
+
+    // Packed tile byte: low nibble is the TileType, then the explored and visible flags
+    static constexpr uint8_t TILE_TYPE_MASK = 0x0F;
+    static constexpr uint8_t TILE_EXPLORED_BIT = 0x10;
+    static constexpr uint8_t TILE_VISIBLE_BIT = 0x20;
+
+    static uint8_t packTile(const Tile& tile);
+    // Unknown tile types decode as walls
+    static Tile unpackTile(uint8_t packed);
+};
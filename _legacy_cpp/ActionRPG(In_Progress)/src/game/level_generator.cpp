@@ -0,0 +1,108 @@
+#include "level_generator.h"
+#include <chrono>
+#include <filesystem>
+#include "level_file.h"
+#include "../engine/allocation_tracker.h"
+#include "../engine/logger.h"
+
+LevelGenerationJob LevelGenerationJob::start(int width, int height, int floorNumber, unsigned int seed,
+                                             const std::string& cacheDirectory) {
+    LevelGenerationJob job;
+    job.floorNumber = floorNumber;
+    job.progress = std::make_shared<std::atomic<float>>(0.0f);
+    
+    // The worker only touches the level it creates and the shared progress counter
+    auto progress = job.progress;
+    job.result = std::async(std::launch::async, [width, height, floorNumber, seed, progress, cacheDirectory]() {
+        AllocationScope levelScope(AllocationTag::LEVEL);
+        
+        // The seed fixes the whole floor, so a cached copy stands in for generating it
+        std::string cachePath;
+        if (!cacheDirectory.empty()) {
+            cachePath = getCachePath(cacheDirectory, width, height, seed);
+            if (auto cached = loadCached(cachePath, width, height)) {
+                progress->store(1.0f, std::memory_order_release);
+                LOG_INFO(LEVEL, "Loaded floor {} (seed {}) from {}", floorNumber, seed, cachePath);
+                return cached;
+            }
+        }
+        
+        auto level = std::make_shared<Level>(width, height);
+        
+        // Dungeon layout accounts for most of the work
+        level->generateDungeon(seed, [&progress](float fraction) {
+            progress->store(fraction * 0.9f, std::memory_order_relaxed);
+        });
+        
+        // Populate the floor with additional wandering enemies
+        level->spawnWanderingEnemies(WANDERING_ENEMY_COUNT, MIN_SPAWN_DISTANCE);
+        
+        if (!cachePath.empty()) {
+            saveCached(*level, cacheDirectory, cachePath);
+        }
+        progress->store(1.0f, std::memory_order_release);
+        
+        LOG_INFO(LEVEL, "Generated floor {} (seed {})", floorNumber, seed);
+        return level;
+    });
+    
+    return job;
+}
+
+std::string LevelGenerationJob::getCachePath(const std::string& cacheDirectory, int width, int height,
+                                             unsigned int seed) {
+    std::filesystem::path path(cacheDirectory);
+    path /= "floor_" + std::to_string(width) + "x" + std::to_string(height) + "_" + std::to_string(seed) + ".lvl";
+    return path.string();
+}
+
+std::shared_ptr<Level> LevelGenerationJob::loadCached(const std::string& path, int width, int height) {
+    std::error_code error;
+    if (!std::filesystem::exists(path, error)) {
+        return nullptr;
+    }
+    
+    auto level = LevelFile::load(path, GENERATOR_VERSION);
+    if (!level || level->getWidth() != width || level->getHeight() != height) {
+        LOG_WARN(LEVEL, "Ignoring unusable cached floor {}", path);
+        return nullptr;
+    }
+    return level;
+}
+
+void LevelGenerationJob::saveCached(const Level& level, const std::string& cacheDirectory, const std::string& path) {
+    std::error_code error;
+    std::filesystem::create_directories(cacheDirectory, error);
+    if (error || !LevelFile::save(level, path, GENERATOR_VERSION)) {
+        LOG_WARN(LEVEL, "Could not cache floor in {}", cacheDirectory);
+        return;
+    }
+    
+    // Round-trip check: only keep the file if loading it gives back the same floor
+    auto reloaded = LevelFile::load(path, GENERATOR_VERSION);
+    if (!reloaded || !LevelFile::isSameLevel(level, *reloaded)) {
+        LOG_WARN(LEVEL, "Cached floor {} did not reload intact; removing it", path);
+        std::filesystem::remove(path, error);
+    }
+}
+
+bool LevelGenerationJob::isReady() const {
+    if (!result.valid()) {
+        return false;
+    }
+    return result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+float LevelGenerationJob::getProgress() const {
+    if (!progress) {
+        return 0.0f;
+    }
+    return progress->load(std::memory_order_acquire);
+}
+
+std::shared_ptr<Level> LevelGenerationJob::take() {
+    if (!result.valid()) {
+        return nullptr;
+    }
+    return result.get();
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <string>
+#include "level.h"
+
+// Handle to a level being generated on a background thread
+class LevelGenerationJob {
+public:
+    LevelGenerationJob() = default;
+    
+    // Kick off generation of a dungeon floor; returns immediately. With a cache
+    // directory, a floor this generator version saved there earlier is loaded
+    // instead of generated, and a newly generated floor is saved there once it
+    // reloads intact.
+    static LevelGenerationJob start(int width, int height, int floorNumber, unsigned int seed,
+                                    const std::string& cacheDirectory = std::string());
+    
+    // A default-constructed or already-taken job is not valid
+    bool isValid() const { return result.valid(); }
+    bool isReady() const;
+    
+    // Generation progress in the range 0..1, for loading bars
+    float getProgress() const;
+    int getFloorNumber() const { return floorNumber; }
+    
+    // Hand over the finished level, blocking if it is still being generated
+    std::shared_ptr<Level> take();
+    
+    // Where a floor of this size and seed is cached
+    static std::string getCachePath(const std::string& cacheDirectory, int width, int height, unsigned int seed);
+    
+    // Saved in cached floors, which are only reused by the same version. Bump it with any
+    // change to what a seed generates: layout, populating rooms or wandering spawns.
+    static constexpr uint32_t GENERATOR_VERSION = 1;
+    
+private:
+    std::future<std::shared_ptr<Level>> result;
+    std::shared_ptr<std::atomic<float>> progress;
+    int floorNumber = 0;
+    
+    // Constants
+    static constexpr int WANDERING_ENEMY_COUNT = 10;
+    static constexpr int MIN_SPAWN_DISTANCE = 5;
+    
+    static std::shared_ptr<Level> loadCached(const std::string& path, int width, int height);
+    static void saveCached(const Level& level, const std::string& cacheDirectory, const std::string& path);
+};
@@ -0,0 +1,465 @@
+#include "path_service.h"
+#include "level.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+
+namespace {
+    int sign(int value) {
+        return (value > 0) - (value < 0);
+    }
+}
+
+PathService::PathService()
+    : width(0), height(0), nextTicket(1), nextCacheSlot(0), searchStamp(0),
+      searchCount(0), cacheHitCount(0), expandedNodeCount(0) {
+}
+
+PathService::~PathService() {
+}
+
+void PathService::reset(int newWidth, int newHeight) {
+    width = newWidth;
+    height = newHeight;
+
+    queue.clear();
+    results.clear();
+    cache.clear();
+    nextCacheSlot = 0;
+    cacheByKey.clear();
+    cellPathCount.assign(width * height, 0);
+
+    stamp.assign(width * height, 0);
+    gCost.assign(width * height, 0.0f);
+    parent.assign(width * height, -1);
+    closed.assign(width * height, 0);
+    open.clear();
+    searchStamp = 0;
+}
+
+PathService::Ticket PathService::requestPath(int startX, int startY, int goalX, int goalY, PathAlgorithm algorithm) {
+    Ticket ticket = nextTicket++;
+    if (nextTicket == INVALID_TICKET) {
+        nextTicket = 1;
+    }
+
+    bool inBounds = startX >= 0 && startX < width && startY >= 0 && startY < height &&
+                    goalX >= 0 && goalX < width && goalY >= 0 && goalY < height;
+    if (!inBounds) {
+        results[ticket] = Result{PathStatus::FAILED, {}};
+        return ticket;
+    }
+
+    results[ticket] = Result{PathStatus::PENDING, {}};
+    queue.push_back(Request{ticket, startY * width + startX, goalY * width + goalX, algorithm});
+    return ticket;
+}
+
+void PathService::cancel(Ticket ticket) {
+    // A queued request is skipped once its result slot is gone
+    results.erase(ticket);
+}
+
+PathStatus PathService::getStatus(Ticket ticket) const {
+    auto it = results.find(ticket);
+    return it != results.end() ? it->second.status : PathStatus::UNKNOWN;
+}
+
+bool PathService::takePath(Ticket ticket, std::vector<PathPoint>& outPath) {
+    auto it = results.find(ticket);
+    if (it == results.end() || it->second.status == PathStatus::PENDING) {
+        return false;
+    }
+
+    bool found = it->second.status == PathStatus::READY;
+    if (found) {
+        outPath = std::move(it->second.path);
+    }
+    results.erase(it);
+    return found;
+}
+
+int PathService::process(const Level& level, float budgetMicroseconds) {
+    auto startTime = std::chrono::steady_clock::now();
+    int finished = 0;
+
+    while (!queue.empty()) {
+        // Always finish at least one request so the queue can't stall
+        if (finished > 0) {
+            float elapsed = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - startTime).count();
+            if (elapsed >= budgetMicroseconds) {
+                break;
+            }
+        }
+
+        if (solveNext(level)) {
+            finished++;
+        }
+    }
+
+    return finished;
+}
+
+int PathService::processCount(const Level& level, int maxRequests) {
+    int finished = 0;
+
+    while (!queue.empty() && finished < std::max(maxRequests, 1)) {
+        if (solveNext(level)) {
+            finished++;
+        }
+    }
+
+    return finished;
+}
+
+bool PathService::solveNext(const Level& level) {
+    Request request = queue.front();
+    queue.pop_front();
+
+    auto it = results.find(request.ticket);
+    if (it == results.end()) {
+        return false; // Cancelled
+    }
+
+    if (resolve(level, request.start, request.goal, request.algorithm, solvedCells)) {
+        it->second.status = PathStatus::READY;
+        toPoints(solvedCells, it->second.path);
+    } else {
+        it->second.status = PathStatus::FAILED;
+    }
+    return true;
+}
+
+bool PathService::findPath(const Level& level, int startX, int startY, int goalX, int goalY,
+                           PathAlgorithm algorithm, std::vector<PathPoint>& outPath) {
+    if (startX < 0 || startX >= width || startY < 0 || startY >= height ||
+        goalX < 0 || goalX >= width || goalY < 0 || goalY >= height) {
+        return false;
+    }
+
+    if (!resolve(level, startY * width + startX, goalY * width + goalX, algorithm, solvedCells)) {
+        return false;
+    }
+    toPoints(solvedCells, outPath);
+    return true;
+}
+
+void PathService::onTileChanged(int x, int y, bool walkable) {
+    // A tile opening up can't break a cached path, only make it longer than necessary
+    if (walkable || x < 0 || x >= width || y < 0 || y >= height) {
+        return;
+    }
+
+    int cell = y * width + x;
+    if (cellPathCount[cell] == 0) {
+        return;
+    }
+
+    for (size_t slot = 0; slot < cache.size() && cellPathCount[cell] > 0; slot++) {
+        const std::vector<int>& cells = cache[slot].cells;
+        if (cache[slot].valid && std::find(cells.begin(), cells.end(), cell) != cells.end()) {
+            evictCached(slot);
+        }
+    }
+}
+
+bool PathService::resolve(const Level& level, int start, int goal, PathAlgorithm algorithm, std::vector<int>& outCells) {
+    int startX = start % width, startY = start / width;
+    int goalX = goal % width, goalY = goal / width;
+    if (!level.isWalkable(startX, startY) || !level.isWalkable(goalX, goalY)) {
+        return false;
+    }
+
+    // Different regions can never be joined, so don't search at all
+    if (!level.areConnected(startX, startY, goalX, goalY)) {
+        return false;
+    }
+
+    uint64_t key = makeKey(level, start, goal);
+    if (findCached(key, start, outCells)) {
+        cacheHitCount++;
+        return true;
+    }
+
+    if (!solve(level, start, goal, algorithm, outCells)) {
+        return false;
+    }
+    storeCached(key, outCells);
+    return true;
+}
+
+bool PathService::solve(const Level& level, int start, int goal, PathAlgorithm algorithm, std::vector<int>& outCells) {
+    searchCount++;
+    if (start == goal) {
+        outCells.assign(1, start);
+        return true;
+    }
+
+    bool found = algorithm == PathAlgorithm::JUMP_POINT ? searchJumpPoint(level, start, goal)
+                                                       : searchAStar(level, start, goal);
+    if (found) {
+        buildCells(start, goal, outCells);
+    }
+    return found;
+}
+
+bool PathService::searchAStar(const Level& level, int start, int goal) {
+    beginSearch(start, goal);
+
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end(), std::greater<OpenNode>());
+        int cell = open.back().cell;
+        open.pop_back();
+        if (closed[cell]) continue;
+        closed[cell] = 1;
+        expandedNodeCount++;
+
+        if (cell == goal) {
+            return true;
+        }
+
+        int x = cell % width;
+        int y = cell / width;
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                if (dx == 0 && dy == 0) continue;
+                if (!level.isWalkable(x + dx, y + dy)) continue;
+
+                float stepCost = (dx != 0 && dy != 0) ? DIAGONAL_COST : 1.0f;
+                pushOpen((y + dy) * width + (x + dx), gCost[cell] + stepCost, cell, goal);
+            }
+        }
+    }
+
+    return false;
+}
+
+bool PathService::searchJumpPoint(const Level& level, int start, int goal) {
+    beginSearch(start, goal);
+
+    int directions[8][2];
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end(), std::greater<OpenNode>());
+        int cell = open.back().cell;
+        open.pop_back();
+        if (closed[cell]) continue;
+        closed[cell] = 1;
+        expandedNodeCount++;
+
+        if (cell == goal) {
+            return true;
+        }
+
+        int x = cell % width;
+        int y = cell / width;
+        int directionCount = 0;
+        auto addDirection = [&](int dx, int dy) {
+            directions[directionCount][0] = dx;
+            directions[directionCount][1] = dy;
+            directionCount++;
+        };
+
+        if (parent[cell] < 0) {
+            // The start node has no incoming direction to prune by
+            for (int dy = -1; dy <= 1; dy++) {
+                for (int dx = -1; dx <= 1; dx++) {
+                    if (dx != 0 || dy != 0) addDirection(dx, dy);
+                }
+            }
+        } else {
+            int dx = sign(x - parent[cell] % width);
+            int dy = sign(y - parent[cell] / width);
+
+            // Natural neighbours plus the forced ones created by adjacent walls
+            if (dx != 0 && dy != 0) {
+                addDirection(dx, 0);
+                addDirection(0, dy);
+                addDirection(dx, dy);
+                if (!level.isWalkable(x - dx, y)) addDirection(-dx, dy);
+                if (!level.isWalkable(x, y - dy)) addDirection(dx, -dy);
+            } else if (dx != 0) {
+                addDirection(dx, 0);
+                if (!level.isWalkable(x, y + 1)) addDirection(dx, 1);
+                if (!level.isWalkable(x, y - 1)) addDirection(dx, -1);
+            } else {
+                addDirection(0, dy);
+                if (!level.isWalkable(x + 1, y)) addDirection(1, dy);
+                if (!level.isWalkable(x - 1, y)) addDirection(-1, dy);
+            }
+        }
+
+        for (int i = 0; i < directionCount; i++) {
+            int jumpPoint = jump(level, x, y, directions[i][0], directions[i][1], goal);
+            if (jumpPoint >= 0) {
+                pushOpen(jumpPoint, gCost[cell] + heuristic(cell, jumpPoint), cell, goal);
+            }
+        }
+    }
+
+    return false;
+}
+
+int PathService::jump(const Level& level, int x, int y, int dx, int dy, int goal) const {
+    // Scan in one direction until something interesting happens; only the
+    // straight scans launched from a diagonal step ever nest
+    while (true) {
+        x += dx;
+        y += dy;
+        if (!level.isWalkable(x, y)) {
+            return -1;
+        }
+
+        int cell = y * width + x;
+        if (cell == goal || hasForcedNeighbour(level, x, y, dx, dy)) {
+            return cell;
+        }
+
+        if (dx != 0 && dy != 0) {
+            if (jump(level, x, y, dx, 0, goal) >= 0 || jump(level, x, y, 0, dy, goal) >= 0) {
+                return cell;
+            }
+        }
+    }
+}
+
+bool PathService::hasForcedNeighbour(const Level& level, int x, int y, int dx, int dy) const {
+    if (dx != 0 && dy != 0) {
+        return (!level.isWalkable(x - dx, y) && level.isWalkable(x - dx, y + dy)) ||
+               (!level.isWalkable(x, y - dy) && level.isWalkable(x + dx, y - dy));
+    }
+    if (dx != 0) {
+        return (!level.isWalkable(x, y + 1) && level.isWalkable(x + dx, y + 1)) ||
+               (!level.isWalkable(x, y - 1) && level.isWalkable(x + dx, y - 1));
+    }
+    return (!level.isWalkable(x + 1, y) && level.isWalkable(x + 1, y + dy)) ||
+           (!level.isWalkable(x - 1, y) && level.isWalkable(x - 1, y + dy));
+}
+
+void PathService::beginSearch(int start, int goal) {
+    // Bumping the stamp forgets the previous search without touching every cell
+    searchStamp++;
+    if (searchStamp == 0) {
+        std::fill(stamp.begin(), stamp.end(), 0);
+        searchStamp = 1;
+    }
+
+    open.clear();
+    pushOpen(start, 0.0f, -1, goal);
+}
+
+void PathService::pushOpen(int cell, float g, int fromCell, int goal) {
+    if (stamp[cell] != searchStamp) {
+        stamp[cell] = searchStamp;
+        gCost[cell] = std::numeric_limits<float>::max();
+        closed[cell] = 0;
+    }
+    if (closed[cell] || g >= gCost[cell]) {
+        return;
+    }
+
+    gCost[cell] = g;
+    parent[cell] = fromCell;
+    open.push_back(OpenNode{g + heuristic(cell, goal), cell});
+    std::push_heap(open.begin(), open.end(), std::greater<OpenNode>());
+}
+
+float PathService::heuristic(int from, int to) const {
+    // Octile distance
+    int dx = std::abs(from % width - to % width);
+    int dy = std::abs(from / width - to / width);
+    return static_cast<float>(std::max(dx, dy) - std::min(dx, dy)) + DIAGONAL_COST * std::min(dx, dy);
+}
+
+void PathService::buildCells(int start, int goal, std::vector<int>& outCells) const {
+    // Walk back along the parents, filling in the straight or diagonal run between jump points
+    outCells.clear();
+    outCells.push_back(goal);
+
+    int cell = goal;
+    while (cell != start) {
+        int from = parent[cell];
+        int x = cell % width, y = cell / width;
+        int fromX = from % width, fromY = from / width;
+        int stepX = sign(fromX - x), stepY = sign(fromY - y);
+
+        while (x != fromX || y != fromY) {
+            if (x != fromX) x += stepX;
+            if (y != fromY) y += stepY;
+            outCells.push_back(y * width + x);
+        }
+        cell = from;
+    }
+
+    std::reverse(outCells.begin(), outCells.end());
+}
+
+bool PathService::findCached(uint64_t key, int start, std::vector<int>& outCells) const {
+    // Any cached path to the same goal that passes through the start can be reused from there
+    auto range = cacheByKey.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it) {
+        const std::vector<int>& cells = cache[it->second].cells;
+        auto position = std::find(cells.begin(), cells.end(), start);
+        if (position != cells.end()) {
+            outCells.assign(position, cells.end());
+            return true;
+        }
+    }
+    return false;
+}
+
+void PathService::storeCached(uint64_t key, const std::vector<int>& cells) {
+    size_t slot = nextCacheSlot;
+    nextCacheSlot = (nextCacheSlot + 1) % MAX_CACHED_PATHS;
+
+    if (slot >= cache.size()) {
+        cache.push_back(CachedPath{0, {}, false});
+    } else {
+        evictCached(slot);
+    }
+
+    CachedPath& entry = cache[slot];
+    entry.key = key;
+    entry.cells = cells;
+    entry.valid = true;
+
+    cacheByKey.emplace(key, slot);
+    for (int cell : cells) {
+        cellPathCount[cell]++;
+    }
+}
+
+void PathService::evictCached(size_t slot) {
+    CachedPath& entry = cache[slot];
+    if (!entry.valid) {
+        return;
+    }
+
+    auto range = cacheByKey.equal_range(entry.key);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == slot) {
+            cacheByKey.erase(it);
+            break;
+        }
+    }
+    for (int cell : entry.cells) {
+        cellPathCount[cell]--;
+    }
+
+    entry.cells.clear();
+    entry.valid = false;
+}
+
+uint64_t PathService::makeKey(const Level& level, int start, int goal) const {
+    uint32_t region = static_cast<uint32_t>(level.getRegionId(start % width, start / width));
+    return (static_cast<uint64_t>(region) << 32) | static_cast<uint32_t>(goal);
+}
+
+void PathService::toPoints(const std::vector<int>& cells, std::vector<PathPoint>& outPath) const {
+    outPath.clear();
+    outPath.reserve(cells.size());
+    for (int cell : cells) {
+        outPath.push_back(PathPoint{cell % width, cell / width});
+    }
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+class Level; // Forward declaration
+
+enum class PathAlgorithm {
+    ASTAR,
+    JUMP_POINT
+};
+
+enum class PathStatus {
+    UNKNOWN,   // Never requested, cancelled, or already taken
+    PENDING,
+    READY,
+    FAILED
+};
+
+struct PathPoint {
+    int x;
+    int y;
+};
+
+// Point-to-point paths over the level's walkability grid for agents whose
+// target isn't the player (patrol points, loot, fleeing). Requests are queued
+// and solved in Level::update under a per-frame time budget. Solved paths are
+// cached by (start region, goal) and reused by any later request that starts
+// on a cached path; a cached path is dropped as soon as one of its tiles
+// becomes unwalkable.
+class PathService {
+public:
+    using Ticket = uint32_t;
+    static constexpr Ticket INVALID_TICKET = 0;
+
+    PathService();
+    ~PathService();
+
+    // Size the search buffers for a level and drop all requests and cached paths
+    void reset(int width, int height);
+
+    // Queue a request; poll getStatus and collect the result with takePath
+    Ticket requestPath(int startX, int startY, int goalX, int goalY,
+                       PathAlgorithm algorithm = PathAlgorithm::JUMP_POINT);
+    void cancel(Ticket ticket);
+    PathStatus getStatus(Ticket ticket) const;
+    // Moves the path (start to goal, inclusive) out and forgets the ticket
+    bool takePath(Ticket ticket, std::vector<PathPoint>& outPath);
+
+    // Solve queued requests until the budget runs out; returns how many were finished
+    int process(const Level& level, float budgetMicroseconds);
+    // Same, but bounded by a request count, so what gets solved doesn't depend on machine speed
+    int processCount(const Level& level, int maxRequests);
+
+    // Solve immediately, bypassing the queue but still using the cache
+    bool findPath(const Level& level, int startX, int startY, int goalX, int goalY,
+                  PathAlgorithm algorithm, std::vector<PathPoint>& outPath);
+
+    // Called by Level::setTile when a tile's walkability changes
+    void onTileChanged(int x, int y, bool walkable);
+
+    // Statistics
+    size_t getPendingCount() const { return queue.size(); }
+    size_t getCachedPathCount() const { return cacheByKey.size(); }
+    uint64_t getSearchCount() const { return searchCount; }
+    uint64_t getCacheHitCount() const { return cacheHitCount; }
+    uint64_t getExpandedNodeCount() const { return expandedNodeCount; }
+
+private:
+    struct Request {
+        Ticket ticket;
+        int start;
+        int goal;
+        PathAlgorithm algorithm;
+    };
+
+    struct Result {
+        PathStatus status;
+        std::vector<PathPoint> path;
+    };
+
+    struct CachedPath {
+        uint64_t key;
+        std::vector<int> cells;
+        bool valid;
+    };
+
+    struct OpenNode {
+        float f;
+        int cell;
+        bool operator>(const OpenNode& other) const { return f > other.f; }
+    };
+
+    int width;
+    int height;
+    Ticket nextTicket;
+
+    std::deque<Request> queue;
+    std::unordered_map<Ticket, Result> results;
+
+    // Fixed-size ring of cached paths, looked up by key; cellPathCount counts the
+    // cached paths crossing each cell so most tile changes are rejected in O(1)
+    std::vector<CachedPath> cache;
+    size_t nextCacheSlot;
+    std::unordered_multimap<uint64_t, size_t> cacheByKey;
+    std::vector<uint16_t> cellPathCount;
+
+    // Search scratch; per-cell data is only valid where stamp matches searchStamp
+    std::vector<uint32_t> stamp;
+    std::vector<float> gCost;
+    std::vector<int> parent;
+    std::vector<uint8_t> closed;
+    std::vector<OpenNode> open;
+    uint32_t searchStamp;
+    std::vector<int> solvedCells; // Cells of the path just solved, before conversion to points
+
+    uint64_t searchCount;
+    uint64_t cacheHitCount;
+    uint64_t expandedNodeCount;
+
+    bool solveNext(const Level& level);
+    bool resolve(const Level& level, int start, int goal, PathAlgorithm algorithm, std::vector<int>& outCells);
+    bool solve(const Level& level, int start, int goal, PathAlgorithm algorithm, std::vector<int>& outCells);
+    bool searchAStar(const Level& level, int start, int goal);
+    bool searchJumpPoint(const Level& level, int start, int goal);
+    int jump(const Level& level, int x, int y, int dx, int dy, int goal) const;
+    bool hasForcedNeighbour(const Level& level, int x, int y, int dx, int dy) const;
+
+    void beginSearch(int start, int goal);
+    void pushOpen(int cell, float g, int fromCell, int goal);
+    float heuristic(int from, int to) const;
+    void buildCells(int start, int goal, std::vector<int>& outCells) const;
+
+    bool findCached(uint64_t key, int start, std::vector<int>& outCells) const;
+    void storeCached(uint64_t key, const std::vector<int>& cells);
+    void evictCached(size_t slot);
+    uint64_t makeKey(const Level& level, int start, int goal) const;
+    void toPoints(const std::vector<int>& cells, std::vector<PathPoint>& outPath) const;
+
+    // Constants
+    static constexpr size_t MAX_CACHED_PATHS = 128;
+    static constexpr float DIAGONAL_COST = 1.41421356f;
+};
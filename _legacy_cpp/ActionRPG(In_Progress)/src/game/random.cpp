@@ -0,0 +1,84 @@
+#include "random.h"
+
+namespace {
+    // SplitMix64, used to spread a 64-bit seed over the generator state
+    uint64_t splitMix64(uint64_t& x) {
+        uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+}
+
+Random::Random() {
+    seed(0);
+}
+
+Random::Random(uint64_t initialSeed) {
+    seed(initialSeed);
+}
+
+Random Random::forStream(uint64_t worldSeed, RandomStream stream, uint64_t index) {
+    // Hash the stream id before mixing so neighbouring ids give unrelated states
+    uint64_t streamKey = static_cast<uint64_t>(stream) + index;
+    uint64_t mixed = splitMix64(streamKey);
+    return Random(worldSeed ^ mixed);
+}
+
+void Random::seed(uint64_t newSeed) {
+    uint64_t x = newSeed;
+    uint64_t a = splitMix64(x);
+    uint64_t b = splitMix64(x);
+    state[0] = static_cast<uint32_t>(a);
+    state[1] = static_cast<uint32_t>(a >> 32);
+    state[2] = static_cast<uint32_t>(b);
+    state[3] = static_cast<uint32_t>(b >> 32);
+
+    // An all-zero state would only ever produce zeros
+    if ((state[0] | state[1] | state[2] | state[3]) == 0) {
+        state[0] = 1;
+    }
+}
+
+uint32_t Random::nextBelow(uint32_t bound) {
+    if (bound == 0) {
+        return 0;
+    }
+
+    // Lemire's multiply-and-reject: one multiplication, rarely a retry
+    uint64_t product = static_cast<uint64_t>(next()) * bound;
+    uint32_t low = static_cast<uint32_t>(product);
+    if (low < bound) {
+        uint32_t threshold = (0u - bound) % bound;
+        while (low < threshold) {
+            product = static_cast<uint64_t>(next()) * bound;
+            low = static_cast<uint32_t>(product);
+        }
+    }
+    return static_cast<uint32_t>(product >> 32);
+}
+
+int Random::nextInt(int minValue, int maxValue) {
+    if (maxValue <= minValue) {
+        return minValue;
+    }
+    uint32_t span = static_cast<uint32_t>(maxValue - minValue) + 1;
+    return minValue + static_cast<int>(nextBelow(span));
+}
+
+void Random::fill(uint32_t* out, size_t count) {
+    // Working on a local copy keeps the state in registers across the loop
+    Random local = *this;
+    for (size_t i = 0; i < count; i++) {
+        out[i] = local.next();
+    }
+    *this = local;
+}
+
+void Random::fillFloats(float* out, size_t count) {
+    Random local = *this;
+    for (size_t i = 0; i < count; i++) {
+        out[i] = local.nextFloat();
+    }
+    *this = local;
+}
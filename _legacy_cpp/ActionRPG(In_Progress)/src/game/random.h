@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Independent random streams derived from the world seed. Each consumer
+// (level layout, loot, every enemy, ...) draws from its own stream, so the
+// order in which systems run never changes what another system sees.
+enum class RandomStream : uint64_t {
+    LAYOUT = 1,
+    PLAYER_START = 2,
+    SPAWNS = 3,
+    LOOT = 4,
+    ENEMY = 1ull << 32  // Plus the enemy's id
+};
+
+// xoshiro128** generator: 16 bytes of state, no allocation and no system calls,
+// and the same sequence on every platform for a given seed. Satisfies
+// UniformRandomBitGenerator, but nextBelow/nextInt/nextFloat should be
+// preferred over std distributions, whose output differs between standard
+// libraries.
+class Random {
+public:
+    using result_type = uint32_t;
+
+    Random();
+    explicit Random(uint64_t seed);
+
+    // Generator for one stream of a world seed
+    static Random forStream(uint64_t worldSeed, RandomStream stream, uint64_t index = 0);
+
+    void seed(uint64_t seed);
+
+    uint32_t next() {
+        uint32_t result = rotl(state[1] * 5, 7) * 9;
+        uint32_t t = state[1] << 9;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 11);
+        return result;
+    }
+
+    result_type operator()() { return next(); }
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT32_MAX; }
+
+    // Unbiased integer in [0, bound)
+    uint32_t nextBelow(uint32_t bound);
+    // Integer in [minValue, maxValue]
+    int nextInt(int minValue, int maxValue);
+    // Float in [0, 1)
+    float nextFloat() { return (next() >> 8) * (1.0f / 16777216.0f); }
+    bool chance(float probability) { return nextFloat() < probability; }
+
+    // Bulk generation for systems that roll many values at once (loot tables, spawn waves)
+    void fill(uint32_t* out, size_t count);
+    void fillFloats(float* out, size_t count);
+
+private:
+    uint32_t state[4];
+
+    static uint32_t rotl(uint32_t value, int shift) {
+        return (value << shift) | (value >> (32 - shift));
+    }
+};
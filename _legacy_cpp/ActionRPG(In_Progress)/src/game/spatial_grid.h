@@ -0,0 +1,315 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// Uniform grid of buckets over the level, each covering cellSize x cellSize
+// tiles, for proximity queries whose cost depends on how many items are
+// nearby rather than how many exist. Items are entity handles (anything with
+// an index and a generation); where each one sits is kept in a vector indexed
+// by handle index, so inserting, moving and removing never hash and moving
+// never allocates. Items must be moved explicitly with update() when their
+// position changes. Positions outside the level are clamped into the border cells.
+template <typename T>
+class SpatialGrid {
+public:
+    // A default grid is a single cell, correct but linear until reset() sizes it
+    SpatialGrid() : columns(1), rows(1), cellSize(1.0f), cells(1) {}
+
+    // Size the grid for a level; drops every item
+    void reset(int worldWidth, int worldHeight, float newCellSize) {
+        cellSize = newCellSize;
+        columns = std::max(1, static_cast<int>(std::ceil(worldWidth / cellSize)));
+        rows = std::max(1, static_cast<int>(std::ceil(worldHeight / cellSize)));
+        cells.assign(columns * rows, {});
+        locations.clear();
+        itemCount = 0;
+    }
+
+    void clear() {
+        for (auto& cell : cells) {
+            cell.clear();
+        }
+        locations.clear();
+        itemCount = 0;
+    }
+
+    size_t size() const { return itemCount; }
+    bool contains(const T& item) const { return findLocation(item) != nullptr; }
+
+    void insert(const T& item, float x, float y) {
+        if (item.index >= locations.size()) {
+            locations.resize(item.index + 1);
+        }
+
+        Location& location = locations[item.index];
+        if (location.cell != NONE) {
+            if (location.generation == item.generation) {
+                moveItem(location, x, y);
+                return;
+            }
+            // A stale handle to a slot that has since been reused; the new item takes its place
+            removeFromCell(location);
+            itemCount--;
+        }
+        location.generation = item.generation;
+        addToCell(location, item, x, y, cellIndex(x, y));
+        itemCount++;
+    }
+
+    void remove(const T& item) {
+        Location* location = findLocation(item);
+        if (!location) return;
+
+        removeFromCell(*location);
+        location->cell = NONE;
+        itemCount--;
+    }
+
+    // Move an item; returns false if it isn't in the grid
+    bool update(const T& item, float x, float y) {
+        Location* location = findLocation(item);
+        if (!location) return false;
+
+        moveItem(*location, x, y);
+        return true;
+    }
+
+    // Visit every item in the axis-aligned rectangle (inclusive)
+    template <typename Visitor>
+    void forEachInRect(float minX, float minY, float maxX, float maxY, Visitor&& visit) const {
+        int minColumn, minRow, maxColumn, maxRow;
+        cellRange(minX, minY, maxX, maxY, minColumn, minRow, maxColumn, maxRow);
+        for (int row = minRow; row <= maxRow; row++) {
+            for (int column = minColumn; column <= maxColumn; column++) {
+                for (const Entry& entry : cells[row * columns + column]) {
+                    if (entry.x >= minX && entry.x <= maxX && entry.y >= minY && entry.y <= maxY) {
+                        visit(entry.item, entry.x, entry.y);
+                    }
+                }
+            }
+        }
+    }
+
+    // Visit every item within radius of (x, y)
+    template <typename Visitor>
+    void forEachInRadius(float x, float y, float radius, Visitor&& visit) const {
+        float radiusSquared = radius * radius;
+        forEachInRect(x - radius, y - radius, x + radius, y + radius,
+                      [&](const T& item, float itemX, float itemY) {
+                          float dx = itemX - x;
+                          float dy = itemY - y;
+                          if (dx * dx + dy * dy <= radiusSquared) {
+                              visit(item, itemX, itemY);
+                          }
+                      });
+    }
+
+    // out is any vector of T, including per-frame ones
+    template <typename Container>
+    void queryRect(float minX, float minY, float maxX, float maxY, Container& out) const {
+        forEachInRect(minX, minY, maxX, maxY, [&out](const T& item, float, float) { out.push_back(item); });
+    }
+
+    template <typename Container>
+    void queryRadius(float x, float y, float radius, Container& out) const {
+        forEachInRadius(x, y, radius, [&out](const T& item, float, float) { out.push_back(item); });
+    }
+
+    // Closest accepted item within maxRadius; returns false if there is none. Allocation-free.
+    template <typename Filter>
+    bool findNearest(float x, float y, float maxRadius, Filter&& accept, T& out) const {
+        SingleCandidate nearest;
+        collectNearest(x, y, maxRadius, accept, nearest);
+        if (!nearest.found) return false;
+        out = nearest.item;
+        return true;
+    }
+
+    bool findNearest(float x, float y, float maxRadius, T& out) const {
+        return findNearest(x, y, maxRadius, [](const T&) { return true; }, out);
+    }
+
+    // Candidates kept by findKNearest; callers own one and reuse it so queries don't allocate
+    using NearestScratch = std::vector<std::pair<float, T>>;
+
+    // Up to k accepted items within maxRadius, closest first, appended to out (any vector of T)
+    template <typename Filter, typename Container>
+    void findKNearest(float x, float y, size_t k, float maxRadius, Filter&& accept, Container& out,
+                      NearestScratch& scratch) const {
+        scratch.clear();
+        if (k == 0) return;
+        SortedCandidates nearest{scratch, k};
+        collectNearest(x, y, maxRadius, accept, nearest);
+        for (const auto& candidate : scratch) {
+            out.push_back(candidate.second);
+        }
+    }
+
+    template <typename Container>
+    void findKNearest(float x, float y, size_t k, float maxRadius, Container& out, NearestScratch& scratch) const {
+        findKNearest(x, y, k, maxRadius, [](const T&) { return true; }, out, scratch);
+    }
+
+private:
+    struct Entry {
+        T item;
+        float x;
+        float y;
+    };
+
+    static constexpr int NONE = -1;
+
+    // Indexed by handle index; cell is NONE while no item with that index is in the grid
+    struct Location {
+        int cell = NONE;
+        int slot = 0;
+        uint32_t generation = 0;
+    };
+
+    // Result sets for collectNearest: full() once nothing farther than worst() can get in
+    struct SingleCandidate {
+        float distanceSquared = 0.0f;
+        T item{};
+        bool found = false;
+
+        bool full() const { return found; }
+        float worst() const { return distanceSquared; }
+        void add(float newDistanceSquared, const T& newItem) {
+            distanceSquared = newDistanceSquared;
+            item = newItem;
+            found = true;
+        }
+    };
+
+    struct SortedCandidates {
+        NearestScratch& nearest;
+        size_t k;
+
+        bool full() const { return nearest.size() == k; }
+        float worst() const { return nearest.back().first; }
+        void add(float distanceSquared, const T& item) {
+            auto position = std::upper_bound(nearest.begin(), nearest.end(), distanceSquared,
+                                             [](float distance, const std::pair<float, T>& candidate) {
+                                                 return distance < candidate.first;
+                                             });
+            nearest.insert(position, std::make_pair(distanceSquared, item));
+            if (nearest.size() > k) nearest.pop_back();
+        }
+    };
+
+    int columns;
+    int rows;
+    float cellSize;
+    std::vector<std::vector<Entry>> cells;
+    std::vector<Location> locations;
+    size_t itemCount = 0;
+
+    Location* findLocation(const T& item) {
+        return const_cast<Location*>(static_cast<const SpatialGrid*>(this)->findLocation(item));
+    }
+
+    const Location* findLocation(const T& item) const {
+        if (item.index >= locations.size()) return nullptr;
+        const Location& location = locations[item.index];
+        return location.cell != NONE && location.generation == item.generation ? &location : nullptr;
+    }
+
+    int columnOf(float x) const {
+        return std::max(0, std::min(columns - 1, static_cast<int>(std::floor(x / cellSize))));
+    }
+
+    int rowOf(float y) const {
+        return std::max(0, std::min(rows - 1, static_cast<int>(std::floor(y / cellSize))));
+    }
+
+    int cellIndex(float x, float y) const {
+        return rowOf(y) * columns + columnOf(x);
+    }
+
+    void cellRange(float minX, float minY, float maxX, float maxY,
+                   int& minColumn, int& minRow, int& maxColumn, int& maxRow) const {
+        minColumn = columnOf(minX);
+        minRow = rowOf(minY);
+        maxColumn = columnOf(maxX);
+        maxRow = rowOf(maxY);
+    }
+
+    void addToCell(Location& location, const T& item, float x, float y, int cell) {
+        location.cell = cell;
+        location.slot = static_cast<int>(cells[cell].size());
+        cells[cell].push_back(Entry{item, x, y});
+    }
+
+    // The location is rewritten in place; only the bucket it moves into can grow
+    void moveItem(Location& location, float x, float y) {
+        int newCell = cellIndex(x, y);
+        if (newCell == location.cell) {
+            Entry& entry = cells[location.cell][location.slot];
+            entry.x = x;
+            entry.y = y;
+            return;
+        }
+
+        T item = cells[location.cell][location.slot].item;
+        removeFromCell(location);
+        addToCell(location, item, x, y, newCell);
+    }
+
+    void removeFromCell(const Location& location) {
+        // Swap-and-pop, then fix up the location of the entry that moved
+        std::vector<Entry>& bucket = cells[location.cell];
+        if (location.slot != static_cast<int>(bucket.size()) - 1) {
+            bucket[location.slot] = std::move(bucket.back());
+            locations[bucket[location.slot].item.index].slot = location.slot;
+        }
+        bucket.pop_back();
+    }
+
+    // Search rings of cells outward from (x, y), keeping the best candidates in
+    // the result set, until nothing outside the searched block can be closer
+    template <typename Filter, typename Candidates>
+    void collectNearest(float x, float y, float maxRadius, Filter& accept, Candidates& nearest) const {
+        if (itemCount == 0) return;
+
+        float maxRadiusSquared = maxRadius * maxRadius;
+        auto consider = [&](int column, int row) {
+            for (const Entry& entry : cells[row * columns + column]) {
+                float dx = entry.x - x;
+                float dy = entry.y - y;
+                float distanceSquared = dx * dx + dy * dy;
+                if (distanceSquared > maxRadiusSquared) continue;
+                if (nearest.full() && distanceSquared >= nearest.worst()) continue;
+                if (!accept(entry.item)) continue;
+                nearest.add(distanceSquared, entry.item);
+            }
+        };
+
+        int centerColumn = columnOf(x);
+        int centerRow = rowOf(y);
+        int maxRing = std::max(columns, rows);
+        for (int ring = 0; ring <= maxRing; ring++) {
+            int minColumn = centerColumn - ring, maxColumn = centerColumn + ring;
+            int minRow = centerRow - ring, maxRow = centerRow + ring;
+
+            for (int column = std::max(0, minColumn); column <= std::min(columns - 1, maxColumn); column++) {
+                if (minRow >= 0) consider(column, minRow);
+                if (maxRow < rows && maxRow != minRow) consider(column, maxRow);
+            }
+            for (int row = std::max(0, minRow + 1); row <= std::min(rows - 1, maxRow - 1); row++) {
+                if (minColumn >= 0) consider(minColumn, row);
+                if (maxColumn < columns && maxColumn != minColumn) consider(maxColumn, row);
+            }
+
+            // Anything not yet visited lies outside this block of cells
+            float clearance = std::min(std::min(x - minColumn * cellSize, (maxColumn + 1) * cellSize - x),
+                                       std::min(y - minRow * cellSize, (maxRow + 1) * cellSize - y));
+            if (clearance >= maxRadius) break;
+            if (nearest.full() && nearest.worst() <= clearance * clearance) break;
+        }
+    }
+};
@@ -0,0 +1,198 @@
+#include "tile_occupancy.h"
+#include "character.h"
+#include <cmath>
+
+TileOccupancy::TileOccupancy() {
+}
+
+TileOccupancy::~TileOccupancy() {
+    clear();
+}
+
+void TileOccupancy::reset(int newWidth, int newHeight) {
+    clear();
+    width = newWidth;
+    height = newHeight;
+
+    size_t tileCount = static_cast<size_t>(width) * height;
+    blockingCounts.assign(tileCount, 0);
+    heads.assign(tileCount, NONE);
+    reservations.reset(new std::atomic<uint32_t>[tileCount]);
+    for (size_t i = 0; i < tileCount; i++) {
+        reservations[i].store(UNRESERVED, std::memory_order_relaxed);
+    }
+}
+
+TileOccupancy::OccupantId TileOccupancy::add(Character* character, bool blocking) {
+    OccupantId id;
+    if (!freeIds.empty()) {
+        id = freeIds.back();
+        freeIds.pop_back();
+    } else {
+        id = static_cast<OccupantId>(occupants.size());
+        occupants.emplace_back();
+    }
+
+    Occupant& occupant = occupants[id];
+    occupant = Occupant();
+    occupant.character = character;
+    occupant.blocking = blocking;
+    link(id, tileIndexAt(character->getX(), character->getY()));
+
+    character->setOccupancy(this, id);
+    return id;
+}
+
+void TileOccupancy::remove(OccupantId id) {
+    if (id >= occupants.size() || !occupants[id].character) {
+        return;
+    }
+    release(id);
+    unlink(id);
+    occupants[id].character->setOccupancy(nullptr, INVALID_OCCUPANT);
+    occupants[id].character = nullptr;
+    freeIds.push_back(id);
+}
+
+void TileOccupancy::relocate(OccupantId id, Character* character) {
+    if (id < occupants.size() && occupants[id].character) {
+        occupants[id].character = character;
+    }
+}
+
+void TileOccupancy::clear() {
+    for (OccupantId id = 0; id < occupants.size(); id++) {
+        remove(id);
+    }
+    occupants.clear();
+    freeIds.clear();
+}
+
+void TileOccupancy::onMoved(OccupantId id, float x, float y) {
+    int tile = tileIndexAt(x, y);
+    Occupant& occupant = occupants[id];
+
+    // The move commits the reservation, wherever it ended up
+    release(id);
+    if (tile != occupant.tile) {
+        unlink(id);
+        link(id, tile);
+    }
+}
+
+bool TileOccupancy::isOccupied(int x, int y) const {
+    int tile = tileIndex(x, y);
+    if (tile < 0) {
+        return false;
+    }
+    return blockingCounts[tile] > 0 || reservations[tile].load(std::memory_order_acquire) != UNRESERVED;
+}
+
+bool TileOccupancy::isFreeFor(int x, int y, OccupantId id) const {
+    int tile = tileIndex(x, y);
+    if (tile < 0 || id >= occupants.size()) {
+        return false;
+    }
+    const Occupant& occupant = occupants[id];
+    int blockers = blockingCounts[tile] - ((occupant.blocking && occupant.tile == tile) ? 1 : 0);
+    uint32_t reservedBy = reservations[tile].load(std::memory_order_acquire);
+    return blockers == 0 && (reservedBy == UNRESERVED || reservedBy == id + 1);
+}
+
+int TileOccupancy::getOccupantCount(int x, int y) const {
+    int count = 0;
+    forEachOccupant(x, y, [&count](Character*) { count++; });
+    return count;
+}
+
+int TileOccupancy::getBlockingCount(int x, int y) const {
+    int tile = tileIndex(x, y);
+    return tile < 0 ? 0 : blockingCounts[tile];
+}
+
+bool TileOccupancy::tryReserve(OccupantId id, int x, int y) {
+    int tile = tileIndex(x, y);
+    if (tile < 0 || id >= occupants.size()) {
+        return false;
+    }
+    Occupant& occupant = occupants[id];
+    if (occupant.reservedTile == tile) {
+        return true;
+    }
+
+    // Blocking occupants can only change on the committing thread, so checking first is enough
+    int blockers = blockingCounts[tile] - ((occupant.blocking && occupant.tile == tile) ? 1 : 0);
+    if (blockers > 0) {
+        return false;
+    }
+    uint32_t expected = UNRESERVED;
+    if (!reservations[tile].compare_exchange_strong(expected, id + 1, std::memory_order_acq_rel)) {
+        return false;
+    }
+
+    release(id);
+    occupant.reservedTile = tile;
+    return true;
+}
+
+void TileOccupancy::release(OccupantId id) {
+    Occupant& occupant = occupants[id];
+    if (occupant.reservedTile != NONE) {
+        reservations[occupant.reservedTile].store(UNRESERVED, std::memory_order_release);
+        occupant.reservedTile = NONE;
+    }
+}
+
+int TileOccupancy::tileIndex(int x, int y) const {
+    if (x < 0 || x >= width || y < 0 || y >= height) {
+        return NONE;
+    }
+    return y * width + x;
+}
+
+int TileOccupancy::tileIndexAt(float x, float y) const {
+    // Same rounding the rest of the game uses to map positions to tiles
+    return tileIndex(static_cast<int>(std::round(x)), static_cast<int>(std::round(y)));
+}
+
+void TileOccupancy::link(OccupantId id, int tile) {
+    Occupant& occupant = occupants[id];
+    occupant.tile = tile;
+    occupant.previous = NONE;
+    occupant.next = NONE;
+    if (tile == NONE) {
+        return;
+    }
+
+    // Push onto the front of the tile's list
+    occupant.next = heads[tile];
+    if (heads[tile] != NONE) {
+        occupants[heads[tile]].previous = static_cast<int32_t>(id);
+    }
+    heads[tile] = static_cast<int32_t>(id);
+    if (occupant.blocking) {
+        blockingCounts[tile]++;
+    }
+}
+
+void TileOccupancy::unlink(OccupantId id) {
+    Occupant& occupant = occupants[id];
+    if (occupant.tile == NONE) {
+        return;
+    }
+
+    if (occupant.previous != NONE) {
+        occupants[occupant.previous].next = occupant.next;
+    } else {
+        heads[occupant.tile] = occupant.next;
+    }
+    if (occupant.next != NONE) {
+        occupants[occupant.next].previous = occupant.previous;
+    }
+    if (occupant.blocking) {
+        blockingCounts[occupant.tile]--;
+    }
+    occupant.tile = NONE;
+    occupant.previous = NONE;
+    occupant.next = NONE;
+}
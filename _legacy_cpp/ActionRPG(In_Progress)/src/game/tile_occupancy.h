@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class Character;
+
+// Which characters stand on which tile. Characters register once and then
+// keep their entry current from Character::move. Every tile keeps a count of
+// blocking occupants, a list of all occupants and an optional reservation, so
+// "is this tile free" is a couple of array reads no matter how many
+// characters exist.
+//
+// Moving is reserve-then-commit: tryReserve claims the destination atomically,
+// and the move itself commits it. Two movers can never both win the same tile.
+class TileOccupancy {
+public:
+    using OccupantId = uint32_t;
+    static constexpr OccupantId INVALID_OCCUPANT = UINT32_MAX;
+
+    TileOccupancy();
+    ~TileOccupancy();
+
+    // Size the grid for a level; forgets every occupant
+    void reset(int width, int height);
+
+    // Register a character at its current tile. Non-blocking occupants are
+    // listed on their tile but never stop anyone else from entering it.
+    OccupantId add(Character* character, bool blocking);
+    void remove(OccupantId id);
+    // The occupant's Character object was moved to a new address
+    void relocate(OccupantId id, Character* character);
+    // Detach every registered character
+    void clear();
+
+    // Called from Character::move; commits the occupant's reservation if it had one
+    void onMoved(OccupantId id, float x, float y);
+
+    // Occupied by a blocking occupant or reserved
+    bool isOccupied(int x, int y) const;
+    // Could this occupant enter the tile, ignoring its own presence and reservation
+    bool isFreeFor(int x, int y, OccupantId id) const;
+    int getOccupantCount(int x, int y) const;
+    int getBlockingCount(int x, int y) const;
+
+    // Claim a tile for the occupant's next move, releasing any earlier claim.
+    // Safe to call from several threads; only one caller wins a tile.
+    bool tryReserve(OccupantId id, int x, int y);
+    void release(OccupantId id);
+
+    // Visit every occupant listed on a tile
+    template <typename Function>
+    void forEachOccupant(int x, int y, Function&& function) const {
+        int tile = tileIndex(x, y);
+        if (tile < 0) {
+            return;
+        }
+        for (int32_t slot = heads[tile]; slot != NONE; slot = occupants[slot].next) {
+            function(occupants[slot].character);
+        }
+    }
+
+private:
+    static constexpr int32_t NONE = -1;
+    static constexpr uint32_t UNRESERVED = 0; // Reservations store id + 1
+
+    struct Occupant {
+        Character* character = nullptr;
+        int32_t tile = NONE;
+        int32_t reservedTile = NONE;
+        int32_t previous = NONE;
+        int32_t next = NONE;
+        bool blocking = false;
+    };
+
+    int width = 0;
+    int height = 0;
+
+    // Per tile
+    std::vector<uint16_t> blockingCounts;
+    std::vector<int32_t> heads;
+    std::unique_ptr<std::atomic<uint32_t>[]> reservations;
+
+    // Per occupant; ids are indices and are reused
+    std::vector<Occupant> occupants;
+    std::vector<OccupantId> freeIds;
+
+    int tileIndex(int x, int y) const;
+    int tileIndexAt(float x, float y) const;
+    void link(OccupantId id, int tile);
+    void unlink(OccupantId id);
+};
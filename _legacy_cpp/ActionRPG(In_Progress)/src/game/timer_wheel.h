@@ -0,0 +1,232 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Reference to a scheduled timer; goes stale once the timer fires or is cancelled
+struct TimerHandle {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool isValid() const { return index != UINT32_MAX; }
+};
+
+// Hashed hierarchical timer wheel. Time advances in fixed ticks; a timer sits
+// in the slot of the finest level whose span covers its remaining delay, and
+// drops to finer levels as time reaches its slot. Scheduling and cancelling
+// are O(1), and advancing only visits slots that actually come due, so a
+// million idle timers cost nothing per tick.
+//
+// Each timer carries an owner and a small kind tag that are handed back when it fires.
+template <typename T>
+class TimerWheel {
+public:
+    static constexpr int LEVELS = 4;
+    static constexpr int SLOT_BITS = 6;
+    static constexpr int SLOTS = 1 << SLOT_BITS;
+
+    explicit TimerWheel(float tickSeconds = 0.01f) { reset(tickSeconds); }
+
+    // Drop every timer and restart the clock at zero
+    void reset(float newTickSeconds) {
+        tickSeconds = newTickSeconds;
+        currentTick = 0;
+        elapsed = 0.0;
+        nodes.clear();
+        freeNodes.clear();
+        pendingCount = 0;
+        for (int32_t& head : heads) {
+            head = NONE;
+        }
+    }
+
+    // Fire after delaySeconds; always at least one tick from now
+    TimerHandle schedule(float delaySeconds, T owner, uint8_t kind) {
+        uint64_t ticks = delaySeconds > 0.0f ? static_cast<uint64_t>(std::ceil(delaySeconds / tickSeconds)) : 0;
+        if (ticks == 0) {
+            ticks = 1;
+        }
+
+        int32_t index;
+        if (!freeNodes.empty()) {
+            index = freeNodes.back();
+            freeNodes.pop_back();
+        } else {
+            index = static_cast<int32_t>(nodes.size());
+            nodes.emplace_back();
+        }
+
+        Node& node = nodes[index];
+        node.deadline = currentTick + ticks;
+        node.owner = owner;
+        node.kind = kind;
+        link(index);
+        pendingCount++;
+
+        TimerHandle handle;
+        handle.index = static_cast<uint32_t>(index);
+        handle.generation = node.generation;
+        return handle;
+    }
+
+    // Returns false if the timer already fired or was cancelled; clears the handle either way
+    bool cancel(TimerHandle& handle) {
+        bool wasPending = isPending(handle);
+        if (wasPending) {
+            unlink(static_cast<int32_t>(handle.index));
+            release(static_cast<int32_t>(handle.index));
+        }
+        handle = TimerHandle();
+        return wasPending;
+    }
+
+    // Move a pending timer to a new delay, or schedule a fresh one if it had already gone
+    void reschedule(TimerHandle& handle, float delaySeconds, T owner, uint8_t kind) {
+        cancel(handle);
+        handle = schedule(delaySeconds, owner, kind);
+    }
+
+    bool isPending(const TimerHandle& handle) const {
+        return handle.index < nodes.size() && nodes[handle.index].slot != NONE &&
+               nodes[handle.index].generation == handle.generation;
+    }
+
+    size_t getPendingCount() const { return pendingCount; }
+    double getTime() const { return elapsed; }
+
+    // Advance the clock and call onFire(owner, kind) for every timer that came due.
+    // Callbacks may schedule, reschedule and cancel timers, including ones due in the
+    // same tick that haven't fired yet (those then don't fire); new timers never fire
+    // in the same call. Callbacks must not call advance.
+    template <typename Function>
+    void advance(float deltaSeconds, Function&& onFire) {
+        elapsed += deltaSeconds;
+        uint64_t targetTick = static_cast<uint64_t>(elapsed / tickSeconds);
+
+        while (currentTick < targetTick) {
+            currentTick++;
+
+            // Entering a new block of a coarser level: spread its timers over the finer levels
+            for (int level = 1; level < LEVELS; level++) {
+                if ((currentTick & ((uint64_t(1) << (SLOT_BITS * level)) - 1)) != 0) {
+                    break;
+                }
+                cascade(level, static_cast<int>((currentTick >> (SLOT_BITS * level)) & (SLOTS - 1)));
+            }
+
+            // Detach the whole due list before any callback runs: a cancelled node can be
+            // released and reused by a callback, so its links can't be followed afterwards
+            int slot = static_cast<int>(currentTick & (SLOTS - 1));
+            dueNodes.clear();
+            for (int32_t index = heads[slot]; index != NONE; index = nodes[index].next) {
+                nodes[index].slot = DUE;
+                dueNodes.push_back(DueNode{index, nodes[index].generation});
+            }
+            heads[slot] = NONE;
+
+            for (const DueNode& due : dueNodes) {
+                // Cancelled by an earlier callback, and possibly handed out again since
+                Node& node = nodes[due.index];
+                if (node.generation != due.generation || node.slot != DUE) {
+                    continue;
+                }
+                T owner = node.owner;
+                uint8_t kind = node.kind;
+                release(due.index);
+                onFire(owner, kind);
+            }
+        }
+    }
+
+private:
+    static constexpr int32_t NONE = -1;
+    static constexpr int32_t DUE = -2; // Slot of a timer taken off the wheel to fire this tick
+
+    struct Node {
+        uint64_t deadline = 0;
+        T owner{};
+        uint8_t kind = 0;
+        uint32_t generation = 0;
+        int32_t slot = NONE;  // Index into heads while pending, or DUE
+        int32_t previous = NONE;
+        int32_t next = NONE;
+    };
+
+    float tickSeconds = 0.01f;
+    uint64_t currentTick = 0;
+    double elapsed = 0.0;
+
+    std::vector<Node> nodes;
+    std::vector<int32_t> freeNodes;
+    int32_t heads[LEVELS * SLOTS];
+    size_t pendingCount = 0;
+
+    // Timers firing in the current tick; kept between ticks so advancing doesn't allocate
+    struct DueNode {
+        int32_t index;
+        uint32_t generation;
+    };
+    std::vector<DueNode> dueNodes;
+
+    void link(int32_t index) {
+        Node& node = nodes[index];
+        uint64_t delta = node.deadline - currentTick;
+
+        // Finest level whose span covers the delay; anything further out waits in the top level
+        int level = 0;
+        while (level < LEVELS - 1 && delta >= (uint64_t(1) << (SLOT_BITS * (level + 1)))) {
+            level++;
+        }
+        uint64_t deadline = node.deadline;
+        uint64_t maxDelta = (uint64_t(1) << (SLOT_BITS * LEVELS)) - 1;
+        if (delta > maxDelta) {
+            deadline = currentTick + maxDelta;
+        }
+
+        int slot = level * SLOTS + static_cast<int>((deadline >> (SLOT_BITS * level)) & (SLOTS - 1));
+        node.slot = slot;
+        node.previous = NONE;
+        node.next = heads[slot];
+        if (heads[slot] != NONE) {
+            nodes[heads[slot]].previous = index;
+        }
+        heads[slot] = index;
+    }
+
+    void unlink(int32_t index) {
+        Node& node = nodes[index];
+        if (node.slot == DUE) {
+            // Already off the wheel; advance skips it once it is released
+            node.slot = NONE;
+            return;
+        }
+        if (node.previous != NONE) {
+            nodes[node.previous].next = node.next;
+        } else {
+            heads[node.slot] = node.next;
+        }
+        if (node.next != NONE) {
+            nodes[node.next].previous = node.previous;
+        }
+        node.slot = NONE;
+    }
+
+    void release(int32_t index) {
+        nodes[index].generation++;
+        nodes[index].slot = NONE;
+        freeNodes.push_back(index);
+        pendingCount--;
+    }
+
+    void cascade(int level, int slot) {
+        int32_t index = heads[level * SLOTS + slot];
+        heads[level * SLOTS + slot] = NONE;
+        while (index != NONE) {
+            int32_t next = nodes[index].next;
+            link(index);
+            index = next;
+        }
+    }
+};
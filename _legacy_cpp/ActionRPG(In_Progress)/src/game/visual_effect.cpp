@@ -3,14 +3,69 @@
 #include <iostream>
 
 // Define static color constants
-const float VisualEffect::SLASH_COLOR[3] = {0.9f, 0.9f, 0.1f};      // Yellow
-const float VisualEffect::ARROW_COLOR[3] = {0.2f, 0.8f, 0.2f};      // Green
-const float VisualEffect::FIREBALL_COLOR[3] = {0.9f, 0.4f, 0.1f};   // Orange-red
+const float VisualEffectManager::SLASH_COLOR[3] = {0.9f, 0.9f, 0.1f};      // Yellow
+const float VisualEffectManager::ARROW_COLOR[3] = {0.2f, 0.8f, 0.2f};      // Green
+const float VisualEffectManager::FIREBALL_COLOR[3] = {0.9f, 0.4f, 0.1f};   // Orange-red
 
-VisualEffect::VisualEffect(Character::VisualEffectType type, float startX, float startY, float endX, float endY)
-    : type(type), startX(startX), startY(startY), endX(endX), endY(endY), scale(1.0f), rotation(0.0f) {
-    
+namespace {
+    // Unit circle points shared by every fireball, including the closing point
+    struct CircleTable {
+        float cosines[13];
+        float sines[13];
+
+        CircleTable() {
+            for (int i = 0; i <= 12; i++) {
+                float angle = 2.0f * 3.14159f * i / 12;
+                cosines[i] = std::cos(angle);
+                sines[i] = std::sin(angle);
+            }
+        }
+    };
+
+    const CircleTable& circleTable() {
+        static const CircleTable table;
+        return table;
+    }
+}
+
+// EffectPool implementation
+EffectPool::EffectPool() {
+}
+
+EffectPool::~EffectPool() {
+}
+
+void EffectPool::reserve(size_t newCapacity) {
+    records.reset(new EffectRecord[newCapacity]);
+    capacity = newCapacity;
+    count = 0;
+}
+
+bool EffectPool::spawn(const EffectRecord& record) {
+    if (count == capacity) {
+        return false;
+    }
+    records[count++] = record;
+    return true;
+}
+
+void EffectPool::retire(size_t index) {
+    records[index] = records[--count];
+}
+
+// VisualEffectManager implementation
+VisualEffectManager::VisualEffectManager() {
+    getPool(Character::VisualEffectType::SLASH).reserve(MAX_EFFECTS_PER_TYPE);
+    getPool(Character::VisualEffectType::ARROW).reserve(MAX_EFFECTS_PER_TYPE);
+    getPool(Character::VisualEffectType::FIREBALL).reserve(MAX_EFFECTS_PER_TYPE);
+}
+
+VisualEffectManager::~VisualEffectManager() {
+}
+
+void VisualEffectManager::addEffect(Character::VisualEffectType type, float startX, float startY, float endX, float endY) {
     // Set lifetime based on effect type
+    float maxLifetime;
     switch (type) {
         case Character::VisualEffectType::SLASH:
             maxLifetime = 0.3f;  // Short duration for slash
@@ -22,289 +77,205 @@ VisualEffect::VisualEffect(Character::VisualEffectType type, float startX, float
             maxLifetime = 0.7f;  // Longer duration for fireball
             break;
         default:
-            maxLifetime = 0.5f;
+            return;
     }
-    
-    lifetime = maxLifetime;
-}
 
-VisualEffect::~VisualEffect() {
+    // A full pool drops the new effect; it is purely cosmetic
+    if (!getPool(type).spawn(EffectRecord{startX, startY, endX, endY, maxLifetime, maxLifetime})) {
+        droppedCount++;
+    }
 }
 
-void VisualEffect::update(float deltaTime) {
-    lifetime -= deltaTime;
-    if (lifetime < 0.0f) {
-        lifetime = 0.0f;
-    }
-    
-    // Update effect properties based on lifetime
-    float progress = 1.0f - (lifetime / maxLifetime);
-    
-    // Different effects have different animations
-    switch (type) {
-        case Character::VisualEffectType::SLASH:
-            // Slash grows and fades
-            scale = 1.0f + progress * 0.5f;
-            rotation = progress * 3.14159f; // Rotate 180 degrees
-            break;
-            
-        case Character::VisualEffectType::ARROW:
-            // Arrow moves from start to end
-            // No special animation needed as position is interpolated in generateVertices
-            break;
-            
-        case Character::VisualEffectType::FIREBALL:
-            // Fireball grows slightly and pulses
-            scale = 1.0f + 0.2f * sin(progress * 10.0f);
-            break;
-            
-        default:
-            break;
+void VisualEffectManager::update(float deltaTime) {
+    for (EffectPool& pool : pools) {
+        EffectRecord* records = pool.data();
+        size_t i = 0;
+        while (i < pool.size()) {
+            records[i].lifetime -= deltaTime;
+            if (records[i].isFinished()) {
+                // The last record moves into this slot, so look at it next
+                pool.retire(i);
+            } else {
+                i++;
+            }
+        }
     }
 }
 
-std::vector<Vertex> VisualEffect::generateVertices() const {
-    switch (type) {
-        case Character::VisualEffectType::SLASH:
-            return generateSlashVertices();
-        case Character::VisualEffectType::ARROW:
-            return generateArrowVertices();
-        case Character::VisualEffectType::FIREBALL:
-            return generateFireballVertices();
-        default:
-            return std::vector<Vertex>();
+size_t VisualEffectManager::getEffectCount() const {
+    size_t count = 0;
+    for (const EffectPool& pool : pools) {
+        count += pool.size();
     }
+    return count;
 }
 
-std::vector<Vertex> VisualEffect::generateSlashVertices() const {
-    std::vector<Vertex> vertices;
-    
-    if (lifetime <= 0.0f) return vertices;
-    
-    // Calculate position (slash appears at the end position)
-    float x = endX;
-    float y = endY;
-    
-    // Calculate alpha based on lifetime
-    float alpha = lifetime / maxLifetime;
-    
-    // Create a slash shape (diagonal line with thickness)
-    float size = 0.15f * scale;
-    float thickness = 0.03f * scale;
-    
-    // Apply rotation
-    float cosR = cos(rotation);
-    float sinR = sin(rotation);
-    
-    // Define the four corners of the slash
-    float x1 = -size, y1 = -size;
-    float x2 = size, y2 = -size;
-    float x3 = -size + thickness, y3 = size;
-    float x4 = size + thickness, y4 = size;
-    
-    // Rotate points
-    float rx1 = x1 * cosR - y1 * sinR;
-    float ry1 = x1 * sinR + y1 * cosR;
-    float rx2 = x2 * cosR - y2 * sinR;
-    float ry2 = x2 * sinR + y2 * cosR;
-    float rx3 = x3 * cosR - y3 * sinR;
-    float ry3 = x3 * sinR + y3 * cosR;
-    float rx4 = x4 * cosR - y4 * sinR;
-    float ry4 = x4 * sinR + y4 * cosR;
-    
-    // Create vertices with color
-    Vertex v1 = {{x + rx1, y + ry1}, {SLASH_COLOR[0], SLASH_COLOR[1], SLASH_COLOR[2]}};
-    Vertex v2 = {{x + rx2, y + ry2}, {SLASH_COLOR[0], SLASH_COLOR[1], SLASH_COLOR[2]}};
-    Vertex v3 = {{x + rx3, y + ry3}, {SLASH_COLOR[0], SLASH_COLOR[1], SLASH_COLOR[2]}};
-    Vertex v4 = {{x + rx4, y + ry4}, {SLASH_COLOR[0], SLASH_COLOR[1], SLASH_COLOR[2]}};
-    
-    // First triangle
-    vertices.push_back(v1);
-    vertices.push_back(v2);
-    vertices.push_back(v3);
-    
-    // Second triangle
-    vertices.push_back(v2);
-    vertices.push_back(v4);
-    vertices.push_back(v3);
-    
-    return vertices;
+FrameVector<Vertex> VisualEffectManager::generateAllEffectVertices() const {
+    FrameVector<Vertex> allVertices(&FrameArena::get());
+    appendAllEffectVertices(allVertices);
+    return allVertices;
 }
 
-std::vector<Vertex> VisualEffect::generateArrowVertices() const {
-    std::vector<Vertex> vertices;
-    
-    if (lifetime <= 0.0f) return vertices;
-    
-    // Calculate position (interpolate from start to end)
-    float progress = 1.0f - (lifetime / maxLifetime);
-    float x = startX + (endX - startX) * progress;
-    float y = startY + (endY - startY) * progress;
-    
-    // Calculate direction for arrow orientation
-    float dx = endX - startX;
-    float dy = endY - startY;
-    float length = sqrt(dx * dx + dy * dy);
-    
-    if (length > 0.001f) {
-        dx /= length;
-        dy /= length;
-    } else {
-        dx = 1.0f;
-        dy = 0.0f;
-    }
-    
-    // Calculate perpendicular direction
-    float px = -dy;
-    float py = dx;
-    
-    // Arrow dimensions
-    float arrowLength = 0.1f * scale;
-    float arrowWidth = 0.03f * scale;
-    float headSize = 0.05f * scale;
-    
-    // Arrow body vertices
-    float tailX = x - dx * arrowLength;
-    float tailY = y - dy * arrowLength;
-    
-    // Arrow body
-    Vertex v1 = {{tailX - px * arrowWidth, tailY - py * arrowWidth}, {ARROW_COLOR[0], ARROW_COLOR[1], ARROW_COLOR[2]}};
-    Vertex v2 = {{tailX + px * arrowWidth, tailY + py * arrowWidth}, {ARROW_COLOR[0], ARROW_COLOR[1], ARROW_COLOR[2]}};
-    Vertex v3 = {{x - px * arrowWidth, y - py * arrowWidth}, {ARROW_COLOR[0], ARROW_COLOR[1], ARROW_COLOR[2]}};
-    Vertex v4 = {{x + px * arrowWidth, y + py * arrowWidth}, {ARROW_COLOR[0], ARROW_COLOR[1], ARROW_COLOR[2]}};
-    
-    // Arrow head
-    Vertex v5 = {{x, y}, {ARROW_COLOR[0], ARROW_COLOR[1], ARROW_COLOR[2]}};
-    Vertex v6 = {{x + dx * headSize, y + dy * headSize}, {ARROW_COLOR[0], ARROW_COLOR[1], ARROW_COLOR[2]}};
-    Vertex v7 = {{x - px * headSize, y - py * headSize}, {ARROW_COLOR[0], ARROW_COLOR[1], ARROW_COLOR[2]}};
-    Vertex v8 = {{x + px * headSize, y + py * headSize}, {ARROW_COLOR[0], ARROW_COLOR[1], ARROW_COLOR[2]}};
-    
-    // Body triangles
-    vertices.push_back(v1);
-    vertices.push_back(v2);
-    vertices.push_back(v3);
-    
-    vertices.push_back(v2);
-    vertices.push_back(v4);
-    vertices.push_back(v3);
-    
-    // Head triangles
-    vertices.push_back(v5);
-    vertices.push_back(v7);
-    vertices.push_back(v6);
-    
-    vertices.push_back(v5);
-    vertices.push_back(v6);
-    vertices.push_back(v8);
-    
-    return vertices;
+void VisualEffectManager::appendAllEffectVertices(FrameVector<Vertex>& vertices) const {
+    const EffectPool& slashes = getPool(Character::VisualEffectType::SLASH);
+    const EffectPool& arrows = getPool(Character::VisualEffectType::ARROW);
+    const EffectPool& fireballs = getPool(Character::VisualEffectType::FIREBALL);
+
+    // Every type has a fixed vertex count, so grow the buffer once and write straight into it
+    size_t first = vertices.size();
+    vertices.resize(first + slashes.size() * SLASH_VERTICES +
+                    arrows.size() * ARROW_VERTICES +
+                    fireballs.size() * FIREBALL_VERTICES);
+    Vertex* out = vertices.data() + first;
+    out = emitSlashVertices(slashes, out);
+    out = emitArrowVertices(arrows, out);
+    emitFireballVertices(fireballs, out);
 }
 
-std::vector<Vertex> VisualEffect::generateFireballVertices() const {
-    std::vector<Vertex> vertices;
-    
-    if (lifetime <= 0.0f) return vertices;
-    
-    // Calculate position (interpolate from start to end)
-    float progress = 1.0f - (lifetime / maxLifetime);
-    float x = startX + (endX - startX) * progress;
-    float y = startY + (endY - startY) * progress;
-    
-    // Calculate alpha based on lifetime
-    float alpha = lifetime / maxLifetime;
-    
-    // Create a fireball (circle with inner and outer parts)
-    float outerRadius = 0.12f * scale;
-    float innerRadius = 0.08f * scale;
-    int segments = 12;
-    
-    // Outer circle (orange-red)
-    for (int i = 0; i < segments; i++) {
-        float angle1 = 2.0f * 3.14159f * i / segments;
-        float angle2 = 2.0f * 3.14159f * (i + 1) / segments;
-        
-        float x1 = x + cos(angle1) * outerRadius;
-        float y1 = y + sin(angle1) * outerRadius;
-        float x2 = x + cos(angle2) * outerRadius;
-        float y2 = y + sin(angle2) * outerRadius;
-        
-        Vertex v1 = {{x, y}, {FIREBALL_COLOR[0], FIREBALL_COLOR[1], FIREBALL_COLOR[2]}};
-        Vertex v2 = {{x1, y1}, {FIREBALL_COLOR[0], FIREBALL_COLOR[1], FIREBALL_COLOR[2]}};
-        Vertex v3 = {{x2, y2}, {FIREBALL_COLOR[0], FIREBALL_COLOR[1], FIREBALL_COLOR[2]}};
-        
-        vertices.push_back(v1);
-        vertices.push_back(v2);
-        vertices.push_back(v3);
-    }
-    
-    // Inner circle (brighter)
-    for (int i = 0; i < segments; i++) {
-        float angle1 = 2.0f * 3.14159f * i / segments;
-        float angle2 = 2.0f * 3.14159f * (i + 1) / segments;
-        
-        float x1 = x + cos(angle1) * innerRadius;
-        float y1 = y + sin(angle1) * innerRadius;
-        float x2 = x + cos(angle2) * innerRadius;
-        float y2 = y + sin(angle2) * innerRadius;
-        
-        Vertex v1 = {{x, y}, {1.0f, 0.9f, 0.3f}}; // Bright yellow core
-        Vertex v2 = {{x1, y1}, {1.0f, 0.7f, 0.2f}};
-        Vertex v3 = {{x2, y2}, {1.0f, 0.7f, 0.2f}};
-        
-        vertices.push_back(v1);
-        vertices.push_back(v2);
-        vertices.push_back(v3);
+Vertex* VisualEffectManager::emitSlashVertices(const EffectPool& pool, Vertex* out) {
+    const EffectRecord* records = pool.data();
+    for (size_t i = 0; i < pool.size(); i++) {
+        const EffectRecord& effect = records[i];
+        float progress = effect.getProgress();
+
+        // Slash grows while rotating 180 degrees, and appears at the end position
+        float scale = 1.0f + progress * 0.5f;
+        float rotation = progress * 3.14159f;
+        float x = effect.endX;
+        float y = effect.endY;
+
+        // Create a slash shape (diagonal line with thickness)
+        float size = 0.15f * scale;
+        float thickness = 0.03f * scale;
+
+        // Apply rotation
+        float cosR = std::cos(rotation);
+        float sinR = std::sin(rotation);
+
+        // Define the four corners of the slash
+        float x1 = -size, y1 = -size;
+        float x2 = size, y2 = -size;
+        float x3 = -size + thickness, y3 = size;
+        float x4 = size + thickness, y4 = size;
+
+        Vertex v1 = {{x + x1 * cosR - y1 * sinR, y + x1 * sinR + y1 * cosR}, {SLASH_COLOR[0], SLASH_COLOR[1], SLASH_COLOR[2]}};
+        Vertex v2 = {{x + x2 * cosR - y2 * sinR, y + x2 * sinR + y2 * cosR}, {SLASH_COLOR[0], SLASH_COLOR[1], SLASH_COLOR[2]}};
+        Vertex v3 = {{x + x3 * cosR - y3 * sinR, y + x3 * sinR + y3 * cosR}, {SLASH_COLOR[0], SLASH_COLOR[1], SLASH_COLOR[2]}};
+        Vertex v4 = {{x + x4 * cosR - y4 * sinR, y + x4 * sinR + y4 * cosR}, {SLASH_COLOR[0], SLASH_COLOR[1], SLASH_COLOR[2]}};
+
+        // Two triangles
+        *out++ = v1;
+        *out++ = v2;
+        *out++ = v3;
+        *out++ = v2;
+        *out++ = v4;
+        *out++ = v3;
     }
-    
-    return vertices;
+    return out;
 }
 
-std::shared_ptr<VisualEffect> VisualEffect::createEffect(Character::VisualEffectType type, 
-                                                        float startX, float startY, 
-                                                        float endX, float endY) {
-    return std::make_shared<VisualEffect>(type, startX, startY, endX, endY);
-}
+Vertex* VisualEffectManager::emitArrowVertices(const EffectPool& pool, Vertex* out) {
+    // Arrow dimensions; arrows never scale
+    const float arrowLength = 0.1f;
+    const float arrowWidth = 0.03f;
+    const float headSize = 0.05f;
 
-// VisualEffectManager implementation
-VisualEffectManager::VisualEffectManager() {
-}
+    const EffectRecord* records = pool.data();
+    for (size_t i = 0; i < pool.size(); i++) {
+        const EffectRecord& effect = records[i];
 
-VisualEffectManager::~VisualEffectManager() {
-    clear();
-}
+        // Calculate position (interpolate from start to end)
+        float progress = effect.getProgress();
+        float x = effect.startX + (effect.endX - effect.startX) * progress;
+        float y = effect.startY + (effect.endY - effect.startY) * progress;
 
-void VisualEffectManager::addEffect(Character::VisualEffectType type, float startX, float startY, float endX, float endY) {
-    auto effect = VisualEffect::createEffect(type, startX, startY, endX, endY);
-    activeEffects.push_back(effect);
-}
+        // Calculate direction for arrow orientation
+        float dx = effect.endX - effect.startX;
+        float dy = effect.endY - effect.startY;
+        float length = std::sqrt(dx * dx + dy * dy);
 
-void VisualEffectManager::update(float deltaTime) {
-    // Update all effects
-    for (auto& effect : activeEffects) {
-        effect->update(deltaTime);
+        if (length > 0.001f) {
+            dx /= length;
+            dy /= length;
+        } else {
+            dx = 1.0f;
+            dy = 0.0f;
+        }
+
+        // Calculate perpendicular direction
+        float px = -dy;
+        float py = dx;
+
+        float tailX = x - dx * arrowLength;
+        float tailY = y - dy * arrowLength;
+
+        // Arrow body
+        Vertex v1 = {{tailX - px * arrowWidth, tailY - py * arrowWidth}, {ARROW_COLOR[0], ARROW_COLOR[1], ARROW_COLOR[2]}};
+        Vertex v2 = {{tailX + px * arrowWidth, tailY + py * arrowWidth}, {ARROW_COLOR[0], ARROW_COLOR[1], ARROW_COLOR[2]}};
+        Vertex v3 = {{x - px * arrowWidth, y - py * arrowWidth}, {ARROW_COLOR[0], ARROW_COLOR[1], ARROW_COLOR[2]}};
+        Vertex v4 = {{x + px * arrowWidth, y + py * arrowWidth}, {ARROW_COLOR[0], ARROW_COLOR[1], ARROW_COLOR[2]}};
+
+        // Arrow head
+        Vertex v5 = {{x, y}, {ARROW_COLOR[0], ARROW_COLOR[1], ARROW_COLOR[2]}};
+        Vertex v6 = {{x + dx * headSize, y + dy * headSize}, {ARROW_COLOR[0], ARROW_COLOR[1], ARROW_COLOR[2]}};
+        Vertex v7 = {{x - px * headSize, y - py * headSize}, {ARROW_COLOR[0], ARROW_COLOR[1], ARROW_COLOR[2]}};
+        Vertex v8 = {{x + px * headSize, y + py * headSize}, {ARROW_COLOR[0], ARROW_COLOR[1], ARROW_COLOR[2]}};
+
+        // Body triangles
+        *out++ = v1;
+        *out++ = v2;
+        *out++ = v3;
+        *out++ = v2;
+        *out++ = v4;
+        *out++ = v3;
+
+        // Head triangles
+        *out++ = v5;
+        *out++ = v7;
+        *out++ = v6;
+        *out++ = v5;
+        *out++ = v6;
+        *out++ = v8;
     }
-    
-    // Remove finished effects
-    activeEffects.erase(
-        std::remove_if(activeEffects.begin(), activeEffects.end(),
-                      [](const std::shared_ptr<VisualEffect>& effect) {
-                          return effect->isFinished();
-                      }),
-        activeEffects.end()
-    );
+    return out;
 }
 
-std::vector<Vertex> VisualEffectManager::generateAllEffectVertices() const {
-    std::vector<Vertex> allVertices;
-    
-    for (const auto& effect : activeEffects) {
-        auto effectVertices = effect->generateVertices();
-        allVertices.insert(allVertices.end(), effectVertices.begin(), effectVertices.end());
+Vertex* VisualEffectManager::emitFireballVertices(const EffectPool& pool, Vertex* out) {
+    const CircleTable& circle = circleTable();
+
+    const EffectRecord* records = pool.data();
+    for (size_t i = 0; i < pool.size(); i++) {
+        const EffectRecord& effect = records[i];
+
+        // Calculate position (interpolate from start to end)
+        float progress = effect.getProgress();
+        float x = effect.startX + (effect.endX - effect.startX) * progress;
+        float y = effect.startY + (effect.endY - effect.startY) * progress;
+
+        // Fireball grows slightly and pulses
+        float scale = 1.0f + 0.2f * std::sin(progress * 10.0f);
+        float outerRadius = 0.12f * scale;
+        float innerRadius = 0.08f * scale;
+
+        // Outer circle (orange-red)
+        for (int s = 0; s < FIREBALL_SEGMENTS; s++) {
+            *out++ = {{x, y}, {FIREBALL_COLOR[0], FIREBALL_COLOR[1], FIREBALL_COLOR[2]}};
+            *out++ = {{x + circle.cosines[s] * outerRadius, y + circle.sines[s] * outerRadius}, {FIREBALL_COLOR[0], FIREBALL_COLOR[1], FIREBALL_COLOR[2]}};
+            *out++ = {{x + circle.cosines[s + 1] * outerRadius, y + circle.sines[s + 1] * outerRadius}, {FIREBALL_COLOR[0], FIREBALL_COLOR[1], FIREBALL_COLOR[2]}};
+        }
+
+        // Inner circle (brighter)
+        for (int s = 0; s < FIREBALL_SEGMENTS; s++) {
+            *out++ = {{x, y}, {1.0f, 0.9f, 0.3f}}; // Bright yellow core
+            *out++ = {{x + circle.cosines[s] * innerRadius, y + circle.sines[s] * innerRadius}, {1.0f, 0.7f, 0.2f}};
+            *out++ = {{x + circle.cosines[s + 1] * innerRadius, y + circle.sines[s + 1] * innerRadius}, {1.0f, 0.7f, 0.2f}};
+        }
     }
-    
-    return allVertices;
+    return out;
 }
 
 void VisualEffectManager::clear() {
-    activeEffects.clear();
+    for (EffectPool& pool : pools) {
+        pool.clear();
+    }
 }
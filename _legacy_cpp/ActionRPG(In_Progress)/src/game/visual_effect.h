@@ -1,56 +1,90 @@
 #pragma once
 
-#include <vector>
+#include <cstddef>
 #include <memory>
+#include <vector>
 #include "character.h"
 #include "../engine/vertex.h"
+#include "../engine/frame_arena.h"
 
-class VisualEffect {
-public:
-    VisualEffect(Character::VisualEffectType type, float startX, float startY, float endX, float endY);
-    ~VisualEffect();
-    
-    void update(float deltaTime);
-    std::vector<Vertex> generateVertices() const;
-    bool isFinished() const { return lifetime <= 0.0f; }
-    
-    // Static factory method to create effects
-    static std::shared_ptr<VisualEffect> createEffect(Character::VisualEffectType type, 
-                                                     float startX, float startY, 
-                                                     float endX, float endY);
-    
-private:
-    Character::VisualEffectType type;
+// One live effect. Plain data so the pool can move it with a copy; scale and
+// rotation are worked out from progress when drawing.
+struct EffectRecord {
     float startX, startY;
     float endX, endY;
     float lifetime;
     float maxLifetime;
-    float scale;
-    float rotation;
-    
-    // Colors for different effect types
-    static const float SLASH_COLOR[3];
-    static const float ARROW_COLOR[3];
-    static const float FIREBALL_COLOR[3];
-    
-    // Generate vertices for different effect types
-    std::vector<Vertex> generateSlashVertices() const;
-    std::vector<Vertex> generateArrowVertices() const;
-    std::vector<Vertex> generateFireballVertices() const;
+
+    bool isFinished() const { return lifetime <= 0.0f; }
+    float getProgress() const { return 1.0f - (lifetime / maxLifetime); }
 };
 
-// Class to manage all active visual effects
+// Fixed-capacity storage for the effects of one type. Live records are packed
+// at the front, so spawning appends and retiring moves the last record into the hole.
+class EffectPool {
+public:
+    EffectPool();
+    ~EffectPool();
+
+    // Allocates once; never grows afterwards
+    void reserve(size_t capacity);
+
+    // Returns false when the pool is full
+    bool spawn(const EffectRecord& record);
+    void retire(size_t index);
+    void clear() { count = 0; }
+
+    size_t size() const { return count; }
+    size_t getCapacity() const { return capacity; }
+    EffectRecord* data() { return records.get(); }
+    const EffectRecord* data() const { return records.get(); }
+
+private:
+    std::unique_ptr<EffectRecord[]> records;
+    size_t count = 0;
+    size_t capacity = 0;
+};
+
+// Class to manage all active visual effects. Each effect type has its own
+// pool, so updating and drawing are tight loops over one kind of record.
 class VisualEffectManager {
 public:
     VisualEffectManager();
     ~VisualEffectManager();
-    
+
     void addEffect(Character::VisualEffectType type, float startX, float startY, float endX, float endY);
     void update(float deltaTime);
-    std::vector<Vertex> generateAllEffectVertices() const;
-    const std::vector<std::shared_ptr<VisualEffect>>& getEffects() const { return activeEffects; }
+    FrameVector<Vertex> generateAllEffectVertices() const;
+    // Append onto an existing frame buffer, reusing its capacity
+    void appendAllEffectVertices(FrameVector<Vertex>& vertices) const;
+    size_t getEffectCount() const;
+    // Effects dropped because their pool was full
+    size_t getDroppedCount() const { return droppedCount; }
     void clear();
 
 private:
-    std::vector<std::shared_ptr<VisualEffect>> activeEffects;
+    // Constants
+    static constexpr size_t MAX_EFFECTS_PER_TYPE = 65536;
+    static constexpr int SLASH_VERTICES = 6;
+    static constexpr int ARROW_VERTICES = 12;
+    static constexpr int FIREBALL_SEGMENTS = 12;
+    static constexpr int FIREBALL_VERTICES = FIREBALL_SEGMENTS * 6;
+
+    // Indexed by VisualEffectType; NONE stays empty
+    static constexpr int POOL_COUNT = static_cast<int>(Character::VisualEffectType::FIREBALL) + 1;
+    EffectPool pools[POOL_COUNT];
+    size_t droppedCount = 0;
+
+    // Colors for different effect types
+    static const float SLASH_COLOR[3];
+    static const float ARROW_COLOR[3];
+    static const float FIREBALL_COLOR[3];
+
+    EffectPool& getPool(Character::VisualEffectType type) { return pools[static_cast<int>(type)]; }
+    const EffectPool& getPool(Character::VisualEffectType type) const { return pools[static_cast<int>(type)]; }
+
+    // Write the triangles of a whole pool; out must have room for every record
+    static Vertex* emitSlashVertices(const EffectPool& pool, Vertex* out);
+    static Vertex* emitArrowVertices(const EffectPool& pool, Vertex* out);
+    static Vertex* emitFireballVertices(const EffectPool& pool, Vertex* out);
 };
@@ -0,0 +1,307 @@
+#include "walkable_index.h"
+#include <cstdlib>
+#include <algorithm>
+
+WalkableIndex::WalkableIndex() : width(0), height(0), regionsDirty(false) {
+}
+
+WalkableIndex::~WalkableIndex() {
+}
+
+void WalkableIndex::reset(int newWidth, int newHeight) {
+    width = newWidth;
+    height = newHeight;
+    cells.clear();
+    cellSlot.assign(width * height, -1);
+    cellRegion.assign(width * height, -1);
+    regionSlot.assign(width * height, -1);
+    regionCells.clear();
+    regionsDirty = false;
+}
+
+bool WalkableIndex::contains(int x, int y) const {
+    if (x < 0 || x >= width || y < 0 || y >= height) {
+        return false;
+    }
+    return cellSlot[y * width + x] >= 0;
+}
+
+void WalkableIndex::addCell(int x, int y) {
+    if (x < 0 || x >= width || y < 0 || y >= height) return;
+
+    int cell = y * width + x;
+    if (cellSlot[cell] >= 0) return;
+
+    cellSlot[cell] = static_cast<int>(cells.size());
+    cells.push_back(cell);
+
+    // Labels are rebuilt wholesale on the next query anyway
+    if (regionsDirty) return;
+
+    // Join the region of a walkable neighbour, or start a new one
+    int region = -1;
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            if (dx == 0 && dy == 0) continue;
+            if (!contains(x + dx, y + dy)) continue;
+
+            int neighbourRegion = cellRegion[(y + dy) * width + (x + dx)];
+            if (region == -1) {
+                region = neighbourRegion;
+            } else if (neighbourRegion != region) {
+                // This cell bridges two regions
+                region = mergeRegions(region, neighbourRegion);
+            }
+        }
+    }
+
+    if (region == -1) {
+        region = static_cast<int>(regionCells.size());
+        regionCells.emplace_back();
+    }
+    addToRegion(cell, region);
+}
+
+void WalkableIndex::removeCell(int x, int y) {
+    if (x < 0 || x >= width || y < 0 || y >= height) return;
+
+    int cell = y * width + x;
+    int slot = cellSlot[cell];
+    if (slot < 0) return;
+
+    // Swap-and-pop from the dense list
+    int last = cells.back();
+    cells[slot] = last;
+    cellSlot[last] = slot;
+    cells.pop_back();
+    cellSlot[cell] = -1;
+
+    if (regionsDirty) {
+        cellRegion[cell] = -1;
+        return;
+    }
+    removeFromRegion(cell);
+
+    // A cell with at most one walkable neighbour cannot split its region
+    int neighbours = 0;
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            if ((dx != 0 || dy != 0) && contains(x + dx, y + dy)) {
+                neighbours++;
+            }
+        }
+    }
+    if (neighbours > 1) {
+        regionsDirty = true;
+    }
+}
+
+int WalkableIndex::getRegion(int x, int y) const {
+    if (!contains(x, y)) {
+        return -1;
+    }
+    ensureRegions();
+    return cellRegion[y * width + x];
+}
+
+int WalkableIndex::getRegionCount() const {
+    ensureRegions();
+    
+    // Merged-away regions leave empty buckets behind until the next relabel
+    int count = 0;
+    for (const auto& bucket : regionCells) {
+        if (!bucket.empty()) count++;
+    }
+    return count;
+}
+
+size_t WalkableIndex::getRegionCellCount(int region) const {
+    ensureRegions();
+    if (region < 0 || region >= static_cast<int>(regionCells.size())) {
+        return 0;
+    }
+    return regionCells[region].size();
+}
+
+int WalkableIndex::getLargestRegion() const {
+    ensureRegions();
+    int largest = -1;
+    size_t largestSize = 0;
+    for (size_t i = 0; i < regionCells.size(); i++) {
+        if (regionCells[i].size() > largestSize) {
+            largestSize = regionCells[i].size();
+            largest = static_cast<int>(i);
+        }
+    }
+    return largest;
+}
+
+bool WalkableIndex::sample(Random& rng, int region, int& outX, int& outY) const {
+    const std::vector<int>& bucket = getBucket(region);
+    if (bucket.empty()) {
+        return false;
+    }
+
+    int cell = bucket[rng.nextBelow(static_cast<uint32_t>(bucket.size()))];
+    outX = cell % width;
+    outY = cell / width;
+    return true;
+}
+
+bool WalkableIndex::sampleAwayFrom(Random& rng, int region, int fromX, int fromY, int minDistance,
+                                   int& outX, int& outY) const {
+    const std::vector<int>& bucket = getBucket(region);
+    if (bucket.empty()) {
+        return false;
+    }
+
+    auto farEnough = [&](int cell) {
+        int dx = std::abs(cell % width - fromX);
+        int dy = std::abs(cell / width - fromY);
+        return std::max(dx, dy) >= minDistance;
+    };
+
+    // Rejection sampling succeeds almost immediately unless the exclusion zone covers most of the bucket
+    uint32_t bucketSize = static_cast<uint32_t>(bucket.size());
+    for (int attempt = 0; attempt < MAX_SAMPLE_ATTEMPTS; attempt++) {
+        int cell = bucket[rng.nextBelow(bucketSize)];
+        if (farEnough(cell)) {
+            outX = cell % width;
+            outY = cell / width;
+            return true;
+        }
+    }
+
+    // Fall back to a single pass from a random starting point, which always terminates
+    size_t start = rng.nextBelow(bucketSize);
+    for (size_t i = 0; i < bucket.size(); i++) {
+        int cell = bucket[(start + i) % bucket.size()];
+        if (farEnough(cell)) {
+            outX = cell % width;
+            outY = cell / width;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+const std::vector<int>& WalkableIndex::getBucket(int region) const {
+    static const std::vector<int> empty;
+    if (region < 0) {
+        return cells;
+    }
+
+    ensureRegions();
+    if (region >= static_cast<int>(regionCells.size())) {
+        return empty;
+    }
+    return regionCells[region];
+}
+
+void WalkableIndex::ensureRegions() const {
+    if (regionsDirty) {
+        relabelRegions();
+        regionsDirty = false;
+    }
+}
+
+void WalkableIndex::relabelRegions() const {
+    // Two-pass connected-component labeling: a raster scan unions each cell with
+    // its already-visited neighbours, then every cell is bucketed by its root.
+    const int cellCount = width * height;
+    std::vector<int> parent(cellCount, -1);
+
+    auto find = [&parent](int cell) {
+        int root = cell;
+        while (parent[root] != root) {
+            root = parent[root];
+        }
+        // Path compression
+        while (parent[cell] != root) {
+            int next = parent[cell];
+            parent[cell] = root;
+            cell = next;
+        }
+        return root;
+    };
+
+    auto unite = [&](int a, int b) {
+        int rootA = find(a);
+        int rootB = find(b);
+        if (rootA == rootB) return;
+        // The smaller index becomes the root so labels follow scan order
+        if (rootA < rootB) {
+            parent[rootB] = rootA;
+        } else {
+            parent[rootA] = rootB;
+        }
+    };
+
+    // First pass: the west, north-west, north and north-east neighbours are already labelled
+    const int previous[4][2] = {{-1, 0}, {-1, -1}, {0, -1}, {1, -1}};
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int cell = y * width + x;
+            if (cellSlot[cell] < 0) continue;
+
+            parent[cell] = cell;
+            for (const auto& offset : previous) {
+                if (contains(x + offset[0], y + offset[1])) {
+                    unite(cell, (y + offset[1]) * width + (x + offset[0]));
+                }
+            }
+        }
+    }
+
+    // Second pass: assign compact region ids in scan order and fill the buckets
+    std::fill(cellRegion.begin(), cellRegion.end(), -1);
+    regionCells.clear();
+    std::vector<int> rootRegion(cellCount, -1);
+    for (int cell = 0; cell < cellCount; cell++) {
+        if (cellSlot[cell] < 0) continue;
+
+        int root = find(cell);
+        if (rootRegion[root] == -1) {
+            rootRegion[root] = static_cast<int>(regionCells.size());
+            regionCells.emplace_back();
+        }
+        addToRegion(cell, rootRegion[root]);
+    }
+}
+
+int WalkableIndex::mergeRegions(int a, int b) const {
+    // Move the smaller bucket into the larger one; each cell moves O(log n) times at most
+    if (regionCells[a].size() < regionCells[b].size()) {
+        std::swap(a, b);
+    }
+
+    std::vector<int>& source = regionCells[b];
+    for (int cell : source) {
+        addToRegion(cell, a);
+    }
+    source.clear();
+    source.shrink_to_fit();
+    return a;
+}
+
+void WalkableIndex::addToRegion(int cell, int region) const {
+    cellRegion[cell] = region;
+    regionSlot[cell] = static_cast<int>(regionCells[region].size());
+    regionCells[region].push_back(cell);
+}
+
+void WalkableIndex::removeFromRegion(int cell) const {
+    int region = cellRegion[cell];
+    if (region < 0) return;
+
+    std::vector<int>& bucket = regionCells[region];
+    int slot = regionSlot[cell];
+    int last = bucket.back();
+    bucket[slot] = last;
+    regionSlot[last] = slot;
+    bucket.pop_back();
+
+    cellRegion[cell] = -1;
+    regionSlot[cell] = -1;
+}
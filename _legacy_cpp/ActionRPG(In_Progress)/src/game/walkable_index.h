@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+#include "random.h"
+
+// Index of walkable cells, bucketed by 8-connected region.
+// Cells are added and removed in O(1) as tiles change. A cell that bridges
+// regions merges their buckets smaller-into-larger, so carving corridors keeps
+// labels exact. Removing a cell that might split its region marks the labels
+// stale; they are rebuilt with a two-pass union-find labeling on the next query.
+class WalkableIndex {
+public:
+    WalkableIndex();
+    ~WalkableIndex();
+
+    // Start over with a grid that has no walkable cells
+    void reset(int width, int height);
+
+    // Incremental maintenance (called by Level::setTile)
+    void addCell(int x, int y);
+    void removeCell(int x, int y);
+
+    // Queries
+    bool contains(int x, int y) const;
+    size_t getCellCount() const { return cells.size(); }
+    int getRegion(int x, int y) const;
+    int getRegionCount() const;
+    size_t getRegionCellCount(int region) const;
+    int getLargestRegion() const;
+
+    // Uniform random walkable cell; region -1 samples the whole level
+    bool sample(Random& rng, int region, int& outX, int& outY) const;
+
+    // Uniform random walkable cell at least minDistance tiles (Chebyshev) away from (fromX, fromY)
+    bool sampleAwayFrom(Random& rng, int region, int fromX, int fromY, int minDistance,
+                        int& outX, int& outY) const;
+
+private:
+    int width;
+    int height;
+
+    // Dense list of all walkable cells and each cell's slot in it (-1 if not walkable)
+    std::vector<int> cells;
+    std::vector<int> cellSlot;
+
+    // Region buckets; labels are kept consistent lazily
+    mutable std::vector<int> cellRegion;
+    mutable std::vector<int> regionSlot;
+    mutable std::vector<std::vector<int>> regionCells;
+    mutable bool regionsDirty;
+
+    void ensureRegions() const;
+    void relabelRegions() const;
+    void addToRegion(int cell, int region) const;
+    void removeFromRegion(int cell) const;
+    int mergeRegions(int a, int b) const;
+    const std::vector<int>& getBucket(int region) const;
+
+    // Constants
+    static constexpr int MAX_SAMPLE_ATTEMPTS = 32;
+};
@@ -1,13 +1,75 @@
 #include "engine/vulkan_renderer.h"
 #include "engine/game_loop.h"
+#include "engine/allocation_tracker.h"
+#include "engine/logger.h"
+#include "engine/benchmarks.h"
 #include <iostream>
 #include <filesystem>
+#include <cstring>
 #include <string>
 
-int main() {
+int main(int argc, char* argv[]) {
     try {
         // Print the current working directory
-        std::cout << "Current working directory: " << std::filesystem::current_path().string() << std::endl;
+        LOG_INFO(ENGINE, "Current working directory: {}", std::filesystem::current_path().string());
+
+        // --record <file>: save the first game to a replay file
+        // --replay <file>: play a replay file in the window, in real time
+        // --headless: with --replay, play it without a window as fast as possible (for profiling)
+        // --allocation-test: abort on the first frame where rendering or UI allocates from the heap
+        // --level-cache <dir>: save generated floors in dir and load them again for the same seed
+        // --bench-paths: print path search throughput on generated dungeons and exit
+        // --bench-timers: print the per-frame cost of enemy timers, wheel against polling, and exit
+        // --bench-flow-field: print the per-frame cost of chasing enemies, flow field against greedy steps, and exit
+        std::string recordPath;
+        std::string replayPath;
+        std::string levelCachePath;
+        bool headless = false;
+        int (*benchmark)() = nullptr;
+        for (int i = 1; i < argc; i++) {
+            if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+                recordPath = argv[++i];
+            } else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+                replayPath = argv[++i];
+            } else if (std::strcmp(argv[i], "--level-cache") == 0 && i + 1 < argc) {
+                levelCachePath = argv[++i];
+            } else if (std::strcmp(argv[i], "--bench-paths") == 0) {
+                benchmark = &Benchmarks::runPaths;
+            } else if (std::strcmp(argv[i], "--bench-timers") == 0) {
+                benchmark = &Benchmarks::runTimers;
+            } else if (std::strcmp(argv[i], "--bench-flow-field") == 0) {
+                benchmark = &Benchmarks::runFlowField;
+            } else if (std::strcmp(argv[i], "--headless") == 0) {
+                headless = true;
+            } else if (std::strcmp(argv[i], "--allocation-test") == 0) {
+                if (!AllocationTracker::ENABLED) {
+                    std::cerr << "--allocation-test needs a build configured with -DTRACK_ALLOCATIONS=ON" << std::endl;
+                    return -1;
+                }
+                AllocationTracker& tracker = AllocationTracker::get();
+                tracker.setBudget(AllocationTag::RENDER, 0, 0);
+                tracker.setBudget(AllocationTag::UI, 0, 0);
+                tracker.setStrict(true);
+            }
+        }
+
+        if (benchmark) {
+            return benchmark();
+        }
+
+        if (headless) {
+            if (replayPath.empty()) {
+                std::cerr << "--headless needs --replay <file>" << std::endl;
+                return -1;
+            }
+            GameLoop gameLoop(nullptr);
+            gameLoop.setLevelCacheDirectory(levelCachePath);
+            if (!gameLoop.loadReplay(replayPath)) {
+                return -1;
+            }
+            // A diverged replay fails, so build boxes can catch determinism regressions
+            return gameLoop.runHeadlessReplay() ? 0 : 1;
+        }
 
         // Initialize the renderer
         VulkanRenderer renderer;
@@ -18,6 +80,14 @@ int main() {
 
         // Initialize game loop
         GameLoop gameLoop(&renderer);
+        gameLoop.setLevelCacheDirectory(levelCachePath);
+        if (!replayPath.empty()) {
+            if (!gameLoop.loadReplay(replayPath)) {
+                return -1;
+            }
+        } else if (!recordPath.empty()) {
+            gameLoop.setRecordPath(recordPath);
+        }
         
         // Run the game loop (which will create the surface first)
         gameLoop.run();
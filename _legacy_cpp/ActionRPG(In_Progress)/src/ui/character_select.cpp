@@ -1,5 +1,5 @@
 #include "character_select.h"
-#include <iostream>
+#include "../engine/logger.h"
 #include <cmath>
 #include <GLFW/glfw3.h>
 
@@ -18,8 +18,8 @@ void CharacterSelectScreen::update(float deltaTime) {
     }
 }
 
-std::vector<Vertex> CharacterSelectScreen::generateVertices(UISystem* uiSystem) const {
-    std::vector<Vertex> vertices;
+FrameVector<Vertex> CharacterSelectScreen::generateVertices(UISystem* uiSystem) const {
+    FrameVector<Vertex> vertices(&FrameArena::get());
     
     // Combine all UI elements
     auto background = createBackground();
@@ -52,7 +52,7 @@ bool CharacterSelectScreen::handleInput(int key) {
     // Enter/Space to confirm selection
     else if (key == GLFW_KEY_ENTER || key == GLFW_KEY_SPACE) {
         selectionConfirmed = true;
-        std::cout << "Selected character class: " << classNames[selectedIndex] << std::endl;
+        LOG_INFO(UI, "Selected character class: {}", classNames[selectedIndex]);
         return true;
     }
     
@@ -63,8 +63,8 @@ CharacterClass CharacterSelectScreen::getSelectedClass() const {
     return characterClasses[selectedIndex];
 }
 
-std::vector<Vertex> CharacterSelectScreen::createBackground() const {
-    std::vector<Vertex> vertices;
+FrameVector<Vertex> CharacterSelectScreen::createBackground() const {
+    FrameVector<Vertex> vertices(&FrameArena::get());
     
     // Semi-transparent dark background
     float x = -SCREEN_WIDTH / 2.0f;
@@ -94,7 +94,7 @@ std::vector<Vertex> CharacterSelectScreen::createBackground() const {
     return vertices;
 }
 
-std::vector<Vertex> CharacterSelectScreen::createTitle() const {
+FrameVector<Vertex> CharacterSelectScreen::createTitle() const {
     // Create the title text using the UI System
     if (!uiSystem) return {}; // Return empty if uiSystem is not initialized
     return uiSystem->createStatusText(
@@ -103,8 +103,8 @@ std::vector<Vertex> CharacterSelectScreen::createTitle() const {
     );
 }
 
-std::vector<Vertex> CharacterSelectScreen::createCharacterOptions() const {
-    std::vector<Vertex> vertices;
+FrameVector<Vertex> CharacterSelectScreen::createCharacterOptions() const {
+    FrameVector<Vertex> vertices(&FrameArena::get());
     
     if (!uiSystem) return vertices; // Return empty if uiSystem is not initialized
     
@@ -159,8 +159,8 @@ std::vector<Vertex> CharacterSelectScreen::createCharacterOptions() const {
     return vertices;
 }
 
-std::vector<Vertex> CharacterSelectScreen::createSelectionHighlight() const {
-    std::vector<Vertex> vertices;
+FrameVector<Vertex> CharacterSelectScreen::createSelectionHighlight() const {
+    FrameVector<Vertex> vertices(&FrameArena::get());
     
     // Calculate position of the selected character option
     float startX = -((NUM_CLASSES * OPTION_WIDTH) + ((NUM_CLASSES - 1) * OPTION_SPACING)) / 2.0f;
@@ -218,8 +218,8 @@ std::vector<Vertex> CharacterSelectScreen::createSelectionHighlight() const {
     return vertices;
 }
 
-std::vector<Vertex> CharacterSelectScreen::createCharacterDetails() const {
-    std::vector<Vertex> vertices;
+FrameVector<Vertex> CharacterSelectScreen::createCharacterDetails() const {
+    FrameVector<Vertex> vertices(&FrameArena::get());
     
     if (!uiSystem) return vertices; // Return empty if uiSystem is not initialized
 
@@ -261,7 +261,7 @@ std::vector<Vertex> CharacterSelectScreen::createCharacterDetails() const {
     return vertices;
 }
 
-std::vector<Vertex> CharacterSelectScreen::createInstructions() const {
+FrameVector<Vertex> CharacterSelectScreen::createInstructions() const {
     // Create the instructions text using the UI System
      if (!uiSystem) return {}; // Return empty if uiSystem is not initialized
     return uiSystem->createStatusText(
@@ -4,6 +4,7 @@
 #include <memory>
 #include <string>
 #include "../engine/vertex.h"
+#include "../engine/frame_arena.h"
 #include "../game/character.h"
 #include <iostream>
 #include <cmath>
@@ -21,7 +22,7 @@ public:
     void update(float deltaTime);
     
     // Generate vertices for rendering the character selection screen
-    std::vector<Vertex> generateVertices(UISystem* uiSystem) const;
+    FrameVector<Vertex> generateVertices(UISystem* uiSystem) const;
     
     // Handle input for character selection
     bool handleInput(int key);
@@ -68,13 +69,13 @@ private:
     static constexpr float OPTION_SPACING = 0.1f;
     
     // Helper methods for rendering
-    std::vector<Vertex> createBackground() const;
-    std::vector<Vertex> createTitle() const;
-    std::vector<Vertex> createCharacterOptions() const;
-    std::vector<Vertex> createSelectionHighlight() const;
-    std::vector<Vertex> createCharacterDetails() const;
-    std::vector<Vertex> createInstructions() const;
+    FrameVector<Vertex> createBackground() const;
+    FrameVector<Vertex> createTitle() const;
+    FrameVector<Vertex> createCharacterOptions() const;
+    FrameVector<Vertex> createSelectionHighlight() const;
+    FrameVector<Vertex> createCharacterDetails() const;
+    FrameVector<Vertex> createInstructions() const;
     
     // Helper method to create text vertices (simplified for this implementation)
-    std::vector<Vertex> createTextPlaceholder(float x, float y, float width, float height, float r, float g, float b) const;
+    FrameVector<Vertex> createTextPlaceholder(float x, float y, float width, float height, float r, float g, float b) const;
 };
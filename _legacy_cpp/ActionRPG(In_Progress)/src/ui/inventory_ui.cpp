@@ -1,5 +1,5 @@
 #include "inventory_ui.h"
-#include <iostream>
+#include "../engine/logger.h"
 #include <cmath>
 #include <GLFW/glfw3.h>
 
@@ -18,8 +18,8 @@ void InventoryUI::update(float deltaTime) {
     }
 }
 
-std::vector<Vertex> InventoryUI::generateInventoryVertices(const std::shared_ptr<Character>& player) const {
-    std::vector<Vertex> vertices;
+FrameVector<Vertex> InventoryUI::generateInventoryVertices(const std::shared_ptr<Character>& player) const {
+    FrameVector<Vertex> vertices(&FrameArena::get());
     
     // Only generate vertices if the inventory is visible
     if (!isVisible) {
@@ -36,7 +36,7 @@ std::vector<Vertex> InventoryUI::generateInventoryVertices(const std::shared_ptr
     auto highlight = createSelectionHighlight();
     
     // If an item is selected, show its details
-    std::vector<Vertex> details;
+    FrameVector<Vertex> details(&FrameArena::get());
     if (!inventory.empty() && selectedItemIndex >= 0 && selectedItemIndex < static_cast<int>(inventory.size())) {
         details = createItemDetails(inventory[selectedItemIndex]);
     }
@@ -114,26 +114,32 @@ void InventoryUI::useSelectedItem(const std::shared_ptr<Character>& player) {
         return;
     }
     
-    // Use the selected item
-    auto item = inventory[selectedItemIndex];
-    std::cout << "Using item: " << item->getName() << std::endl;
+    // Use the selected item through its polymorphic view
+    auto item = inventory[selectedItemIndex].toItem();
+    LOG_DEBUG(UI, "Using item: {}", item->getName());
     
     // Different behavior based on item type
-    if (auto potion = std::dynamic_pointer_cast<Potion>(item)) {
-        // Use potion to heal
-        player->heal(potion->getHealAmount());
-        player->removeItem(selectedItemIndex);
-        
-        // Adjust selected index if needed
-        if (selectedItemIndex >= static_cast<int>(player->getInventory().size())) {
-            selectedItemIndex = std::max(0, static_cast<int>(player->getInventory().size()) - 1);
-        }
-    } else if (auto weapon = std::dynamic_pointer_cast<Weapon>(item)) {
-        // Equip weapon
-        player->equipWeapon(weapon);
-    } else if (auto armor = std::dynamic_pointer_cast<Armor>(item)) {
-        // Equip armor
-        player->equipArmor(armor);
+    switch (inventory.getType(static_cast<Inventory::Slot>(selectedItemIndex))) {
+        case ItemType::POTION:
+            // Use potion to heal
+            player->heal(std::static_pointer_cast<Potion>(item)->getHealAmount());
+            player->consumeItem(selectedItemIndex);
+            
+            // Adjust selected index if needed
+            if (selectedItemIndex >= static_cast<int>(player->getInventory().size())) {
+                selectedItemIndex = std::max(0, static_cast<int>(player->getInventory().size()) - 1);
+            }
+            break;
+        case ItemType::WEAPON:
+            // Equip weapon
+            player->equipWeapon(std::static_pointer_cast<Weapon>(item));
+            break;
+        case ItemType::ARMOR:
+            // Equip armor
+            player->equipArmor(std::static_pointer_cast<Armor>(item));
+            break;
+        default:
+            break;
     }
 }
 
@@ -144,8 +150,8 @@ void InventoryUI::dropSelectedItem(const std::shared_ptr<Character>& player) {
     }
     
     // Drop the selected item
-    auto item = inventory[selectedItemIndex];
-    std::cout << "Dropping item: " << item->getName() << std::endl;
+    const ItemInstance& item = inventory[selectedItemIndex];
+    LOG_DEBUG(UI, "Dropping item: {}", item.getName());
     
     // TODO: Create an item drop at the player's location
     
@@ -158,8 +164,8 @@ void InventoryUI::dropSelectedItem(const std::shared_ptr<Character>& player) {
     }
 }
 
-std::vector<Vertex> InventoryUI::createInventoryBackground() const {
-    std::vector<Vertex> vertices;
+FrameVector<Vertex> InventoryUI::createInventoryBackground() const {
+    FrameVector<Vertex> vertices(&FrameArena::get());
     
     // Create a semi-transparent dark background
     float x = INVENTORY_X - INVENTORY_WIDTH / 2.0f;
@@ -243,8 +249,8 @@ std::vector<Vertex> InventoryUI::createInventoryBackground() const {
     return vertices;
 }
 
-std::vector<Vertex> InventoryUI::createItemSlots() const {
-    std::vector<Vertex> vertices;
+FrameVector<Vertex> InventoryUI::createItemSlots() const {
+    FrameVector<Vertex> vertices(&FrameArena::get());
     
     // Calculate starting position for the grid
     float startX = INVENTORY_X - ((INVENTORY_COLS * ITEM_SLOT_SIZE) + ((INVENTORY_COLS - 1) * ITEM_SLOT_PADDING)) / 2.0f;
@@ -280,8 +286,8 @@ std::vector<Vertex> InventoryUI::createItemSlots() const {
     return vertices;
 }
 
-std::vector<Vertex> InventoryUI::createItemIcons(const std::vector<std::shared_ptr<Item>>& items) const {
-    std::vector<Vertex> vertices;
+FrameVector<Vertex> InventoryUI::createItemIcons(const Inventory& items) const {
+    FrameVector<Vertex> vertices(&FrameArena::get());
     
     // Calculate starting position for the grid
     float startX = INVENTORY_X - ((INVENTORY_COLS * ITEM_SLOT_SIZE) + ((INVENTORY_COLS - 1) * ITEM_SLOT_PADDING)) / 2.0f;
@@ -298,10 +304,11 @@ std::vector<Vertex> InventoryUI::createItemIcons(const std::vector<std::shared_p
         
         // Get item color based on rarity
         float r, g, b;
-        getItemColor(items[i]->getRarity(), r, g, b);
+        getItemColor(items[i].getRarity(), r, g, b);
         
         // Create icon shape based on item type
-        if (std::dynamic_pointer_cast<Weapon>(items[i])) {
+        ItemType type = items.getType(static_cast<Inventory::Slot>(i));
+        if (type == ItemType::WEAPON) {
             // Weapon icon (sword shape)
             Vertex v1 = {{x + size/2, y}, {r, g, b}};
             Vertex v2 = {{x + size, y + size/2}, {r, g, b}};
@@ -316,7 +323,7 @@ std::vector<Vertex> InventoryUI::createItemIcons(const std::vector<std::shared_p
             vertices.push_back(v4);
             vertices.push_back(v1);
         }
-        else if (std::dynamic_pointer_cast<Armor>(items[i])) {
+        else if (type == ItemType::ARMOR) {
             // Armor icon (shield shape)
             Vertex v1 = {{x + size/2, y}, {r, g, b}};
             Vertex v2 = {{x + size, y + size/4}, {r, g, b}};
@@ -341,7 +348,7 @@ std::vector<Vertex> InventoryUI::createItemIcons(const std::vector<std::shared_p
             vertices.push_back(v5);
             vertices.push_back(v6);
         }
-        else if (std::dynamic_pointer_cast<Potion>(items[i])) {
+        else if (type == ItemType::POTION) {
             // Potion icon (circle shape)
             const int segments = 12;
             float centerX = x + size/2;
@@ -381,10 +388,10 @@ std::vector<Vertex> InventoryUI::createItemIcons(const std::vector<std::shared_p
     return vertices;
 }
 
-std::vector<Vertex> InventoryUI::createSelectionHighlight() const {
-    std::vector<Vertex> vertices;
+FrameVector<Vertex> InventoryUI::createSelectionHighlight() const {
+    FrameVector<Vertex> vertices(&FrameArena::get());
     
-    const auto& inventory = std::vector<std::shared_ptr<Item>>(); // Placeholder, we'll get this from the player
+    const auto& inventory = std::vector<ItemInstance>(); // Placeholder, we'll get this from the player
     if (inventory.empty() || selectedItemIndex < 0 || selectedItemIndex >= static_cast<int>(inventory.size())) {
         return vertices;
     }
@@ -447,8 +454,8 @@ std::vector<Vertex> InventoryUI::createSelectionHighlight() const {
     return vertices;
 }
 
-std::vector<Vertex> InventoryUI::createItemDetails(const std::shared_ptr<Item>& item) const {
-    std::vector<Vertex> vertices;
+FrameVector<Vertex> InventoryUI::createItemDetails(const ItemInstance& item) const {
+    FrameVector<Vertex> vertices(&FrameArena::get());
     
     // Create a box for item details
     float x = INVENTORY_X - INVENTORY_WIDTH / 2.0f + 0.05f;
@@ -482,7 +489,7 @@ std::vector<Vertex> InventoryUI::createItemDetails(const std::shared_ptr<Item>&
     float nameHeight = 0.04f;
     
     float nameR, nameG, nameB;
-    getItemColor(item->getRarity(), nameR, nameG, nameB);
+    getItemColor(item.getRarity(), nameR, nameG, nameB);
     
     Vertex n1 = {{nameX, nameY}, {nameR, nameG, nameB}};
     Vertex n2 = {{nameX + nameWidth, nameY}, {nameR, nameG, nameB}};
@@ -4,8 +4,9 @@
 #include <memory>
 #include <string>
 #include "../engine/vertex.h"
+#include "../engine/frame_arena.h"
 #include "../game/character.h"
-#include "../game/item.h"
+#include "../game/item_database.h"
 
 // Class to handle the inventory UI display and interaction
 class InventoryUI {
@@ -21,7 +22,7 @@ public:
     void update(float deltaTime);
     
     // Generate vertices for rendering the inventory UI
-    std::vector<Vertex> generateInventoryVertices(const std::shared_ptr<Character>& player) const;
+    FrameVector<Vertex> generateInventoryVertices(const std::shared_ptr<Character>& player) const;
     
     // Handle input for inventory navigation and item usage
     bool handleInput(int key, const std::shared_ptr<Character>& player);
@@ -51,11 +52,11 @@ private:
     static constexpr int INVENTORY_ROWS = 4;
     
     // Helper methods for rendering
-    std::vector<Vertex> createInventoryBackground() const;
-    std::vector<Vertex> createItemSlots() const;
-    std::vector<Vertex> createItemIcons(const std::vector<std::shared_ptr<Item>>& items) const;
-    std::vector<Vertex> createSelectionHighlight() const;
-    std::vector<Vertex> createItemDetails(const std::shared_ptr<Item>& item) const;
+    FrameVector<Vertex> createInventoryBackground() const;
+    FrameVector<Vertex> createItemSlots() const;
+    FrameVector<Vertex> createItemIcons(const Inventory& items) const;
+    FrameVector<Vertex> createSelectionHighlight() const;
+    FrameVector<Vertex> createItemDetails(const ItemInstance& item) const;
     
     // Helper method to get item color based on rarity
     void getItemColor(ItemRarity rarity, float& r, float& g, float& b) const;
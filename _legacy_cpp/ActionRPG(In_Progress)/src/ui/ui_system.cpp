@@ -37,7 +37,7 @@
 UISystem::~UISystem() {
 }
 
-std::vector<Vertex> UISystem::generateHealthBarVertices(const std::shared_ptr<Character>& character, float xOffset, float yOffset) {
+FrameVector<Vertex> UISystem::generateHealthBarVertices(const std::shared_ptr<Character>& character, float xOffset, float yOffset) {
     if (!character) {
         return {};
     }
@@ -49,8 +49,8 @@ std::vector<Vertex> UISystem::generateHealthBarVertices(const std::shared_ptr<Ch
     return createHealthBar(xOffset, yOffset, HEALTH_BAR_WIDTH, HEALTH_BAR_HEIGHT, healthPercent);
 }
 
-std::vector<Vertex> UISystem::generateEnemyHealthBars(const std::vector<std::shared_ptr<Enemy>>& enemies, float cameraX, float cameraY) {
-    std::vector<Vertex> vertices;
+FrameVector<Vertex> UISystem::generateEnemyHealthBars(const FrameVector<Enemy*>& enemies, float cameraX, float cameraY) {
+    FrameVector<Vertex> vertices(&FrameArena::get());
     
     // Only show health bars for enemies within view distance
     const float VIEW_DISTANCE = 15.0f;
@@ -81,8 +81,8 @@ std::vector<Vertex> UISystem::generateEnemyHealthBars(const std::vector<std::sha
     return vertices;
 }
 
-std::vector<Vertex> UISystem::generatePlayerStatusBar(const std::shared_ptr<Character>& player) {
-    std::vector<Vertex> vertices;
+FrameVector<Vertex> UISystem::generatePlayerStatusBar(const std::shared_ptr<Character>& player) {
+    FrameVector<Vertex> vertices(&FrameArena::get());
     
     if (!player) {
         return vertices;
@@ -107,8 +107,8 @@ std::vector<Vertex> UISystem::generatePlayerStatusBar(const std::shared_ptr<Char
     return vertices;
 }
 
-std::vector<Vertex> UISystem::createHealthBar(float x, float y, float width, float height, float healthPercent) {
-    std::vector<Vertex> vertices;
+FrameVector<Vertex> UISystem::createHealthBar(float x, float y, float width, float height, float healthPercent) {
+    FrameVector<Vertex> vertices(&FrameArena::get());
     
     // Clamp health percentage between 0 and 1
     healthPercent = std::max(0.0f, std::min(1.0f, healthPercent));
@@ -185,8 +185,8 @@ std::vector<Vertex> UISystem::createHealthBar(float x, float y, float width, flo
     return vertices;
 }
 
-std::vector<Vertex> UISystem::generateUIVertices(const std::shared_ptr<Character>& player) {
-    std::vector<Vertex> uiVertices;
+FrameVector<Vertex> UISystem::generateUIVertices(const std::shared_ptr<Character>& player) {
+    FrameVector<Vertex> uiVertices(&FrameArena::get());
 
     // Generate player status bar vertices
     auto playerStatusBarVertices = generatePlayerStatusBar(player);
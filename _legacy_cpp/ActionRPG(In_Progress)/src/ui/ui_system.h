@@ -3,6 +3,7 @@
 #include "../game/character.h"
 #include "../game/enemy.h"
 #include "../engine/vertex.h"
+#include "../engine/frame_arena.h"
 #include <memory>
 #include <vector>
 #include <string>
@@ -16,14 +17,14 @@ public:
     ~UISystem();
     
     // Generate vertices for UI elements
-    std::vector<Vertex> generateHealthBarVertices(const std::shared_ptr<Character>& character, float xOffset, float yOffset);
-    std::vector<Vertex> generateEnemyHealthBars(const std::vector<std::shared_ptr<Enemy>>& enemies, float cameraX, float cameraY);
-    std::vector<Vertex> generatePlayerStatusBar(const std::shared_ptr<Character>& player);
-    std::vector<Vertex> generateUIVertices(const std::shared_ptr<Character>& player);
+    FrameVector<Vertex> generateHealthBarVertices(const std::shared_ptr<Character>& character, float xOffset, float yOffset);
+    FrameVector<Vertex> generateEnemyHealthBars(const FrameVector<Enemy*>& enemies, float cameraX, float cameraY);
+    FrameVector<Vertex> generatePlayerStatusBar(const std::shared_ptr<Character>& player);
+    FrameVector<Vertex> generateUIVertices(const std::shared_ptr<Character>& player);
     
     // Helper methods
-    std::vector<Vertex> createHealthBar(float x, float y, float width, float height, float healthPercent);
-    std::vector<Vertex> createStatusText(float x, float y, const std::string& text);
+    FrameVector<Vertex> createHealthBar(float x, float y, float width, float height, float healthPercent);
+    FrameVector<Vertex> createStatusText(float x, float y, const std::string& text);
     
 private:
     // Constants for UI layout